@@ -243,6 +243,101 @@ double RunAlgorithm(int algorithm, Matrix<Scalar>& A, Matrix<Scalar>& B,
 }
 
 
+// Shape of one step of the algorithm (the same one that RunAlgorithm uses),
+// for the memory manager.
+LevelShape AlgorithmShape(int algorithm) {
+  switch (algorithm) {
+  case BINI322_10_52_APPROX:
+    return bini322_10_52_approx::Shape();
+  case SCHONHAGE333_21_117_APPROX:
+    return schonhage333_21_117_approx::Shape();
+  case CLASSICAL222:
+    return classical222_8_24::Shape();
+  case CLASSICAL423:
+    return classical423_24_72::Shape();
+  case CLASSICAL333:
+    return classical333_27_81::Shape();
+  case FAST322_11_50:
+    return grey322_11_50::Shape();
+  case FAST332_15_103:
+    return grey332_15_103::Shape();
+  case FAST323_15_103:
+    return grey323_15_103::Shape();
+  case FAST323_15_89:
+    return grey323_15_103::Shape();
+  case FAST333_23_125:
+    return grey333_23_125::Shape();
+  case FAST333_23_152:
+    return grey333_23_152::Shape();
+  case FAST333_23_221:
+    return grey333_23_221::Shape();
+  case FAST432_20_144:
+    return grey432_20_144::Shape();
+  case FAST423_20_144:
+    return grey423_20_144::Shape();
+  case FAST324_20_144:
+    return grey324_20_144::Shape();
+  case FAST342_20_144:
+    return grey342_20_144::Shape();
+  case FAST234_20_144:
+    return grey234_20_144::Shape();
+  case FAST243_20_144:
+    return grey243_20_144::Shape();
+  case FAST433_29_234:
+    return grey433_29_234::Shape();
+  case FAST343_29_234:
+    return grey343_29_234::Shape();
+  case SMIRNOV333_23_128:
+    return smirnov333_23_128::Shape();
+  case SMIRNOV333_23_139:
+    return smirnov333_23_139::Shape();
+  case SMIRNOV336_40_960:
+    return smirnov336_40_960::Shape();
+  case SMIRNOV363_40_960:
+    return smirnov363_40_960::Shape();
+  case SMIRNOV633_40_960:
+    return smirnov633_40_960::Shape();
+  case HK332_15_94:
+    return hk332_15_94::Shape();
+  case HK323_15_94:
+    return hk323_15_94::Shape();
+  case HK323_15_84:
+    return hk323_15_84::Shape();
+  case STRASSEN:
+    return strassen::Shape();
+  case FAST422_14_84:
+    return grey422_14_84::Shape();
+  case FAST424_26_257:
+    return grey424_26_257::Shape();
+  case FAST442_26_257:
+    return grey442_26_257::Shape();
+  case FAST424_26_206:
+    return grey424_26_206::Shape();
+  case FAST522_18_99:
+    return grey522_18_99::Shape();
+  case FAST252_18_99:
+    return grey252_18_99::Shape();
+  default:
+    throw std::logic_error("Unknown algorithm type!");
+  }
+}
+
+
+// Number of bytes of temporaries that RunAlgorithm allocates to multiply an
+// m x k matrix with a k x n matrix with num_steps of recursion.  mode is the
+// parallel mode (see EstimateWorkspace in MemoryManager.hpp), and
+// num_threads only matters for HYBRID.  Nothing is allocated.
+template <typename Scalar>
+long EstimateWorkspace(int algorithm, int m, int k, int n, int num_steps, int mode,
+                       int num_threads=1) {
+  if (algorithm == MKL || num_steps == 0) {
+    return 0;
+  }
+  return EstimateWorkspace<Scalar>(std::vector<LevelShape>(num_steps, AlgorithmShape(algorithm)),
+                                   m, k, n, mode, num_threads);
+}
+
+
 // Convert the algorithm to a string representation.  Useful for debugging, dumping data, etc.
 std::string Alg2Str(int algorithm) {
   switch (algorithm) {
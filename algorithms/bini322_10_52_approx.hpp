@@ -8,536 +8,210 @@ namespace bini322_10_52_approx {
 
 template <typename Scalar>
 void S_Add1(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add2(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add3(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add4(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(x) * dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(x), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add5(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + Scalar(x) * dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(x)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add6(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add7(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add8(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add9(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(x) * dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(x), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add10(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + Scalar(x) * dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(x)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add1(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(x) * dataT1[i + j * strideT1] + dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(x), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add2(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] -dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add3(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add4(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-(x)) * dataT1[i + j * strideT1] + dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(-(x)), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add5(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(x) * dataT1[i + j * strideT1] + dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(x), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add6(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + Scalar(x) * dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(x)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add7(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add8(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] -dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add9(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + Scalar(x) * dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(x)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add10(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + Scalar(-(x)) * dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(-(x))};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void M_Add1(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(1.0 / (x)) * dataM1[i + j * strideM1] + Scalar(1.0 / (x)) * dataM2[i + j * strideM2] + Scalar(-(1.0 / (x))) * dataM3[i + j * strideM3] + Scalar(1.0 / (x)) * dataM4[i + j * strideM4] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(1.0 / (x)) * dataM1[i + j * strideM1] + Scalar(1.0 / (x)) * dataM2[i + j * strideM2] + Scalar(-(1.0 / (x))) * dataM3[i + j * strideM3] + Scalar(1.0 / (x)) * dataM4[i + j * strideM4];
-            }
-        }
-    }
+    const Scalar *data[4] = {M1.data(), M2.data(), M3.data(), M4.data()};
+    const int strides[4] = {M1.stride(), M2.stride(), M3.stride(), M4.stride()};
+    const Scalar coeffs[4] = {Scalar(1.0 / (x)), Scalar(1.0 / (x)), Scalar(-(1.0 / (x))), Scalar(1.0 / (x))};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add2(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-(1.0 / (x))) * dataM1[i + j * strideM1] + Scalar(1.0 / (x)) * dataM2[i + j * strideM2] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-(1.0 / (x))) * dataM1[i + j * strideM1] + Scalar(1.0 / (x)) * dataM2[i + j * strideM2];
-            }
-        }
-    }
+    const Scalar *data[2] = {M1.data(), M2.data()};
+    const int strides[2] = {M1.stride(), M2.stride()};
+    const Scalar coeffs[2] = {Scalar(-(1.0 / (x))), Scalar(1.0 / (x))};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add3(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] -dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] -dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(-1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add4(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] -dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] -dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(-1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add5(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-(1.0 / (x))) * dataM1[i + j * strideM1] + Scalar(1.0 / (x)) * dataM2[i + j * strideM2] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-(1.0 / (x))) * dataM1[i + j * strideM1] + Scalar(1.0 / (x)) * dataM2[i + j * strideM2];
-            }
-        }
-    }
+    const Scalar *data[2] = {M1.data(), M2.data()};
+    const int strides[2] = {M1.stride(), M2.stride()};
+    const Scalar coeffs[2] = {Scalar(-(1.0 / (x))), Scalar(1.0 / (x))};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add6(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(1.0 / (x)) * dataM1[i + j * strideM1] + Scalar(-(1.0 / (x))) * dataM2[i + j * strideM2] + Scalar(1.0 / (x)) * dataM3[i + j * strideM3] + Scalar(1.0 / (x)) * dataM4[i + j * strideM4] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(1.0 / (x)) * dataM1[i + j * strideM1] + Scalar(-(1.0 / (x))) * dataM2[i + j * strideM2] + Scalar(1.0 / (x)) * dataM3[i + j * strideM3] + Scalar(1.0 / (x)) * dataM4[i + j * strideM4];
-            }
-        }
-    }
+    const Scalar *data[4] = {M1.data(), M2.data(), M3.data(), M4.data()};
+    const int strides[4] = {M1.stride(), M2.stride(), M3.stride(), M4.stride()};
+    const Scalar coeffs[4] = {Scalar(1.0 / (x)), Scalar(-(1.0 / (x))), Scalar(1.0 / (x)), Scalar(1.0 / (x))};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
@@ -573,39 +247,41 @@ void FastMatmulRecursive(LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr
 
     // Matrices to store the results of multiplications.
 #ifdef _PARALLEL_
-    Matrix<Scalar> M1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
 #else
-    Matrix<Scalar> M1(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M2(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M3(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M4(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M5(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M6(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M7(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M8(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M9(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M10(C11.m(), C11.n(), C.multiplier());
-#endif
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-    bool sequential1 = should_launch_task(10, total_steps, steps_left, start_index, 1, num_threads);
-    bool sequential2 = should_launch_task(10, total_steps, steps_left, start_index, 2, num_threads);
-    bool sequential3 = should_launch_task(10, total_steps, steps_left, start_index, 3, num_threads);
-    bool sequential4 = should_launch_task(10, total_steps, steps_left, start_index, 4, num_threads);
-    bool sequential5 = should_launch_task(10, total_steps, steps_left, start_index, 5, num_threads);
-    bool sequential6 = should_launch_task(10, total_steps, steps_left, start_index, 6, num_threads);
-    bool sequential7 = should_launch_task(10, total_steps, steps_left, start_index, 7, num_threads);
-    bool sequential8 = should_launch_task(10, total_steps, steps_left, start_index, 8, num_threads);
-    bool sequential9 = should_launch_task(10, total_steps, steps_left, start_index, 9, num_threads);
-    bool sequential10 = should_launch_task(10, total_steps, steps_left, start_index, 10, num_threads);
+    Matrix<Scalar> M1 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M2 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M3 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M4 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M5 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M6 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M7 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M8 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M9 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M10 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+#endif
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    const TaskSchedule& schedule = locker.schedule() != NULL ? *locker.schedule() : TaskSchedule::Get(10, total_steps, num_threads);
+    const int level = total_steps - steps_left;
+    bool sequential1 = schedule.launch(level, start_index, 1);
+    bool sequential2 = schedule.launch(level, start_index, 2);
+    bool sequential3 = schedule.launch(level, start_index, 3);
+    bool sequential4 = schedule.launch(level, start_index, 4);
+    bool sequential5 = schedule.launch(level, start_index, 5);
+    bool sequential6 = schedule.launch(level, start_index, 6);
+    bool sequential7 = schedule.launch(level, start_index, 7);
+    bool sequential8 = schedule.launch(level, start_index, 8);
+    bool sequential9 = schedule.launch(level, start_index, 9);
+    bool sequential10 = schedule.launch(level, start_index, 10);
 #else
     bool sequential1 = false;
     bool sequential2 = false;
@@ -619,377 +295,464 @@ void FastMatmulRecursive(LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr
     bool sequential10 = false;
 #endif
 
+    // Handle edge cases with dynamic peeling.  The update for the inner
+    // dimension goes first, and the output additions add to it.
+    bool peel_tasks = sequential1;
+    PeelFringe(A, B, C, 3, 2, 2, beta, peel_tasks);
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    // Each block of C is summed by whichever task finishes its last input, while
+    // the other multiplies still run (see InputCountdown).
+    InputCountdown C11_inputs(5);
+    InputCountdown C12_inputs(3);
+    InputCountdown C21_inputs(4);
+    InputCountdown C22_inputs(4);
+    InputCountdown C31_inputs(3);
+    InputCountdown C32_inputs(5);
+    auto add_C11 = [&](bool sequential) {
+        if (C11_inputs.Ready()) {
+            M_Add1(M1, M2, M3, M4, C11, x, sequential, beta);
+        }
+    };
+    auto add_C12 = [&](bool sequential) {
+        if (C12_inputs.Ready()) {
+            M_Add2(M3, M5, C12, x, sequential, beta);
+        }
+    };
+    auto add_C21 = [&](bool sequential) {
+        if (C21_inputs.Ready()) {
+            M_Add3(M4, M6, M9, C21, x, sequential, beta);
+        }
+    };
+    auto add_C22 = [&](bool sequential) {
+        if (C22_inputs.Ready()) {
+            M_Add4(M1, M5, M10, C22, x, sequential, beta);
+        }
+    };
+    auto add_C31 = [&](bool sequential) {
+        if (C31_inputs.Ready()) {
+            M_Add5(M7, M9, C31, x, sequential, beta);
+        }
+    };
+    auto add_C32 = [&](bool sequential) {
+        if (C32_inputs.Ready()) {
+            M_Add6(M6, M7, M8, M10, C32, x, sequential, beta);
+        }
+    };
+    beta = PeelInnerDimension(A, B, C, 3, 2, 2, beta, peel_tasks, [&] {
+        add_C11(peel_tasks);
+        add_C12(peel_tasks);
+        add_C21(peel_tasks);
+        add_C22(peel_tasks);
+        add_C31(peel_tasks);
+        add_C32(peel_tasks);
+    });
+#else
+    beta = PeelInnerDimension(A, B, C, 3, 2, 2, beta, peel_tasks);
+#endif
+
 
 
     // M1 = (1 * A11 + 1 * A22) * (x * B11 + 1 * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential1) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential1, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S1(A11.m(), A11.n());
+    Matrix<Scalar> S1 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add1(A11, A22, S1, x, sequential1);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T1(B11.m(), B11.n());
+    Matrix<Scalar> T1 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add1(B11, B22, T1, x, sequential1);
-    FastMatmulRecursive(locker, mem_mngr, S1, T1, M1, total_steps, steps_left - 1, (start_index + 1 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 1));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S1, T1, M1, total_steps, steps_left - 1, (start_index + 1 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S1.deallocate();
     T1.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential1);
+    add_C22(sequential1);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 1, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 1)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 1) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M2 = (1 * A22) * (-1 * B21 + -1 * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential2) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential2, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> T2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T2(B11.m(), B11.n());
+    Matrix<Scalar> T2 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add2(B21, B22, T2, x, sequential2);
     M2.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A22, T2, M2, total_steps, steps_left - 1, (start_index + 2 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 2));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A22, T2, M2, total_steps, steps_left - 1, (start_index + 2 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     T2.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential2);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 2, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 2)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 2) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M3 = (1 * A11) * (1 * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential3) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential3, [&] {
 #endif
     M3.UpdateMultiplier(Scalar(1));
     M3.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A11, B22, M3, total_steps, steps_left - 1, (start_index + 3 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 3));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A11, B22, M3, total_steps, steps_left - 1, (start_index + 3 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential3);
+    add_C12(sequential3);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 3, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 3)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 3) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M4 = (x * A12 + 1 * A22) * (-(x) * B11 + 1 * B21)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential4) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential4, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S4(A11.m(), A11.n());
+    Matrix<Scalar> S4 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add4(A12, A22, S4, x, sequential4);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T4(B11.m(), B11.n());
+    Matrix<Scalar> T4 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add4(B11, B21, T4, x, sequential4);
-    FastMatmulRecursive(locker, mem_mngr, S4, T4, M4, total_steps, steps_left - 1, (start_index + 4 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 4));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S4, T4, M4, total_steps, steps_left - 1, (start_index + 4 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S4.deallocate();
     T4.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential4);
+    add_C21(sequential4);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 4, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 4)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 4) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M5 = (1 * A11 + x * A12) * (x * B12 + 1 * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential5) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential5, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S5(A11.m(), A11.n());
+    Matrix<Scalar> S5 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add5(A11, A12, S5, x, sequential5);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T5(B11.m(), B11.n());
+    Matrix<Scalar> T5 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add5(B12, B22, T5, x, sequential5);
-    FastMatmulRecursive(locker, mem_mngr, S5, T5, M5, total_steps, steps_left - 1, (start_index + 5 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 5));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S5, T5, M5, total_steps, steps_left - 1, (start_index + 5 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S5.deallocate();
     T5.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential5);
+    add_C22(sequential5);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 5, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 5)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 5) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M6 = (1 * A21 + 1 * A32) * (1 * B11 + x * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential6) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential6, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S6(A11.m(), A11.n());
+    Matrix<Scalar> S6 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add6(A21, A32, S6, x, sequential6);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T6(B11.m(), B11.n());
+    Matrix<Scalar> T6 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add6(B11, B22, T6, x, sequential6);
-    FastMatmulRecursive(locker, mem_mngr, S6, T6, M6, total_steps, steps_left - 1, (start_index + 6 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 6));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S6, T6, M6, total_steps, steps_left - 1, (start_index + 6 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S6.deallocate();
     T6.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C21(sequential6);
+    add_C32(sequential6);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 6, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 6)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 6) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M7 = (1 * A32) * (1 * B11)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential7) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential7, [&] {
 #endif
     M7.UpdateMultiplier(Scalar(1));
     M7.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A32, B11, M7, total_steps, steps_left - 1, (start_index + 7 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 7));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A32, B11, M7, total_steps, steps_left - 1, (start_index + 7 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C31(sequential7);
+    add_C32(sequential7);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 7, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 7)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 7) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M8 = (1 * A21) * (-1 * B11 + -1 * B12)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential8) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential8, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> T8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T8(B11.m(), B11.n());
+    Matrix<Scalar> T8 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add8(B11, B12, T8, x, sequential8);
     M8.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A21, T8, M8, total_steps, steps_left - 1, (start_index + 8 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 8));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A21, T8, M8, total_steps, steps_left - 1, (start_index + 8 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     T8.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C32(sequential8);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 8, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 8)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 8) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M9 = (x * A31 + 1 * A32) * (1 * B11 + x * B21)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential9) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential9, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S9(A11.m(), A11.n());
+    Matrix<Scalar> S9 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add9(A31, A32, S9, x, sequential9);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T9(B11.m(), B11.n());
+    Matrix<Scalar> T9 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add9(B11, B21, T9, x, sequential9);
-    FastMatmulRecursive(locker, mem_mngr, S9, T9, M9, total_steps, steps_left - 1, (start_index + 9 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 9));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S9, T9, M9, total_steps, steps_left - 1, (start_index + 9 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S9.deallocate();
     T9.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C21(sequential9);
+    add_C31(sequential9);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 9, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 9)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 9) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M10 = (1 * A21 + x * A31) * (1 * B12 + -(x) * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential10) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential10, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S10(A11.m(), A11.n());
+    Matrix<Scalar> S10 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add10(A21, A31, S10, x, sequential10);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T10(B11.m(), B11.n());
+    Matrix<Scalar> T10 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add10(B12, B22, T10, x, sequential10);
-    FastMatmulRecursive(locker, mem_mngr, S10, T10, M10, total_steps, steps_left - 1, (start_index + 10 - 1) * 10, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 10));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S10, T10, M10, total_steps, steps_left - 1, (start_index + 10 - 1) * 10, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S10.deallocate();
     T10.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C22(sequential10);
+    add_C32(sequential10);
 locker.Decrement();
-    }
-    if (should_task_wait(10, total_steps, steps_left, start_index, 10, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 10)) {
+        TaskWait();
     }
 #endif
 
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    if (peel_tasks) {
+        TaskWait();
+    }
+#endif
+#if !defined(_PARALLEL_) || (_PARALLEL_ != _BFS_PAR_ && _PARALLEL_ != _HYBRID_PAR_)
     M_Add1(M1, M2, M3, M4, C11, x, false, beta);
     M_Add2(M3, M5, C12, x, false, beta);
     M_Add3(M4, M6, M9, C21, x, false, beta);
     M_Add4(M1, M5, M10, C22, x, false, beta);
     M_Add5(M7, M9, C31, x, false, beta);
     M_Add6(M6, M7, M8, M10, C32, x, false, beta);
-
-    // Handle edge cases with dynamic peeling
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-    if (total_steps == steps_left) {
-        mkl_set_num_threads_local(num_threads);
-        mkl_set_dynamic(0);
-    }
 #endif
-    DynamicPeeling(A, B, C, 3, 2, 2, beta);
+}
+
+// Base case, rank, and temporaries of one step of the algorithm
+inline LevelShape Shape() {
+    return LevelShape(3, 2, 2, 10, 0, 0, 0,
+            {true, false, false, true, true, true, false, false, true, true},
+            {true, true, false, true, true, true, false, true, true, true});
+}
+
+// Plan for multiplying a num_rows_A x num_cols_A matrix with a num_cols_A x num_cols_B matrix
+template <typename Scalar>
+FastMatmulPlan<Scalar> MakePlan(int num_rows_A, int num_cols_A, int num_cols_B, int num_steps, double x=1e-8) {
+    return FastMatmulPlan<Scalar>(FastMatmulRecursive<Scalar>, Shape(), num_rows_A, num_cols_A, num_cols_B, num_steps, x);
 }
 
 // C := alpha * A * B + beta * C
 template <typename Scalar>
 double FastMatmul(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C,
     int num_steps, double x=1e-8, Scalar alpha=Scalar(1.0), Scalar beta=Scalar(0.0)) {
-    MemoryManager<Scalar> mem_mngr;
-#ifdef _PARALLEL_
-    mem_mngr.Allocate(3, 2, 2, 10, num_steps, A.m(), A.n(), B.n());
-#endif
-    A.set_multiplier(alpha);
-    int num_multiplies_per_step = 10;
-    int total_multiplies = pow(num_multiplies_per_step, num_steps);
-
-    // Set parameters needed for all types of parallelism.
-    int num_threads = 0;
-#ifdef _PARALLEL_
-# pragma omp parallel
-    {
-        if (omp_get_thread_num() == 0) { num_threads = omp_get_num_threads(); }
-    }
-    omp_set_nested(1);
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_)
-# pragma omp parallel
-    {
-        mkl_set_num_threads_local(1);
-        mkl_set_dynamic(0);
-    }
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _DFS_PAR_)
-    mkl_set_dynamic(0);
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    if (num_threads > total_multiplies) {
-        mkl_set_dynamic(0);
-    } else {
-# pragma omp parallel
-        {
-            mkl_set_num_threads_local(1);
-            mkl_set_dynamic(0);
-        }
-    }
-#endif
-
-    LockAndCounter locker(total_multiplies - (total_multiplies % num_threads));
-    using FpMilliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
-    auto t1 = std::chrono::high_resolution_clock::now();
-
-#ifdef _PARALLEL_
-# pragma omp parallel
-    {
-# pragma omp single
-#endif
-        FastMatmulRecursive(locker, mem_mngr, A, B, C, num_steps, num_steps, 0, x, num_threads, beta);
-#ifdef _PARALLEL_
-    }
-#endif
-    auto t2 = std::chrono::high_resolution_clock::now();
-    return FpMilliseconds(t2 - t1).count();
+    FastMatmulPlan<Scalar> plan = MakePlan<Scalar>(A.m(), A.n(), B.n(), num_steps, x);
+    return plan.Execute(A, B, C, alpha, beta);
 }
 
 }  // namespace bini322_10_52_approx
@@ -8,1145 +8,506 @@ namespace classical333_27_81 {
 
 template <typename Scalar>
 void S_Add1(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add2(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add3(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add4(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add5(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add6(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add7(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add8(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add9(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add10(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add11(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add12(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add13(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add14(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add15(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add16(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add17(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add18(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add19(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add20(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add21(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add22(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add23(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add24(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add25(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add26(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add27(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add1(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add2(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add3(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add4(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add5(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add6(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add7(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add8(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add9(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add10(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add11(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add12(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add13(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add14(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add15(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add16(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add17(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add18(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add19(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add20(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add21(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add22(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add23(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add24(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add25(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add26(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add27(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void M_Add1(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add2(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add3(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add4(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add5(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add6(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add7(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add8(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add9(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3];
-            }
-        }
-    }
+    const Scalar *data[3] = {M1.data(), M2.data(), M3.data()};
+    const int strides[3] = {M1.stride(), M2.stride(), M3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
@@ -1193,90 +554,92 @@ void FastMatmulRecursive(LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr
 
     // Matrices to store the results of multiplications.
 #ifdef _PARALLEL_
-    Matrix<Scalar> M1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M21(mem_mngr.GetMem(start_index, 21, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M22(mem_mngr.GetMem(start_index, 22, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M23(mem_mngr.GetMem(start_index, 23, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M24(mem_mngr.GetMem(start_index, 24, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M25(mem_mngr.GetMem(start_index, 25, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M26(mem_mngr.GetMem(start_index, 26, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M27(mem_mngr.GetMem(start_index, 27, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M21(mem_mngr.GetMem(start_index, 21, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M22(mem_mngr.GetMem(start_index, 22, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M23(mem_mngr.GetMem(start_index, 23, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M24(mem_mngr.GetMem(start_index, 24, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M25(mem_mngr.GetMem(start_index, 25, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M26(mem_mngr.GetMem(start_index, 26, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M27(mem_mngr.GetMem(start_index, 27, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
 #else
-    Matrix<Scalar> M1(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M2(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M3(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M4(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M5(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M6(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M7(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M8(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M9(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M10(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M11(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M12(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M13(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M14(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M15(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M16(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M17(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M18(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M19(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M20(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M21(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M22(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M23(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M24(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M25(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M26(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M27(C11.m(), C11.n(), C.multiplier());
-#endif
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-    bool sequential1 = should_launch_task(27, total_steps, steps_left, start_index, 1, num_threads);
-    bool sequential2 = should_launch_task(27, total_steps, steps_left, start_index, 2, num_threads);
-    bool sequential3 = should_launch_task(27, total_steps, steps_left, start_index, 3, num_threads);
-    bool sequential4 = should_launch_task(27, total_steps, steps_left, start_index, 4, num_threads);
-    bool sequential5 = should_launch_task(27, total_steps, steps_left, start_index, 5, num_threads);
-    bool sequential6 = should_launch_task(27, total_steps, steps_left, start_index, 6, num_threads);
-    bool sequential7 = should_launch_task(27, total_steps, steps_left, start_index, 7, num_threads);
-    bool sequential8 = should_launch_task(27, total_steps, steps_left, start_index, 8, num_threads);
-    bool sequential9 = should_launch_task(27, total_steps, steps_left, start_index, 9, num_threads);
-    bool sequential10 = should_launch_task(27, total_steps, steps_left, start_index, 10, num_threads);
-    bool sequential11 = should_launch_task(27, total_steps, steps_left, start_index, 11, num_threads);
-    bool sequential12 = should_launch_task(27, total_steps, steps_left, start_index, 12, num_threads);
-    bool sequential13 = should_launch_task(27, total_steps, steps_left, start_index, 13, num_threads);
-    bool sequential14 = should_launch_task(27, total_steps, steps_left, start_index, 14, num_threads);
-    bool sequential15 = should_launch_task(27, total_steps, steps_left, start_index, 15, num_threads);
-    bool sequential16 = should_launch_task(27, total_steps, steps_left, start_index, 16, num_threads);
-    bool sequential17 = should_launch_task(27, total_steps, steps_left, start_index, 17, num_threads);
-    bool sequential18 = should_launch_task(27, total_steps, steps_left, start_index, 18, num_threads);
-    bool sequential19 = should_launch_task(27, total_steps, steps_left, start_index, 19, num_threads);
-    bool sequential20 = should_launch_task(27, total_steps, steps_left, start_index, 20, num_threads);
-    bool sequential21 = should_launch_task(27, total_steps, steps_left, start_index, 21, num_threads);
-    bool sequential22 = should_launch_task(27, total_steps, steps_left, start_index, 22, num_threads);
-    bool sequential23 = should_launch_task(27, total_steps, steps_left, start_index, 23, num_threads);
-    bool sequential24 = should_launch_task(27, total_steps, steps_left, start_index, 24, num_threads);
-    bool sequential25 = should_launch_task(27, total_steps, steps_left, start_index, 25, num_threads);
-    bool sequential26 = should_launch_task(27, total_steps, steps_left, start_index, 26, num_threads);
-    bool sequential27 = should_launch_task(27, total_steps, steps_left, start_index, 27, num_threads);
+    Matrix<Scalar> M1 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M2 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M3 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M4 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M5 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M6 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M7 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M8 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M9 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M10 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M11 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M12 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M13 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M14 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M15 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M16 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M17 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M18 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M19 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M20 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M21 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M22 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M23 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M24 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M25 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M26 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M27 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+#endif
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    const TaskSchedule& schedule = locker.schedule() != NULL ? *locker.schedule() : TaskSchedule::Get(27, total_steps, num_threads);
+    const int level = total_steps - steps_left;
+    bool sequential1 = schedule.launch(level, start_index, 1);
+    bool sequential2 = schedule.launch(level, start_index, 2);
+    bool sequential3 = schedule.launch(level, start_index, 3);
+    bool sequential4 = schedule.launch(level, start_index, 4);
+    bool sequential5 = schedule.launch(level, start_index, 5);
+    bool sequential6 = schedule.launch(level, start_index, 6);
+    bool sequential7 = schedule.launch(level, start_index, 7);
+    bool sequential8 = schedule.launch(level, start_index, 8);
+    bool sequential9 = schedule.launch(level, start_index, 9);
+    bool sequential10 = schedule.launch(level, start_index, 10);
+    bool sequential11 = schedule.launch(level, start_index, 11);
+    bool sequential12 = schedule.launch(level, start_index, 12);
+    bool sequential13 = schedule.launch(level, start_index, 13);
+    bool sequential14 = schedule.launch(level, start_index, 14);
+    bool sequential15 = schedule.launch(level, start_index, 15);
+    bool sequential16 = schedule.launch(level, start_index, 16);
+    bool sequential17 = schedule.launch(level, start_index, 17);
+    bool sequential18 = schedule.launch(level, start_index, 18);
+    bool sequential19 = schedule.launch(level, start_index, 19);
+    bool sequential20 = schedule.launch(level, start_index, 20);
+    bool sequential21 = schedule.launch(level, start_index, 21);
+    bool sequential22 = schedule.launch(level, start_index, 22);
+    bool sequential23 = schedule.launch(level, start_index, 23);
+    bool sequential24 = schedule.launch(level, start_index, 24);
+    bool sequential25 = schedule.launch(level, start_index, 25);
+    bool sequential26 = schedule.launch(level, start_index, 26);
+    bool sequential27 = schedule.launch(level, start_index, 27);
 #else
     bool sequential1 = false;
     bool sequential2 = false;
@@ -1307,572 +670,841 @@ void FastMatmulRecursive(LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr
     bool sequential27 = false;
 #endif
 
+    // Handle edge cases with dynamic peeling.  The update for the inner
+    // dimension goes first, and the output additions add to it.
+    bool peel_tasks = sequential1;
+    PeelFringe(A, B, C, 3, 3, 3, beta, peel_tasks);
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    // Each block of C is summed by whichever task finishes its last input, while
+    // the other multiplies still run (see InputCountdown).
+    InputCountdown C11_inputs(4);
+    InputCountdown C12_inputs(4);
+    InputCountdown C13_inputs(4);
+    InputCountdown C21_inputs(4);
+    InputCountdown C22_inputs(4);
+    InputCountdown C23_inputs(4);
+    InputCountdown C31_inputs(4);
+    InputCountdown C32_inputs(4);
+    InputCountdown C33_inputs(4);
+    auto add_C11 = [&](bool sequential) {
+        if (C11_inputs.Ready()) {
+            M_Add1(M1, M2, M3, C11, x, sequential, beta);
+        }
+    };
+    auto add_C12 = [&](bool sequential) {
+        if (C12_inputs.Ready()) {
+            M_Add2(M4, M5, M6, C12, x, sequential, beta);
+        }
+    };
+    auto add_C13 = [&](bool sequential) {
+        if (C13_inputs.Ready()) {
+            M_Add3(M7, M8, M9, C13, x, sequential, beta);
+        }
+    };
+    auto add_C21 = [&](bool sequential) {
+        if (C21_inputs.Ready()) {
+            M_Add4(M10, M11, M12, C21, x, sequential, beta);
+        }
+    };
+    auto add_C22 = [&](bool sequential) {
+        if (C22_inputs.Ready()) {
+            M_Add5(M13, M14, M15, C22, x, sequential, beta);
+        }
+    };
+    auto add_C23 = [&](bool sequential) {
+        if (C23_inputs.Ready()) {
+            M_Add6(M16, M17, M18, C23, x, sequential, beta);
+        }
+    };
+    auto add_C31 = [&](bool sequential) {
+        if (C31_inputs.Ready()) {
+            M_Add7(M19, M20, M21, C31, x, sequential, beta);
+        }
+    };
+    auto add_C32 = [&](bool sequential) {
+        if (C32_inputs.Ready()) {
+            M_Add8(M22, M23, M24, C32, x, sequential, beta);
+        }
+    };
+    auto add_C33 = [&](bool sequential) {
+        if (C33_inputs.Ready()) {
+            M_Add9(M25, M26, M27, C33, x, sequential, beta);
+        }
+    };
+    beta = PeelInnerDimension(A, B, C, 3, 3, 3, beta, peel_tasks, [&] {
+        add_C11(peel_tasks);
+        add_C12(peel_tasks);
+        add_C13(peel_tasks);
+        add_C21(peel_tasks);
+        add_C22(peel_tasks);
+        add_C23(peel_tasks);
+        add_C31(peel_tasks);
+        add_C32(peel_tasks);
+        add_C33(peel_tasks);
+    });
+#else
+    beta = PeelInnerDimension(A, B, C, 3, 3, 3, beta, peel_tasks);
+#endif
+
 
 
     // M1 = (1 * A11) * (1 * B11)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential1) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential1, [&] {
 #endif
     M1.UpdateMultiplier(Scalar(1));
     M1.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A11, B11, M1, total_steps, steps_left - 1, (start_index + 1 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 1));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A11, B11, M1, total_steps, steps_left - 1, (start_index + 1 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential1);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 1, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 1)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 1) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M2 = (1 * A12) * (1 * B21)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential2) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential2, [&] {
 #endif
     M2.UpdateMultiplier(Scalar(1));
     M2.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A12, B21, M2, total_steps, steps_left - 1, (start_index + 2 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 2));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A12, B21, M2, total_steps, steps_left - 1, (start_index + 2 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential2);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 2, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 2)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 2) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M3 = (1 * A13) * (1 * B31)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential3) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential3, [&] {
 #endif
     M3.UpdateMultiplier(Scalar(1));
     M3.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A13, B31, M3, total_steps, steps_left - 1, (start_index + 3 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 3));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A13, B31, M3, total_steps, steps_left - 1, (start_index + 3 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential3);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 3, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 3)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 3) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M4 = (1 * A11) * (1 * B12)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential4) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential4, [&] {
 #endif
     M4.UpdateMultiplier(Scalar(1));
     M4.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A11, B12, M4, total_steps, steps_left - 1, (start_index + 4 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 4));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A11, B12, M4, total_steps, steps_left - 1, (start_index + 4 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential4);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 4, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 4)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 4) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M5 = (1 * A12) * (1 * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential5) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential5, [&] {
 #endif
     M5.UpdateMultiplier(Scalar(1));
     M5.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A12, B22, M5, total_steps, steps_left - 1, (start_index + 5 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 5));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A12, B22, M5, total_steps, steps_left - 1, (start_index + 5 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential5);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 5, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 5)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 5) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M6 = (1 * A13) * (1 * B32)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential6) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential6, [&] {
 #endif
     M6.UpdateMultiplier(Scalar(1));
     M6.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A13, B32, M6, total_steps, steps_left - 1, (start_index + 6 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 6));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A13, B32, M6, total_steps, steps_left - 1, (start_index + 6 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential6);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 6, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 6)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 6) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M7 = (1 * A11) * (1 * B13)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential7) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential7, [&] {
 #endif
     M7.UpdateMultiplier(Scalar(1));
     M7.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A11, B13, M7, total_steps, steps_left - 1, (start_index + 7 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 7));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A11, B13, M7, total_steps, steps_left - 1, (start_index + 7 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C13(sequential7);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 7, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 7)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 7) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M8 = (1 * A12) * (1 * B23)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential8) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential8, [&] {
 #endif
     M8.UpdateMultiplier(Scalar(1));
     M8.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A12, B23, M8, total_steps, steps_left - 1, (start_index + 8 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 8));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A12, B23, M8, total_steps, steps_left - 1, (start_index + 8 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C13(sequential8);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 8, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 8)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 8) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M9 = (1 * A13) * (1 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential9) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential9, [&] {
 #endif
     M9.UpdateMultiplier(Scalar(1));
     M9.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A13, B33, M9, total_steps, steps_left - 1, (start_index + 9 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 9));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A13, B33, M9, total_steps, steps_left - 1, (start_index + 9 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C13(sequential9);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 9, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 9)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 9) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M10 = (1 * A21) * (1 * B11)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential10) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential10, [&] {
 #endif
     M10.UpdateMultiplier(Scalar(1));
     M10.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A21, B11, M10, total_steps, steps_left - 1, (start_index + 10 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 10));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A21, B11, M10, total_steps, steps_left - 1, (start_index + 10 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C21(sequential10);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 10, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 10)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 10) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M11 = (1 * A22) * (1 * B21)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential11) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential11, [&] {
 #endif
     M11.UpdateMultiplier(Scalar(1));
     M11.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A22, B21, M11, total_steps, steps_left - 1, (start_index + 11 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 11));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A22, B21, M11, total_steps, steps_left - 1, (start_index + 11 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C21(sequential11);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 11, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 11)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 11) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M12 = (1 * A23) * (1 * B31)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential12) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential12, [&] {
 #endif
     M12.UpdateMultiplier(Scalar(1));
     M12.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A23, B31, M12, total_steps, steps_left - 1, (start_index + 12 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 12));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A23, B31, M12, total_steps, steps_left - 1, (start_index + 12 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C21(sequential12);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 12, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 12)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 12) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M13 = (1 * A21) * (1 * B12)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential13) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential13, [&] {
 #endif
     M13.UpdateMultiplier(Scalar(1));
     M13.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A21, B12, M13, total_steps, steps_left - 1, (start_index + 13 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 13));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A21, B12, M13, total_steps, steps_left - 1, (start_index + 13 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C22(sequential13);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 13, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 13)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 13) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M14 = (1 * A22) * (1 * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential14) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential14, [&] {
 #endif
     M14.UpdateMultiplier(Scalar(1));
     M14.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A22, B22, M14, total_steps, steps_left - 1, (start_index + 14 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 14));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A22, B22, M14, total_steps, steps_left - 1, (start_index + 14 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C22(sequential14);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 14, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 14)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 14) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M15 = (1 * A23) * (1 * B32)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential15) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential15, [&] {
 #endif
     M15.UpdateMultiplier(Scalar(1));
     M15.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A23, B32, M15, total_steps, steps_left - 1, (start_index + 15 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 15));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A23, B32, M15, total_steps, steps_left - 1, (start_index + 15 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C22(sequential15);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 15, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 15)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 15) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M16 = (1 * A21) * (1 * B13)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential16) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential16, [&] {
 #endif
     M16.UpdateMultiplier(Scalar(1));
     M16.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A21, B13, M16, total_steps, steps_left - 1, (start_index + 16 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 16));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A21, B13, M16, total_steps, steps_left - 1, (start_index + 16 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C23(sequential16);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 16, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 16)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 16) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M17 = (1 * A22) * (1 * B23)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential17) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential17, [&] {
 #endif
     M17.UpdateMultiplier(Scalar(1));
     M17.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A22, B23, M17, total_steps, steps_left - 1, (start_index + 17 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 17));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A22, B23, M17, total_steps, steps_left - 1, (start_index + 17 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C23(sequential17);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 17, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 17)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 17) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M18 = (1 * A23) * (1 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential18) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential18, [&] {
 #endif
     M18.UpdateMultiplier(Scalar(1));
     M18.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A23, B33, M18, total_steps, steps_left - 1, (start_index + 18 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 18));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A23, B33, M18, total_steps, steps_left - 1, (start_index + 18 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C23(sequential18);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 18, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 18)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 18) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M19 = (1 * A31) * (1 * B11)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential19) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential19, [&] {
 #endif
     M19.UpdateMultiplier(Scalar(1));
     M19.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A31, B11, M19, total_steps, steps_left - 1, (start_index + 19 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 19));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A31, B11, M19, total_steps, steps_left - 1, (start_index + 19 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C31(sequential19);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 19, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 19)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 19) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M20 = (1 * A32) * (1 * B21)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential20) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential20, [&] {
 #endif
     M20.UpdateMultiplier(Scalar(1));
     M20.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A32, B21, M20, total_steps, steps_left - 1, (start_index + 20 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 20));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A32, B21, M20, total_steps, steps_left - 1, (start_index + 20 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C31(sequential20);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 20, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 20)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 20) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M21 = (1 * A33) * (1 * B31)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential21) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential21, [&] {
 #endif
     M21.UpdateMultiplier(Scalar(1));
     M21.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A33, B31, M21, total_steps, steps_left - 1, (start_index + 21 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 21));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A33, B31, M21, total_steps, steps_left - 1, (start_index + 21 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C31(sequential21);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 21, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 21)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 21) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M22 = (1 * A31) * (1 * B12)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential22) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential22, [&] {
 #endif
     M22.UpdateMultiplier(Scalar(1));
     M22.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A31, B12, M22, total_steps, steps_left - 1, (start_index + 22 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 22));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A31, B12, M22, total_steps, steps_left - 1, (start_index + 22 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C32(sequential22);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 22, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 22)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 22) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M23 = (1 * A32) * (1 * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential23) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential23, [&] {
 #endif
     M23.UpdateMultiplier(Scalar(1));
     M23.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A32, B22, M23, total_steps, steps_left - 1, (start_index + 23 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 23));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A32, B22, M23, total_steps, steps_left - 1, (start_index + 23 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C32(sequential23);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 23, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 23)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 23) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M24 = (1 * A33) * (1 * B32)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential24) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential24, [&] {
 #endif
     M24.UpdateMultiplier(Scalar(1));
     M24.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A33, B32, M24, total_steps, steps_left - 1, (start_index + 24 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 24));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A33, B32, M24, total_steps, steps_left - 1, (start_index + 24 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C32(sequential24);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 24, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 24)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 24) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M25 = (1 * A31) * (1 * B13)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential25) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential25, [&] {
 #endif
     M25.UpdateMultiplier(Scalar(1));
     M25.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A31, B13, M25, total_steps, steps_left - 1, (start_index + 25 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 25));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A31, B13, M25, total_steps, steps_left - 1, (start_index + 25 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C33(sequential25);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 25, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 25)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 25) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M26 = (1 * A32) * (1 * B23)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential26) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential26, [&] {
 #endif
     M26.UpdateMultiplier(Scalar(1));
     M26.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A32, B23, M26, total_steps, steps_left - 1, (start_index + 26 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 26));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A32, B23, M26, total_steps, steps_left - 1, (start_index + 26 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C33(sequential26);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 26, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 26)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 26) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M27 = (1 * A33) * (1 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential27) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential27, [&] {
 #endif
     M27.UpdateMultiplier(Scalar(1));
     M27.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A33, B33, M27, total_steps, steps_left - 1, (start_index + 27 - 1) * 27, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 27));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A33, B33, M27, total_steps, steps_left - 1, (start_index + 27 - 1) * 27, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C33(sequential27);
 locker.Decrement();
-    }
-    if (should_task_wait(27, total_steps, steps_left, start_index, 27, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 27)) {
+        TaskWait();
     }
 #endif
 
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    if (peel_tasks) {
+        TaskWait();
+    }
+#endif
+#if !defined(_PARALLEL_) || (_PARALLEL_ != _BFS_PAR_ && _PARALLEL_ != _HYBRID_PAR_)
     M_Add1(M1, M2, M3, C11, x, false, beta);
     M_Add2(M4, M5, M6, C12, x, false, beta);
     M_Add3(M7, M8, M9, C13, x, false, beta);
@@ -1882,78 +1514,28 @@ locker.Decrement();
     M_Add7(M19, M20, M21, C31, x, false, beta);
     M_Add8(M22, M23, M24, C32, x, false, beta);
     M_Add9(M25, M26, M27, C33, x, false, beta);
-
-    // Handle edge cases with dynamic peeling
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-    if (total_steps == steps_left) {
-        mkl_set_num_threads_local(num_threads);
-        mkl_set_dynamic(0);
-    }
 #endif
-    DynamicPeeling(A, B, C, 3, 3, 3, beta);
+}
+
+// Base case, rank, and temporaries of one step of the algorithm
+inline LevelShape Shape() {
+    return LevelShape(3, 3, 3, 27, 0, 0, 0,
+            {false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false},
+            {false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false});
+}
+
+// Plan for multiplying a num_rows_A x num_cols_A matrix with a num_cols_A x num_cols_B matrix
+template <typename Scalar>
+FastMatmulPlan<Scalar> MakePlan(int num_rows_A, int num_cols_A, int num_cols_B, int num_steps, double x=1e-8) {
+    return FastMatmulPlan<Scalar>(FastMatmulRecursive<Scalar>, Shape(), num_rows_A, num_cols_A, num_cols_B, num_steps, x);
 }
 
 // C := alpha * A * B + beta * C
 template <typename Scalar>
 double FastMatmul(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C,
     int num_steps, double x=1e-8, Scalar alpha=Scalar(1.0), Scalar beta=Scalar(0.0)) {
-    MemoryManager<Scalar> mem_mngr;
-#ifdef _PARALLEL_
-    mem_mngr.Allocate(3, 3, 3, 27, num_steps, A.m(), A.n(), B.n());
-#endif
-    A.set_multiplier(alpha);
-    int num_multiplies_per_step = 27;
-    int total_multiplies = pow(num_multiplies_per_step, num_steps);
-
-    // Set parameters needed for all types of parallelism.
-    int num_threads = 0;
-#ifdef _PARALLEL_
-# pragma omp parallel
-    {
-        if (omp_get_thread_num() == 0) { num_threads = omp_get_num_threads(); }
-    }
-    omp_set_nested(1);
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_)
-# pragma omp parallel
-    {
-        mkl_set_num_threads_local(1);
-        mkl_set_dynamic(0);
-    }
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _DFS_PAR_)
-    mkl_set_dynamic(0);
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    if (num_threads > total_multiplies) {
-        mkl_set_dynamic(0);
-    } else {
-# pragma omp parallel
-        {
-            mkl_set_num_threads_local(1);
-            mkl_set_dynamic(0);
-        }
-    }
-#endif
-
-    LockAndCounter locker(total_multiplies - (total_multiplies % num_threads));
-    using FpMilliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
-    auto t1 = std::chrono::high_resolution_clock::now();
-
-#ifdef _PARALLEL_
-# pragma omp parallel
-    {
-# pragma omp single
-#endif
-        FastMatmulRecursive(locker, mem_mngr, A, B, C, num_steps, num_steps, 0, x, num_threads, beta);
-#ifdef _PARALLEL_
-    }
-#endif
-    auto t2 = std::chrono::high_resolution_clock::now();
-    return FpMilliseconds(t2 - t1).count();
+    FastMatmulPlan<Scalar> plan = MakePlan<Scalar>(A.m(), A.n(), B.n(), num_steps, x);
+    return plan.Execute(A, B, C, alpha, beta);
 }
 
 }  // namespace classical333_27_81
@@ -8,1000 +8,370 @@ namespace grey243_20_144 {
 
 template <typename Scalar>
 void S_Add1(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1] -dataS2[i + j * strideS2] -dataS3[i + j * strideS3] -dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-1), Scalar(-1), Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add2(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1] -dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add3(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(-1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add4(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1] -dataS2[i + j * strideS2] -dataS3[i + j * strideS3];
-        }
-    }
+    const Scalar *data[3] = {S1.data(), S2.data(), S3.data()};
+    const int strides[3] = {S1.stride(), S2.stride(), S3.stride()};
+    const Scalar coeffs[3] = {Scalar(-1), Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add5(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add6(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(-1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add7(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1] -dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add8(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add9(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(-1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add10(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add11(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(-1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add12(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] -dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(-1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add13(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add14(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add15(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add16(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1] -dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add17(Matrix<Scalar>& S1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1];
-        }
-    }
+    const Scalar *data[1] = {S1.data()};
+    const int strides[1] = {S1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add18(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataS1[i + j * strideS1] + dataS2[i + j * strideS2] + dataS3[i + j * strideS3];
-        }
-    }
+    const Scalar *data[3] = {S1.data(), S2.data(), S3.data()};
+    const int strides[3] = {S1.stride(), S2.stride(), S3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add19(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1] -dataS2[i + j * strideS2] -dataS3[i + j * strideS3] -dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-1), Scalar(-1), Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add20(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataS1[i + j * strideS1] -dataS2[i + j * strideS2];
-        }
-    }
+    const Scalar *data[2] = {S1.data(), S2.data()};
+    const int strides[2] = {S1.stride(), S2.stride()};
+    const Scalar coeffs[2] = {Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add1(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add2(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add3(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + dataT2[i + j * strideT2] + dataT3[i + j * strideT3];
-        }
-    }
+    const Scalar *data[3] = {T1.data(), T2.data(), T3.data()};
+    const int strides[3] = {T1.stride(), T2.stride(), T3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add4(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] -dataT2[i + j * strideT2] -dataT3[i + j * strideT3];
-        }
-    }
+    const Scalar *data[3] = {T1.data(), T2.data(), T3.data()};
+    const int strides[3] = {T1.stride(), T2.stride(), T3.stride()};
+    const Scalar coeffs[3] = {Scalar(-1), Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add5(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(-1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add6(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + dataT2[i + j * strideT2] -dataT3[i + j * strideT3];
-        }
-    }
+    const Scalar *data[3] = {T1.data(), T2.data(), T3.data()};
+    const int strides[3] = {T1.stride(), T2.stride(), T3.stride()};
+    const Scalar coeffs[3] = {Scalar(1), Scalar(1), Scalar(-1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add7(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] -dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(-1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add8(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add9(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + dataT2[i + j * strideT2] -dataT3[i + j * strideT3] + dataT4[i + j * strideT4] + dataT5[i + j * strideT5];
-        }
-    }
+    const Scalar *data[5] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data()};
+    const int strides[5] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride()};
+    const Scalar coeffs[5] = {Scalar(1), Scalar(1), Scalar(-1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 5>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add10(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] -dataT2[i + j * strideT2] -dataT3[i + j * strideT3] + dataT4[i + j * strideT4];
-        }
-    }
+    const Scalar *data[4] = {T1.data(), T2.data(), T3.data(), T4.data()};
+    const int strides[4] = {T1.stride(), T2.stride(), T3.stride(), T4.stride()};
+    const Scalar coeffs[4] = {Scalar(-1), Scalar(-1), Scalar(-1), Scalar(1)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add11(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] -dataT2[i + j * strideT2] + dataT3[i + j * strideT3] + dataT4[i + j * strideT4];
-        }
-    }
+    const Scalar *data[4] = {T1.data(), T2.data(), T3.data(), T4.data()};
+    const int strides[4] = {T1.stride(), T2.stride(), T3.stride(), T4.stride()};
+    const Scalar coeffs[4] = {Scalar(-1), Scalar(-1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add12(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] -dataT2[i + j * strideT2] -dataT3[i + j * strideT3];
-        }
-    }
+    const Scalar *data[3] = {T1.data(), T2.data(), T3.data()};
+    const int strides[3] = {T1.stride(), T2.stride(), T3.stride()};
+    const Scalar coeffs[3] = {Scalar(-1), Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add13(Matrix<Scalar>& T1, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1];
-        }
-    }
+    const Scalar *data[1] = {T1.data()};
+    const int strides[1] = {T1.stride()};
+    const Scalar coeffs[1] = {Scalar(1)};
+    MultiAdd<Scalar, 1>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add14(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] + dataT2[i + j * strideT2] + dataT3[i + j * strideT3];
-        }
-    }
+    const Scalar *data[3] = {T1.data(), T2.data(), T3.data()};
+    const int strides[3] = {T1.stride(), T2.stride(), T3.stride()};
+    const Scalar coeffs[3] = {Scalar(-1), Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add15(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] + dataT2[i + j * strideT2] -dataT3[i + j * strideT3] -dataT4[i + j * strideT4] -dataT5[i + j * strideT5];
-        }
-    }
+    const Scalar *data[5] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data()};
+    const int strides[5] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride()};
+    const Scalar coeffs[5] = {Scalar(-1), Scalar(1), Scalar(-1), Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 5>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add16(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add17(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] + dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(-1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add18(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = -dataT1[i + j * strideT1] -dataT2[i + j * strideT2] -dataT3[i + j * strideT3];
-        }
-    }
+    const Scalar *data[3] = {T1.data(), T2.data(), T3.data()};
+    const int strides[3] = {T1.stride(), T2.stride(), T3.stride()};
+    const Scalar coeffs[3] = {Scalar(-1), Scalar(-1), Scalar(-1)};
+    MultiAdd<Scalar, 3>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add19(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add20(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = dataT1[i + j * strideT1] + dataT2[i + j * strideT2];
-        }
-    }
+    const Scalar *data[2] = {T1.data(), T2.data()};
+    const int strides[2] = {T1.stride(), T2.stride()};
+    const Scalar coeffs[2] = {Scalar(1), Scalar(1)};
+    MultiAdd<Scalar, 2>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void M_Add1(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = -dataM1[i + j * strideM1] + dataM2[i + j * strideM2] -dataM3[i + j * strideM3] -dataM4[i + j * strideM4] -dataM5[i + j * strideM5] -dataM6[i + j * strideM6] -dataM7[i + j * strideM7] + dataM8[i + j * strideM8] -dataM9[i + j * strideM9] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = -dataM1[i + j * strideM1] + dataM2[i + j * strideM2] -dataM3[i + j * strideM3] -dataM4[i + j * strideM4] -dataM5[i + j * strideM5] -dataM6[i + j * strideM6] -dataM7[i + j * strideM7] + dataM8[i + j * strideM8] -dataM9[i + j * strideM9];
-            }
-        }
-    }
+    const Scalar *data[9] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data()};
+    const int strides[9] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride()};
+    const Scalar coeffs[9] = {Scalar(-1), Scalar(1), Scalar(-1), Scalar(-1), Scalar(-1), Scalar(-1), Scalar(-1), Scalar(1), Scalar(-1)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add2(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] -dataM2[i + j * strideM2] -dataM3[i + j * strideM3] -dataM4[i + j * strideM4] -dataM5[i + j * strideM5] -dataM6[i + j * strideM6] + dataM7[i + j * strideM7] -dataM8[i + j * strideM8] -dataM9[i + j * strideM9] + dataM10[i + j * strideM10] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] -dataM2[i + j * strideM2] -dataM3[i + j * strideM3] -dataM4[i + j * strideM4] -dataM5[i + j * strideM5] -dataM6[i + j * strideM6] + dataM7[i + j * strideM7] -dataM8[i + j * strideM8] -dataM9[i + j * strideM9] + dataM10[i + j * strideM10];
-            }
-        }
-    }
+    const Scalar *data[10] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data()};
+    const int strides[10] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride()};
+    const Scalar coeffs[10] = {Scalar(1), Scalar(-1), Scalar(-1), Scalar(-1), Scalar(-1), Scalar(-1), Scalar(1), Scalar(-1), Scalar(-1), Scalar(1)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add3(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = -dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + dataM4[i + j * strideM4] -dataM5[i + j * strideM5] + dataM6[i + j * strideM6] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = -dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + dataM4[i + j * strideM4] -dataM5[i + j * strideM5] + dataM6[i + j * strideM6];
-            }
-        }
-    }
+    const Scalar *data[6] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data()};
+    const int strides[6] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride()};
+    const Scalar coeffs[6] = {Scalar(-1), Scalar(1), Scalar(1), Scalar(1), Scalar(-1), Scalar(1)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add4(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + dataM4[i + j * strideM4] + dataM5[i + j * strideM5] -dataM6[i + j * strideM6] + dataM7[i + j * strideM7] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + dataM4[i + j * strideM4] + dataM5[i + j * strideM5] -dataM6[i + j * strideM6] + dataM7[i + j * strideM7];
-            }
-        }
-    }
+    const Scalar *data[7] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data()};
+    const int strides[7] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride()};
+    const Scalar coeffs[7] = {Scalar(1), Scalar(1), Scalar(1), Scalar(1), Scalar(1), Scalar(-1), Scalar(1)};
+    MultiAdd<Scalar, 7>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add5(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = -dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + dataM4[i + j * strideM4] -dataM5[i + j * strideM5] + dataM6[i + j * strideM6] + dataM7[i + j * strideM7] -dataM8[i + j * strideM8] + dataM9[i + j * strideM9] -dataM10[i + j * strideM10] + dataM11[i + j * strideM11] -dataM12[i + j * strideM12] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = -dataM1[i + j * strideM1] + dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + dataM4[i + j * strideM4] -dataM5[i + j * strideM5] + dataM6[i + j * strideM6] + dataM7[i + j * strideM7] -dataM8[i + j * strideM8] + dataM9[i + j * strideM9] -dataM10[i + j * strideM10] + dataM11[i + j * strideM11] -dataM12[i + j * strideM12];
-            }
-        }
-    }
+    const Scalar *data[12] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data()};
+    const int strides[12] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride()};
+    const Scalar coeffs[12] = {Scalar(-1), Scalar(1), Scalar(1), Scalar(1), Scalar(-1), Scalar(1), Scalar(1), Scalar(-1), Scalar(1), Scalar(-1), Scalar(1), Scalar(-1)};
+    MultiAdd<Scalar, 12>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add6(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] -dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + dataM4[i + j * strideM4] + dataM5[i + j * strideM5] + dataM6[i + j * strideM6] -dataM7[i + j * strideM7] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = dataM1[i + j * strideM1] -dataM2[i + j * strideM2] + dataM3[i + j * strideM3] + dataM4[i + j * strideM4] + dataM5[i + j * strideM5] + dataM6[i + j * strideM6] -dataM7[i + j * strideM7];
-            }
-        }
-    }
+    const Scalar *data[7] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data()};
+    const int strides[7] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride()};
+    const Scalar coeffs[7] = {Scalar(1), Scalar(-1), Scalar(1), Scalar(1), Scalar(1), Scalar(1), Scalar(-1)};
+    MultiAdd<Scalar, 7>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
@@ -1047,69 +417,71 @@ void FastMatmulRecursive(LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr
 
     // Matrices to store the results of multiplications.
 #ifdef _PARALLEL_
-    Matrix<Scalar> M1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
 #else
-    Matrix<Scalar> M1(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M2(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M3(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M4(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M5(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M6(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M7(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M8(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M9(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M10(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M11(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M12(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M13(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M14(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M15(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M16(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M17(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M18(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M19(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M20(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M1 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M2 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M3 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M4 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M5 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M6 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M7 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M8 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M9 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M10 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M11 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M12 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M13 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M14 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M15 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M16 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M17 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M18 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M19 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M20 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-    bool sequential1 = should_launch_task(20, total_steps, steps_left, start_index, 1, num_threads);
-    bool sequential2 = should_launch_task(20, total_steps, steps_left, start_index, 2, num_threads);
-    bool sequential3 = should_launch_task(20, total_steps, steps_left, start_index, 3, num_threads);
-    bool sequential4 = should_launch_task(20, total_steps, steps_left, start_index, 4, num_threads);
-    bool sequential5 = should_launch_task(20, total_steps, steps_left, start_index, 5, num_threads);
-    bool sequential6 = should_launch_task(20, total_steps, steps_left, start_index, 6, num_threads);
-    bool sequential7 = should_launch_task(20, total_steps, steps_left, start_index, 7, num_threads);
-    bool sequential8 = should_launch_task(20, total_steps, steps_left, start_index, 8, num_threads);
-    bool sequential9 = should_launch_task(20, total_steps, steps_left, start_index, 9, num_threads);
-    bool sequential10 = should_launch_task(20, total_steps, steps_left, start_index, 10, num_threads);
-    bool sequential11 = should_launch_task(20, total_steps, steps_left, start_index, 11, num_threads);
-    bool sequential12 = should_launch_task(20, total_steps, steps_left, start_index, 12, num_threads);
-    bool sequential13 = should_launch_task(20, total_steps, steps_left, start_index, 13, num_threads);
-    bool sequential14 = should_launch_task(20, total_steps, steps_left, start_index, 14, num_threads);
-    bool sequential15 = should_launch_task(20, total_steps, steps_left, start_index, 15, num_threads);
-    bool sequential16 = should_launch_task(20, total_steps, steps_left, start_index, 16, num_threads);
-    bool sequential17 = should_launch_task(20, total_steps, steps_left, start_index, 17, num_threads);
-    bool sequential18 = should_launch_task(20, total_steps, steps_left, start_index, 18, num_threads);
-    bool sequential19 = should_launch_task(20, total_steps, steps_left, start_index, 19, num_threads);
-    bool sequential20 = should_launch_task(20, total_steps, steps_left, start_index, 20, num_threads);
+    const TaskSchedule& schedule = locker.schedule() != NULL ? *locker.schedule() : TaskSchedule::Get(20, total_steps, num_threads);
+    const int level = total_steps - steps_left;
+    bool sequential1 = schedule.launch(level, start_index, 1);
+    bool sequential2 = schedule.launch(level, start_index, 2);
+    bool sequential3 = schedule.launch(level, start_index, 3);
+    bool sequential4 = schedule.launch(level, start_index, 4);
+    bool sequential5 = schedule.launch(level, start_index, 5);
+    bool sequential6 = schedule.launch(level, start_index, 6);
+    bool sequential7 = schedule.launch(level, start_index, 7);
+    bool sequential8 = schedule.launch(level, start_index, 8);
+    bool sequential9 = schedule.launch(level, start_index, 9);
+    bool sequential10 = schedule.launch(level, start_index, 10);
+    bool sequential11 = schedule.launch(level, start_index, 11);
+    bool sequential12 = schedule.launch(level, start_index, 12);
+    bool sequential13 = schedule.launch(level, start_index, 13);
+    bool sequential14 = schedule.launch(level, start_index, 14);
+    bool sequential15 = schedule.launch(level, start_index, 15);
+    bool sequential16 = schedule.launch(level, start_index, 16);
+    bool sequential17 = schedule.launch(level, start_index, 17);
+    bool sequential18 = schedule.launch(level, start_index, 18);
+    bool sequential19 = schedule.launch(level, start_index, 19);
+    bool sequential20 = schedule.launch(level, start_index, 20);
 #else
     bool sequential1 = false;
     bool sequential2 = false;
@@ -1133,689 +505,869 @@ void FastMatmulRecursive(LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr
     bool sequential20 = false;
 #endif
 
+    // Handle edge cases with dynamic peeling.  The update for the inner
+    // dimension goes first, and the output additions add to it.
+    bool peel_tasks = sequential1;
+    PeelFringe(A, B, C, 2, 4, 3, beta, peel_tasks);
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    // Each block of C is summed by whichever task finishes its last input, while
+    // the other multiplies still run (see InputCountdown).
+    InputCountdown C11_inputs(10);
+    InputCountdown C12_inputs(11);
+    InputCountdown C13_inputs(7);
+    InputCountdown C21_inputs(8);
+    InputCountdown C22_inputs(13);
+    InputCountdown C23_inputs(8);
+    auto add_C11 = [&](bool sequential) {
+        if (C11_inputs.Ready()) {
+            M_Add1(M1, M6, M9, M12, M14, M16, M17, M18, M20, C11, x, sequential, beta);
+        }
+    };
+    auto add_C12 = [&](bool sequential) {
+        if (C12_inputs.Ready()) {
+            M_Add2(M1, M4, M5, M8, M11, M16, M17, M18, M19, M20, C12, x, sequential, beta);
+        }
+    };
+    auto add_C13 = [&](bool sequential) {
+        if (C13_inputs.Ready()) {
+            M_Add3(M3, M4, M5, M8, M17, M19, C13, x, sequential, beta);
+        }
+    };
+    auto add_C21 = [&](bool sequential) {
+        if (C21_inputs.Ready()) {
+            M_Add4(M7, M9, M12, M13, M17, M18, M20, C21, x, sequential, beta);
+        }
+    };
+    auto add_C22 = [&](bool sequential) {
+        if (C22_inputs.Ready()) {
+            M_Add5(M2, M4, M5, M6, M7, M10, M11, M12, M13, M17, M18, M20, C22, x, sequential, beta);
+        }
+    };
+    auto add_C23 = [&](bool sequential) {
+        if (C23_inputs.Ready()) {
+            M_Add6(M2, M5, M7, M12, M15, M17, M18, C23, x, sequential, beta);
+        }
+    };
+    beta = PeelInnerDimension(A, B, C, 2, 4, 3, beta, peel_tasks, [&] {
+        add_C11(peel_tasks);
+        add_C12(peel_tasks);
+        add_C13(peel_tasks);
+        add_C21(peel_tasks);
+        add_C22(peel_tasks);
+        add_C23(peel_tasks);
+    });
+#else
+    beta = PeelInnerDimension(A, B, C, 2, 4, 3, beta, peel_tasks);
+#endif
+
 
 
     // M1 = (-1 * A11 + -1 * A12 + -1 * A21 + -1 * A22) * (1 * B11)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential1) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential1, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S1(A11.m(), A11.n());
+    Matrix<Scalar> S1 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add1(A11, A12, A21, A22, S1, x, sequential1);
     M1.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, S1, B11, M1, total_steps, steps_left - 1, (start_index + 1 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 1));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S1, B11, M1, total_steps, steps_left - 1, (start_index + 1 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S1.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential1);
+    add_C12(sequential1);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 1, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 1)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 1) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M2 = (-1 * A22 + -1 * A23) * (1 * B21 + 1 * B22)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential2) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential2, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S2(A11.m(), A11.n());
+    Matrix<Scalar> S2 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add2(A22, A23, S2, x, sequential2);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T2(B11.m(), B11.n());
+    Matrix<Scalar> T2 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add2(B21, B22, T2, x, sequential2);
-    FastMatmulRecursive(locker, mem_mngr, S2, T2, M2, total_steps, steps_left - 1, (start_index + 2 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 2));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S2, T2, M2, total_steps, steps_left - 1, (start_index + 2 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S2.deallocate();
     T2.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C22(sequential2);
+    add_C23(sequential2);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 2, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 2)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 2) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M3 = (-1 * A11) * (1 * B11 + 1 * B12 + 1 * B13)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential3) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential3, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> T3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T3(B11.m(), B11.n());
+    Matrix<Scalar> T3 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add3(B11, B12, B13, T3, x, sequential3);
     M3.UpdateMultiplier(Scalar(-1));
-    FastMatmulRecursive(locker, mem_mngr, A11, T3, M3, total_steps, steps_left - 1, (start_index + 3 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 3));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A11, T3, M3, total_steps, steps_left - 1, (start_index + 3 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     T3.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C13(sequential3);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 3, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 3)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 3) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M4 = (-1 * A14 + -1 * A21 + -1 * A24) * (-1 * B11 + -1 * B12 + -1 * B43)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential4) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential4, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S4(A11.m(), A11.n());
+    Matrix<Scalar> S4 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add4(A14, A21, A24, S4, x, sequential4);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T4(B11.m(), B11.n());
+    Matrix<Scalar> T4 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add4(B11, B12, B43, T4, x, sequential4);
-    FastMatmulRecursive(locker, mem_mngr, S4, T4, M4, total_steps, steps_left - 1, (start_index + 4 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 4));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S4, T4, M4, total_steps, steps_left - 1, (start_index + 4 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S4.deallocate();
     T4.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential4);
+    add_C13(sequential4);
+    add_C22(sequential4);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 4, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 4)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 4) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M5 = (1 * A21 + 1 * A24) * (-1 * B43)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential5) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential5, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S5(A11.m(), A11.n());
+    Matrix<Scalar> S5 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add5(A21, A24, S5, x, sequential5);
     M5.UpdateMultiplier(Scalar(-1));
-    FastMatmulRecursive(locker, mem_mngr, S5, B43, M5, total_steps, steps_left - 1, (start_index + 5 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 5));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S5, B43, M5, total_steps, steps_left - 1, (start_index + 5 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S5.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential5);
+    add_C13(sequential5);
+    add_C22(sequential5);
+    add_C23(sequential5);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 5, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 5)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 5) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M6 = (-1 * A14 + 1 * A23) * (1 * B32 + 1 * B33 + -1 * B41)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential6) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential6, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S6(A11.m(), A11.n());
+    Matrix<Scalar> S6 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add6(A14, A23, S6, x, sequential6);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T6(B11.m(), B11.n());
+    Matrix<Scalar> T6 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add6(B32, B33, B41, T6, x, sequential6);
-    FastMatmulRecursive(locker, mem_mngr, S6, T6, M6, total_steps, steps_left - 1, (start_index + 6 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 6));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S6, T6, M6, total_steps, steps_left - 1, (start_index + 6 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S6.deallocate();
     T6.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential6);
+    add_C22(sequential6);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 6, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 6)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 6) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M7 = (-1 * A12 + -1 * A22) * (1 * B11 + -1 * B21)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential7) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential7, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S7(A11.m(), A11.n());
+    Matrix<Scalar> S7 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add7(A12, A22, S7, x, sequential7);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T7(B11.m(), B11.n());
+    Matrix<Scalar> T7 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add7(B11, B21, T7, x, sequential7);
-    FastMatmulRecursive(locker, mem_mngr, S7, T7, M7, total_steps, steps_left - 1, (start_index + 7 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 7));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S7, T7, M7, total_steps, steps_left - 1, (start_index + 7 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S7.deallocate();
     T7.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C21(sequential7);
+    add_C22(sequential7);
+    add_C23(sequential7);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 7, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 7)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 7) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M8 = (1 * A12 + 1 * A13) * (1 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential8) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential8, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S8(A11.m(), A11.n());
+    Matrix<Scalar> S8 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add8(A12, A13, S8, x, sequential8);
     M8.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, S8, B33, M8, total_steps, steps_left - 1, (start_index + 8 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 8));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S8, B33, M8, total_steps, steps_left - 1, (start_index + 8 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S8.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential8);
+    add_C13(sequential8);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 8, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 8)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 8) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M9 = (-1 * A23) * (1 * B21 + 1 * B22 + -1 * B31 + 1 * B33 + 1 * B41)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential9) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential9, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> T9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T9(B11.m(), B11.n());
+    Matrix<Scalar> T9 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add9(B21, B22, B31, B33, B41, T9, x, sequential9);
     M9.UpdateMultiplier(Scalar(-1));
-    FastMatmulRecursive(locker, mem_mngr, A23, T9, M9, total_steps, steps_left - 1, (start_index + 9 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 9));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A23, T9, M9, total_steps, steps_left - 1, (start_index + 9 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     T9.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential9);
+    add_C21(sequential9);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 9, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 9)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 9) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M10 = (1 * A14 + 1 * A24) * (-1 * B11 + -1 * B12 + -1 * B41 + 1 * B42)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential10) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential10, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S10(A11.m(), A11.n());
+    Matrix<Scalar> S10 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add10(A14, A24, S10, x, sequential10);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T10(B11.m(), B11.n());
+    Matrix<Scalar> T10 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add10(B11, B12, B41, B42, T10, x, sequential10);
-    FastMatmulRecursive(locker, mem_mngr, S10, T10, M10, total_steps, steps_left - 1, (start_index + 10 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 10));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S10, T10, M10, total_steps, steps_left - 1, (start_index + 10 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S10.deallocate();
     T10.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C22(sequential10);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 10, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 10)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 10) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M11 = (-1 * A14) * (-1 * B32 + -1 * B33 + 1 * B42 + 1 * B43)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential11) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential11, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> T11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T11(B11.m(), B11.n());
+    Matrix<Scalar> T11 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add11(B32, B33, B42, B43, T11, x, sequential11);
     M11.UpdateMultiplier(Scalar(-1));
-    FastMatmulRecursive(locker, mem_mngr, A14, T11, M11, total_steps, steps_left - 1, (start_index + 11 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 11));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A14, T11, M11, total_steps, steps_left - 1, (start_index + 11 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     T11.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential11);
+    add_C22(sequential11);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 11, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 11)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 11) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M12 = (1 * A12 + -1 * A23) * (-1 * B21 + -1 * B22 + -1 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential12) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential12, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S12(A11.m(), A11.n());
+    Matrix<Scalar> S12 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add12(A12, A23, S12, x, sequential12);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T12(B11.m(), B11.n());
+    Matrix<Scalar> T12 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add12(B21, B22, B33, T12, x, sequential12);
-    FastMatmulRecursive(locker, mem_mngr, S12, T12, M12, total_steps, steps_left - 1, (start_index + 12 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 12));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S12, T12, M12, total_steps, steps_left - 1, (start_index + 12 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S12.deallocate();
     T12.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential12);
+    add_C21(sequential12);
+    add_C22(sequential12);
+    add_C23(sequential12);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 12, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 12)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 12) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M13 = (1 * A23 + 1 * A24) * (1 * B41)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential13) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential13, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S13(A11.m(), A11.n());
+    Matrix<Scalar> S13 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add13(A23, A24, S13, x, sequential13);
     M13.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, S13, B41, M13, total_steps, steps_left - 1, (start_index + 13 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 13));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S13, B41, M13, total_steps, steps_left - 1, (start_index + 13 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S13.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C21(sequential13);
+    add_C22(sequential13);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 13, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 13)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 13) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M14 = (1 * A13 + 1 * A23) * (-1 * B31 + 1 * B32 + 1 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential14) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential14, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S14(A11.m(), A11.n());
+    Matrix<Scalar> S14 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add14(A13, A23, S14, x, sequential14);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T14(B11.m(), B11.n());
+    Matrix<Scalar> T14 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add14(B31, B32, B33, T14, x, sequential14);
-    FastMatmulRecursive(locker, mem_mngr, S14, T14, M14, total_steps, steps_left - 1, (start_index + 14 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 14));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S14, T14, M14, total_steps, steps_left - 1, (start_index + 14 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S14.deallocate();
     T14.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential14);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 14, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 14)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 14) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M15 = (1 * A21) * (-1 * B11 + 1 * B13 + -1 * B22 + -1 * B23 + -1 * B43)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential15) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential15, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> T15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T15(B11.m(), B11.n());
+    Matrix<Scalar> T15 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add15(B11, B13, B22, B23, B43, T15, x, sequential15);
     M15.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A21, T15, M15, total_steps, steps_left - 1, (start_index + 15 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 15));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A21, T15, M15, total_steps, steps_left - 1, (start_index + 15 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     T15.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C23(sequential15);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 15, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 15)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 15) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M16 = (-1 * A13 + -1 * A14) * (1 * B32 + 1 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential16) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential16, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S16(A11.m(), A11.n());
+    Matrix<Scalar> S16 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add16(A13, A14, S16, x, sequential16);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T16(B11.m(), B11.n());
+    Matrix<Scalar> T16 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add16(B32, B33, T16, x, sequential16);
-    FastMatmulRecursive(locker, mem_mngr, S16, T16, M16, total_steps, steps_left - 1, (start_index + 16 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 16));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S16, T16, M16, total_steps, steps_left - 1, (start_index + 16 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S16.deallocate();
     T16.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential16);
+    add_C12(sequential16);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 16, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 16)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 16) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M17 = (1 * A12) * (-1 * B23 + 1 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential17) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential17, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> T17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T17(B11.m(), B11.n());
+    Matrix<Scalar> T17 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add17(B23, B33, T17, x, sequential17);
     M17.UpdateMultiplier(Scalar(1));
-    FastMatmulRecursive(locker, mem_mngr, A12, T17, M17, total_steps, steps_left - 1, (start_index + 17 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 17));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, A12, T17, M17, total_steps, steps_left - 1, (start_index + 17 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     T17.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential17);
+    add_C12(sequential17);
+    add_C13(sequential17);
+    add_C21(sequential17);
+    add_C22(sequential17);
+    add_C23(sequential17);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 17, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 17)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 17) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M18 = (1 * A12 + 1 * A21 + 1 * A22) * (-1 * B11 + -1 * B22 + -1 * B23)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential18) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential18, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S18(A11.m(), A11.n());
+    Matrix<Scalar> S18 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add18(A12, A21, A22, S18, x, sequential18);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T18(B11.m(), B11.n());
+    Matrix<Scalar> T18 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add18(B11, B22, B23, T18, x, sequential18);
-    FastMatmulRecursive(locker, mem_mngr, S18, T18, M18, total_steps, steps_left - 1, (start_index + 18 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 18));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S18, T18, M18, total_steps, steps_left - 1, (start_index + 18 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S18.deallocate();
     T18.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential18);
+    add_C12(sequential18);
+    add_C21(sequential18);
+    add_C22(sequential18);
+    add_C23(sequential18);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 18, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 18)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 18) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M19 = (-1 * A11 + -1 * A14 + -1 * A21 + -1 * A24) * (1 * B11 + 1 * B12)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential19) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential19, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S19(A11.m(), A11.n());
+    Matrix<Scalar> S19 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add19(A11, A14, A21, A24, S19, x, sequential19);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T19(B11.m(), B11.n());
+    Matrix<Scalar> T19 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add19(B11, B12, T19, x, sequential19);
-    FastMatmulRecursive(locker, mem_mngr, S19, T19, M19, total_steps, steps_left - 1, (start_index + 19 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 19));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S19, T19, M19, total_steps, steps_left - 1, (start_index + 19 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S19.deallocate();
     T19.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential19);
+    add_C13(sequential19);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 19, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 19)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 19) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M20 = (-1 * A21 + -1 * A22) * (1 * B22 + 1 * B23)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential20) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential20, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S20(A11.m(), A11.n());
+    Matrix<Scalar> S20 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add20(A21, A22, S20, x, sequential20);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T20(B11.m(), B11.n());
+    Matrix<Scalar> T20 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add20(B22, B23, T20, x, sequential20);
-    FastMatmulRecursive(locker, mem_mngr, S20, T20, M20, total_steps, steps_left - 1, (start_index + 20 - 1) * 20, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 20));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S20, T20, M20, total_steps, steps_left - 1, (start_index + 20 - 1) * 20, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S20.deallocate();
     T20.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential20);
+    add_C12(sequential20);
+    add_C21(sequential20);
+    add_C22(sequential20);
 locker.Decrement();
-    }
-    if (should_task_wait(20, total_steps, steps_left, start_index, 20, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 20)) {
+        TaskWait();
     }
 #endif
 
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    if (peel_tasks) {
+        TaskWait();
+    }
+#endif
+#if !defined(_PARALLEL_) || (_PARALLEL_ != _BFS_PAR_ && _PARALLEL_ != _HYBRID_PAR_)
     M_Add1(M1, M6, M9, M12, M14, M16, M17, M18, M20, C11, x, false, beta);
     M_Add2(M1, M4, M5, M8, M11, M16, M17, M18, M19, M20, C12, x, false, beta);
     M_Add3(M3, M4, M5, M8, M17, M19, C13, x, false, beta);
     M_Add4(M7, M9, M12, M13, M17, M18, M20, C21, x, false, beta);
     M_Add5(M2, M4, M5, M6, M7, M10, M11, M12, M13, M17, M18, M20, C22, x, false, beta);
     M_Add6(M2, M5, M7, M12, M15, M17, M18, C23, x, false, beta);
-
-    // Handle edge cases with dynamic peeling
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-    if (total_steps == steps_left) {
-        mkl_set_num_threads_local(num_threads);
-        mkl_set_dynamic(0);
-    }
 #endif
-    DynamicPeeling(A, B, C, 2, 4, 3, beta);
+}
+
+// Base case, rank, and temporaries of one step of the algorithm
+inline LevelShape Shape() {
+    return LevelShape(2, 4, 3, 20, 0, 0, 0,
+            {true, true, false, true, true, true, true, true, false, true, false, true, true, true, false, true, false, true, true, true},
+            {false, true, true, true, false, true, true, false, true, true, true, true, false, true, true, true, true, true, true, true});
+}
+
+// Plan for multiplying a num_rows_A x num_cols_A matrix with a num_cols_A x num_cols_B matrix
+template <typename Scalar>
+FastMatmulPlan<Scalar> MakePlan(int num_rows_A, int num_cols_A, int num_cols_B, int num_steps, double x=1e-8) {
+    return FastMatmulPlan<Scalar>(FastMatmulRecursive<Scalar>, Shape(), num_rows_A, num_cols_A, num_cols_B, num_steps, x);
 }
 
 // C := alpha * A * B + beta * C
 template <typename Scalar>
 double FastMatmul(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C,
     int num_steps, double x=1e-8, Scalar alpha=Scalar(1.0), Scalar beta=Scalar(0.0)) {
-    MemoryManager<Scalar> mem_mngr;
-#ifdef _PARALLEL_
-    mem_mngr.Allocate(2, 4, 3, 20, num_steps, A.m(), A.n(), B.n());
-#endif
-    A.set_multiplier(alpha);
-    int num_multiplies_per_step = 20;
-    int total_multiplies = pow(num_multiplies_per_step, num_steps);
-
-    // Set parameters needed for all types of parallelism.
-    int num_threads = 0;
-#ifdef _PARALLEL_
-# pragma omp parallel
-    {
-        if (omp_get_thread_num() == 0) { num_threads = omp_get_num_threads(); }
-    }
-    omp_set_nested(1);
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_)
-# pragma omp parallel
-    {
-        mkl_set_num_threads_local(1);
-        mkl_set_dynamic(0);
-    }
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _DFS_PAR_)
-    mkl_set_dynamic(0);
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    if (num_threads > total_multiplies) {
-        mkl_set_dynamic(0);
-    } else {
-# pragma omp parallel
-        {
-            mkl_set_num_threads_local(1);
-            mkl_set_dynamic(0);
-        }
-    }
-#endif
-
-    LockAndCounter locker(total_multiplies - (total_multiplies % num_threads));
-    using FpMilliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
-    auto t1 = std::chrono::high_resolution_clock::now();
-
-#ifdef _PARALLEL_
-# pragma omp parallel
-    {
-# pragma omp single
-#endif
-        FastMatmulRecursive(locker, mem_mngr, A, B, C, num_steps, num_steps, 0, x, num_threads, beta);
-#ifdef _PARALLEL_
-    }
-#endif
-    auto t2 = std::chrono::high_resolution_clock::now();
-    return FpMilliseconds(t2 - t1).count();
+    FastMatmulPlan<Scalar> plan = MakePlan<Scalar>(A.m(), A.n(), B.n(), num_steps, x);
+    return plan.Execute(A, B, C, alpha, beta);
 }
 
 }  // namespace grey243_20_144
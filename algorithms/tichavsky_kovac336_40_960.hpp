@@ -8,3492 +8,786 @@ namespace tichavsky_kovac336_40_960 {
 
 template <typename Scalar>
 void S_Add1(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(-.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add2(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4] + Scalar(-.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add3(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add4(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add5(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4] + Scalar(-.5) * dataS5[i + j * strideS5] + Scalar(-.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add6(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4] + Scalar(-.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add7(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(-.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add8(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add9(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(-.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add10(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(-.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add11(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add12(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(-.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add13(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(-.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add14(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(-.5) * dataS5[i + j * strideS5] + Scalar(-.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add15(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add16(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& S5, Matrix<Scalar>& S6, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideS5 = S5.stride();
-    const int strideS6 = S6.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    const Scalar *dataS5 = S5.data();
-    const Scalar *dataS6 = S6.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4] + Scalar(.5) * dataS5[i + j * strideS5] + Scalar(.5) * dataS6[i + j * strideS6];
-        }
-    }
+    const Scalar *data[6] = {S1.data(), S2.data(), S3.data(), S4.data(), S5.data(), S6.data()};
+    const int strides[6] = {S1.stride(), S2.stride(), S3.stride(), S4.stride(), S5.stride(), S6.stride()};
+    const Scalar coeffs[6] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 6>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add17(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add18(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add19(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add20(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add21(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add22(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add23(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add24(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add25(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add26(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add27(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add28(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add29(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add30(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add31(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add32(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(-.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add33(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add34(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add35(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add36(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add37(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(-.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add38(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add39(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void S_Add40(Matrix<Scalar>& S1, Matrix<Scalar>& S2, Matrix<Scalar>& S3, Matrix<Scalar>& S4, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideS1 = S1.stride();
-    const int strideS2 = S2.stride();
-    const int strideS3 = S3.stride();
-    const int strideS4 = S4.stride();
-    const int strideC = C.stride();
-    const Scalar *dataS1 = S1.data();
-    const Scalar *dataS2 = S2.data();
-    const Scalar *dataS3 = S3.data();
-    const Scalar *dataS4 = S4.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataS1[i + j * strideS1] + Scalar(-.5) * dataS2[i + j * strideS2] + Scalar(.5) * dataS3[i + j * strideS3] + Scalar(.5) * dataS4[i + j * strideS4];
-        }
-    }
+    const Scalar *data[4] = {S1.data(), S2.data(), S3.data(), S4.data()};
+    const int strides[4] = {S1.stride(), S2.stride(), S3.stride(), S4.stride()};
+    const Scalar coeffs[4] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 4>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add1(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add2(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add3(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add4(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add5(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add6(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add7(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add8(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add9(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add10(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add11(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add12(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add13(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add14(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add15(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add16(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9];
-        }
-    }
+    const Scalar *data[9] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data()};
+    const int strides[9] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride()};
+    const Scalar coeffs[9] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 9>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add17(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add18(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add19(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add20(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add21(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add22(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add23(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add24(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add25(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add26(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add27(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add28(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add29(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add30(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add31(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add32(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add33(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add34(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add35(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add36(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(-.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(-.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add37(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add38(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(-.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add39(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(-.5) * dataT3[i + j * strideT3] + Scalar(.5) * dataT4[i + j * strideT4] + Scalar(.5) * dataT5[i + j * strideT5] + Scalar(-.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(.5) * dataT8[i + j * strideT8] + Scalar(.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void T_Add40(Matrix<Scalar>& T1, Matrix<Scalar>& T2, Matrix<Scalar>& T3, Matrix<Scalar>& T4, Matrix<Scalar>& T5, Matrix<Scalar>& T6, Matrix<Scalar>& T7, Matrix<Scalar>& T8, Matrix<Scalar>& T9, Matrix<Scalar>& T10, Matrix<Scalar>& C, double x, bool sequential) {
-    const int strideT1 = T1.stride();
-    const int strideT2 = T2.stride();
-    const int strideT3 = T3.stride();
-    const int strideT4 = T4.stride();
-    const int strideT5 = T5.stride();
-    const int strideT6 = T6.stride();
-    const int strideT7 = T7.stride();
-    const int strideT8 = T8.stride();
-    const int strideT9 = T9.stride();
-    const int strideT10 = T10.stride();
-    const int strideC = C.stride();
-    const Scalar *dataT1 = T1.data();
-    const Scalar *dataT2 = T2.data();
-    const Scalar *dataT3 = T3.data();
-    const Scalar *dataT4 = T4.data();
-    const Scalar *dataT5 = T5.data();
-    const Scalar *dataT6 = T6.data();
-    const Scalar *dataT7 = T7.data();
-    const Scalar *dataT8 = T8.data();
-    const Scalar *dataT9 = T9.data();
-    const Scalar *dataT10 = T10.data();
-    Scalar *dataC = C.data();
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-    for (int j = 0; j < C.n(); ++j) {
-        for (int i = 0; i < C.m(); ++i) {
-            dataC[i + j * strideC] = Scalar(-.5) * dataT1[i + j * strideT1] + Scalar(.5) * dataT2[i + j * strideT2] + Scalar(.5) * dataT3[i + j * strideT3] + Scalar(-.5) * dataT4[i + j * strideT4] + Scalar(-.5) * dataT5[i + j * strideT5] + Scalar(.5) * dataT6[i + j * strideT6] + Scalar(.5) * dataT7[i + j * strideT7] + Scalar(-.5) * dataT8[i + j * strideT8] + Scalar(-.5) * dataT9[i + j * strideT9] + Scalar(.5) * dataT10[i + j * strideT10];
-        }
-    }
+    const Scalar *data[10] = {T1.data(), T2.data(), T3.data(), T4.data(), T5.data(), T6.data(), T7.data(), T8.data(), T9.data(), T10.data()};
+    const int strides[10] = {T1.stride(), T2.stride(), T3.stride(), T4.stride(), T5.stride(), T6.stride(), T7.stride(), T8.stride(), T9.stride(), T10.stride()};
+    const Scalar coeffs[10] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 10>(data, strides, coeffs, C, sequential);
 }
 
 template <typename Scalar>
 void M_Add1(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(-.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(-.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(-.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(-.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add2(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(-.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(-.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add3(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(-.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(-.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add4(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(-.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(-.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16];
-            }
-        }
-    }
+    const Scalar *data[16] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data()};
+    const int strides[16] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride()};
+    const Scalar coeffs[16] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 16>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add5(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(-.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(-.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(-.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(-.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add6(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16];
-            }
-        }
-    }
+    const Scalar *data[16] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data()};
+    const int strides[16] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride()};
+    const Scalar coeffs[16] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    MultiAdd<Scalar, 16>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add7(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(-.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(-.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(-.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(-.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add8(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16];
-            }
-        }
-    }
+    const Scalar *data[16] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data()};
+    const int strides[16] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride()};
+    const Scalar coeffs[16] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 16>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add9(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16];
-            }
-        }
-    }
+    const Scalar *data[16] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data()};
+    const int strides[16] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride()};
+    const Scalar coeffs[16] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 16>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add10(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(-.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(-.5) * dataM17[i + j * strideM17] + Scalar(-.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(-.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(-.5) * dataM17[i + j * strideM17] + Scalar(-.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add11(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(-.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(-.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add12(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(-.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(-.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add13(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16];
-            }
-        }
-    }
+    const Scalar *data[16] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data()};
+    const int strides[16] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride()};
+    const Scalar coeffs[16] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5)};
+    MultiAdd<Scalar, 16>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add14(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(-.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(-.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(.5) * dataM20[i + j * strideM20] + Scalar(.5) * dataM21[i + j * strideM21] + Scalar(.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add15(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(-.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(-.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(-.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(-.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(.5) * dataM10[i + j * strideM10] + Scalar(-.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(-.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(-.5) * dataM22[i + j * strideM22] + Scalar(.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add16(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(-.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(-.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(-.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(-.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(.5) * dataM18[i + j * strideM18] + Scalar(.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(-.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add17(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(-.5) * dataM3[i + j * strideM3] + Scalar(-.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(-.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(-.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(.5) * dataM16[i + j * strideM16];
-            }
-        }
-    }
+    const Scalar *data[16] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data()};
+    const int strides[16] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride()};
+    const Scalar coeffs[16] = {Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5)};
+    MultiAdd<Scalar, 16>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
 void M_Add18(Matrix<Scalar>& M1, Matrix<Scalar>& M2, Matrix<Scalar>& M3, Matrix<Scalar>& M4, Matrix<Scalar>& M5, Matrix<Scalar>& M6, Matrix<Scalar>& M7, Matrix<Scalar>& M8, Matrix<Scalar>& M9, Matrix<Scalar>& M10, Matrix<Scalar>& M11, Matrix<Scalar>& M12, Matrix<Scalar>& M13, Matrix<Scalar>& M14, Matrix<Scalar>& M15, Matrix<Scalar>& M16, Matrix<Scalar>& M17, Matrix<Scalar>& M18, Matrix<Scalar>& M19, Matrix<Scalar>& M20, Matrix<Scalar>& M21, Matrix<Scalar>& M22, Matrix<Scalar>& M23, Matrix<Scalar>& M24, Matrix<Scalar>& C, double x, bool sequential, Scalar beta) {
-    const int strideM1 = M1.stride();
-    const int strideM2 = M2.stride();
-    const int strideM3 = M3.stride();
-    const int strideM4 = M4.stride();
-    const int strideM5 = M5.stride();
-    const int strideM6 = M6.stride();
-    const int strideM7 = M7.stride();
-    const int strideM8 = M8.stride();
-    const int strideM9 = M9.stride();
-    const int strideM10 = M10.stride();
-    const int strideM11 = M11.stride();
-    const int strideM12 = M12.stride();
-    const int strideM13 = M13.stride();
-    const int strideM14 = M14.stride();
-    const int strideM15 = M15.stride();
-    const int strideM16 = M16.stride();
-    const int strideM17 = M17.stride();
-    const int strideM18 = M18.stride();
-    const int strideM19 = M19.stride();
-    const int strideM20 = M20.stride();
-    const int strideM21 = M21.stride();
-    const int strideM22 = M22.stride();
-    const int strideM23 = M23.stride();
-    const int strideM24 = M24.stride();
-    const int strideC = C.stride();
-    const Scalar *dataM1 = M1.data();
-    const Scalar *dataM2 = M2.data();
-    const Scalar *dataM3 = M3.data();
-    const Scalar *dataM4 = M4.data();
-    const Scalar *dataM5 = M5.data();
-    const Scalar *dataM6 = M6.data();
-    const Scalar *dataM7 = M7.data();
-    const Scalar *dataM8 = M8.data();
-    const Scalar *dataM9 = M9.data();
-    const Scalar *dataM10 = M10.data();
-    const Scalar *dataM11 = M11.data();
-    const Scalar *dataM12 = M12.data();
-    const Scalar *dataM13 = M13.data();
-    const Scalar *dataM14 = M14.data();
-    const Scalar *dataM15 = M15.data();
-    const Scalar *dataM16 = M16.data();
-    const Scalar *dataM17 = M17.data();
-    const Scalar *dataM18 = M18.data();
-    const Scalar *dataM19 = M19.data();
-    const Scalar *dataM20 = M20.data();
-    const Scalar *dataM21 = M21.data();
-    const Scalar *dataM22 = M22.data();
-    const Scalar *dataM23 = M23.data();
-    const Scalar *dataM24 = M24.data();
-    Scalar *dataC = C.data();
-    if (beta != Scalar(0.0)) {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(-.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(-.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24] + beta * dataC[i + j * strideC];
-            }
-        }
-    } else {
-#ifdef _PARALLEL_
-# pragma omp parallel for if(!sequential)
-#endif
-        for (int j = 0; j < C.n(); ++j) {
-            for (int i = 0; i < C.m(); ++i) {
-                dataC[i + j * strideC] = Scalar(-.5) * dataM1[i + j * strideM1] + Scalar(.5) * dataM2[i + j * strideM2] + Scalar(.5) * dataM3[i + j * strideM3] + Scalar(.5) * dataM4[i + j * strideM4] + Scalar(-.5) * dataM5[i + j * strideM5] + Scalar(.5) * dataM6[i + j * strideM6] + Scalar(-.5) * dataM7[i + j * strideM7] + Scalar(.5) * dataM8[i + j * strideM8] + Scalar(.5) * dataM9[i + j * strideM9] + Scalar(-.5) * dataM10[i + j * strideM10] + Scalar(.5) * dataM11[i + j * strideM11] + Scalar(.5) * dataM12[i + j * strideM12] + Scalar(.5) * dataM13[i + j * strideM13] + Scalar(-.5) * dataM14[i + j * strideM14] + Scalar(-.5) * dataM15[i + j * strideM15] + Scalar(-.5) * dataM16[i + j * strideM16] + Scalar(.5) * dataM17[i + j * strideM17] + Scalar(-.5) * dataM18[i + j * strideM18] + Scalar(-.5) * dataM19[i + j * strideM19] + Scalar(-.5) * dataM20[i + j * strideM20] + Scalar(-.5) * dataM21[i + j * strideM21] + Scalar(-.5) * dataM22[i + j * strideM22] + Scalar(-.5) * dataM23[i + j * strideM23] + Scalar(-.5) * dataM24[i + j * strideM24];
-            }
-        }
-    }
+    const Scalar *data[24] = {M1.data(), M2.data(), M3.data(), M4.data(), M5.data(), M6.data(), M7.data(), M8.data(), M9.data(), M10.data(), M11.data(), M12.data(), M13.data(), M14.data(), M15.data(), M16.data(), M17.data(), M18.data(), M19.data(), M20.data(), M21.data(), M22.data(), M23.data(), M24.data()};
+    const int strides[24] = {M1.stride(), M2.stride(), M3.stride(), M4.stride(), M5.stride(), M6.stride(), M7.stride(), M8.stride(), M9.stride(), M10.stride(), M11.stride(), M12.stride(), M13.stride(), M14.stride(), M15.stride(), M16.stride(), M17.stride(), M18.stride(), M19.stride(), M20.stride(), M21.stride(), M22.stride(), M23.stride(), M24.stride()};
+    const Scalar coeffs[24] = {Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(.5), Scalar(.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5), Scalar(-.5)};
+    BlockedMultiAdd<Scalar, 24>(data, strides, coeffs, C, sequential, beta);
 }
 
 template <typename Scalar>
@@ -3558,129 +852,131 @@ void FastMatmulRecursive(LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr
 
     // Matrices to store the results of multiplications.
 #ifdef _PARALLEL_
-    Matrix<Scalar> M1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M21(mem_mngr.GetMem(start_index, 21, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M22(mem_mngr.GetMem(start_index, 22, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M23(mem_mngr.GetMem(start_index, 23, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M24(mem_mngr.GetMem(start_index, 24, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M25(mem_mngr.GetMem(start_index, 25, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M26(mem_mngr.GetMem(start_index, 26, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M27(mem_mngr.GetMem(start_index, 27, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M28(mem_mngr.GetMem(start_index, 28, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M29(mem_mngr.GetMem(start_index, 29, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M30(mem_mngr.GetMem(start_index, 30, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M31(mem_mngr.GetMem(start_index, 31, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M32(mem_mngr.GetMem(start_index, 32, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M33(mem_mngr.GetMem(start_index, 33, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M34(mem_mngr.GetMem(start_index, 34, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M35(mem_mngr.GetMem(start_index, 35, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M36(mem_mngr.GetMem(start_index, 36, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M37(mem_mngr.GetMem(start_index, 37, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M38(mem_mngr.GetMem(start_index, 38, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M39(mem_mngr.GetMem(start_index, 39, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M40(mem_mngr.GetMem(start_index, 40, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());
-#else
-    Matrix<Scalar> M1(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M2(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M3(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M4(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M5(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M6(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M7(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M8(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M9(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M10(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M11(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M12(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M13(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M14(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M15(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M16(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M17(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M18(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M19(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M20(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M21(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M22(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M23(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M24(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M25(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M26(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M27(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M28(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M29(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M30(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M31(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M32(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M33(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M34(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M35(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M36(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M37(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M38(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M39(C11.m(), C11.n(), C.multiplier());
-    Matrix<Scalar> M40(C11.m(), C11.n(), C.multiplier());
-#endif
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-    bool sequential1 = should_launch_task(40, total_steps, steps_left, start_index, 1, num_threads);
-    bool sequential2 = should_launch_task(40, total_steps, steps_left, start_index, 2, num_threads);
-    bool sequential3 = should_launch_task(40, total_steps, steps_left, start_index, 3, num_threads);
-    bool sequential4 = should_launch_task(40, total_steps, steps_left, start_index, 4, num_threads);
-    bool sequential5 = should_launch_task(40, total_steps, steps_left, start_index, 5, num_threads);
-    bool sequential6 = should_launch_task(40, total_steps, steps_left, start_index, 6, num_threads);
-    bool sequential7 = should_launch_task(40, total_steps, steps_left, start_index, 7, num_threads);
-    bool sequential8 = should_launch_task(40, total_steps, steps_left, start_index, 8, num_threads);
-    bool sequential9 = should_launch_task(40, total_steps, steps_left, start_index, 9, num_threads);
-    bool sequential10 = should_launch_task(40, total_steps, steps_left, start_index, 10, num_threads);
-    bool sequential11 = should_launch_task(40, total_steps, steps_left, start_index, 11, num_threads);
-    bool sequential12 = should_launch_task(40, total_steps, steps_left, start_index, 12, num_threads);
-    bool sequential13 = should_launch_task(40, total_steps, steps_left, start_index, 13, num_threads);
-    bool sequential14 = should_launch_task(40, total_steps, steps_left, start_index, 14, num_threads);
-    bool sequential15 = should_launch_task(40, total_steps, steps_left, start_index, 15, num_threads);
-    bool sequential16 = should_launch_task(40, total_steps, steps_left, start_index, 16, num_threads);
-    bool sequential17 = should_launch_task(40, total_steps, steps_left, start_index, 17, num_threads);
-    bool sequential18 = should_launch_task(40, total_steps, steps_left, start_index, 18, num_threads);
-    bool sequential19 = should_launch_task(40, total_steps, steps_left, start_index, 19, num_threads);
-    bool sequential20 = should_launch_task(40, total_steps, steps_left, start_index, 20, num_threads);
-    bool sequential21 = should_launch_task(40, total_steps, steps_left, start_index, 21, num_threads);
-    bool sequential22 = should_launch_task(40, total_steps, steps_left, start_index, 22, num_threads);
-    bool sequential23 = should_launch_task(40, total_steps, steps_left, start_index, 23, num_threads);
-    bool sequential24 = should_launch_task(40, total_steps, steps_left, start_index, 24, num_threads);
-    bool sequential25 = should_launch_task(40, total_steps, steps_left, start_index, 25, num_threads);
-    bool sequential26 = should_launch_task(40, total_steps, steps_left, start_index, 26, num_threads);
-    bool sequential27 = should_launch_task(40, total_steps, steps_left, start_index, 27, num_threads);
-    bool sequential28 = should_launch_task(40, total_steps, steps_left, start_index, 28, num_threads);
-    bool sequential29 = should_launch_task(40, total_steps, steps_left, start_index, 29, num_threads);
-    bool sequential30 = should_launch_task(40, total_steps, steps_left, start_index, 30, num_threads);
-    bool sequential31 = should_launch_task(40, total_steps, steps_left, start_index, 31, num_threads);
-    bool sequential32 = should_launch_task(40, total_steps, steps_left, start_index, 32, num_threads);
-    bool sequential33 = should_launch_task(40, total_steps, steps_left, start_index, 33, num_threads);
-    bool sequential34 = should_launch_task(40, total_steps, steps_left, start_index, 34, num_threads);
-    bool sequential35 = should_launch_task(40, total_steps, steps_left, start_index, 35, num_threads);
-    bool sequential36 = should_launch_task(40, total_steps, steps_left, start_index, 36, num_threads);
-    bool sequential37 = should_launch_task(40, total_steps, steps_left, start_index, 37, num_threads);
-    bool sequential38 = should_launch_task(40, total_steps, steps_left, start_index, 38, num_threads);
-    bool sequential39 = should_launch_task(40, total_steps, steps_left, start_index, 39, num_threads);
-    bool sequential40 = should_launch_task(40, total_steps, steps_left, start_index, 40, num_threads);
+    Matrix<Scalar> M1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M21(mem_mngr.GetMem(start_index, 21, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M22(mem_mngr.GetMem(start_index, 22, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M23(mem_mngr.GetMem(start_index, 23, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M24(mem_mngr.GetMem(start_index, 24, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M25(mem_mngr.GetMem(start_index, 25, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M26(mem_mngr.GetMem(start_index, 26, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M27(mem_mngr.GetMem(start_index, 27, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M28(mem_mngr.GetMem(start_index, 28, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M29(mem_mngr.GetMem(start_index, 29, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M30(mem_mngr.GetMem(start_index, 30, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M31(mem_mngr.GetMem(start_index, 31, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M32(mem_mngr.GetMem(start_index, 32, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M33(mem_mngr.GetMem(start_index, 33, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M34(mem_mngr.GetMem(start_index, 34, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M35(mem_mngr.GetMem(start_index, 35, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M36(mem_mngr.GetMem(start_index, 36, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M37(mem_mngr.GetMem(start_index, 37, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M38(mem_mngr.GetMem(start_index, 38, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M39(mem_mngr.GetMem(start_index, 39, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M40(mem_mngr.GetMem(start_index, 40, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());
+#else
+    Matrix<Scalar> M1 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M2 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M3 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M4 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M5 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M6 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M7 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M8 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M9 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M10 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M11 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M12 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M13 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M14 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M15 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M16 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M17 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M18 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M19 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M20 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M21 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M22 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M23 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M24 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M25 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M26 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M27 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M28 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M29 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M30 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M31 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M32 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M33 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M34 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M35 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M36 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M37 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M38 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M39 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+    Matrix<Scalar> M40 = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());
+#endif
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    const TaskSchedule& schedule = locker.schedule() != NULL ? *locker.schedule() : TaskSchedule::Get(40, total_steps, num_threads);
+    const int level = total_steps - steps_left;
+    bool sequential1 = schedule.launch(level, start_index, 1);
+    bool sequential2 = schedule.launch(level, start_index, 2);
+    bool sequential3 = schedule.launch(level, start_index, 3);
+    bool sequential4 = schedule.launch(level, start_index, 4);
+    bool sequential5 = schedule.launch(level, start_index, 5);
+    bool sequential6 = schedule.launch(level, start_index, 6);
+    bool sequential7 = schedule.launch(level, start_index, 7);
+    bool sequential8 = schedule.launch(level, start_index, 8);
+    bool sequential9 = schedule.launch(level, start_index, 9);
+    bool sequential10 = schedule.launch(level, start_index, 10);
+    bool sequential11 = schedule.launch(level, start_index, 11);
+    bool sequential12 = schedule.launch(level, start_index, 12);
+    bool sequential13 = schedule.launch(level, start_index, 13);
+    bool sequential14 = schedule.launch(level, start_index, 14);
+    bool sequential15 = schedule.launch(level, start_index, 15);
+    bool sequential16 = schedule.launch(level, start_index, 16);
+    bool sequential17 = schedule.launch(level, start_index, 17);
+    bool sequential18 = schedule.launch(level, start_index, 18);
+    bool sequential19 = schedule.launch(level, start_index, 19);
+    bool sequential20 = schedule.launch(level, start_index, 20);
+    bool sequential21 = schedule.launch(level, start_index, 21);
+    bool sequential22 = schedule.launch(level, start_index, 22);
+    bool sequential23 = schedule.launch(level, start_index, 23);
+    bool sequential24 = schedule.launch(level, start_index, 24);
+    bool sequential25 = schedule.launch(level, start_index, 25);
+    bool sequential26 = schedule.launch(level, start_index, 26);
+    bool sequential27 = schedule.launch(level, start_index, 27);
+    bool sequential28 = schedule.launch(level, start_index, 28);
+    bool sequential29 = schedule.launch(level, start_index, 29);
+    bool sequential30 = schedule.launch(level, start_index, 30);
+    bool sequential31 = schedule.launch(level, start_index, 31);
+    bool sequential32 = schedule.launch(level, start_index, 32);
+    bool sequential33 = schedule.launch(level, start_index, 33);
+    bool sequential34 = schedule.launch(level, start_index, 34);
+    bool sequential35 = schedule.launch(level, start_index, 35);
+    bool sequential36 = schedule.launch(level, start_index, 36);
+    bool sequential37 = schedule.launch(level, start_index, 37);
+    bool sequential38 = schedule.launch(level, start_index, 38);
+    bool sequential39 = schedule.launch(level, start_index, 39);
+    bool sequential40 = schedule.launch(level, start_index, 40);
 #else
     bool sequential1 = false;
     bool sequential2 = false;
@@ -3724,1325 +1020,2092 @@ void FastMatmulRecursive(LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr
     bool sequential40 = false;
 #endif
 
+    // Handle edge cases with dynamic peeling.  The update for the inner
+    // dimension goes first, and the output additions add to it.
+    bool peel_tasks = sequential1;
+    PeelFringe(A, B, C, 3, 3, 6, beta, peel_tasks);
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    // Each block of C is summed by whichever task finishes its last input, while
+    // the other multiplies still run (see InputCountdown).
+    InputCountdown C11_inputs(25);
+    InputCountdown C12_inputs(25);
+    InputCountdown C13_inputs(25);
+    InputCountdown C14_inputs(17);
+    InputCountdown C15_inputs(25);
+    InputCountdown C16_inputs(17);
+    InputCountdown C21_inputs(25);
+    InputCountdown C22_inputs(17);
+    InputCountdown C23_inputs(17);
+    InputCountdown C24_inputs(25);
+    InputCountdown C25_inputs(25);
+    InputCountdown C26_inputs(25);
+    InputCountdown C31_inputs(17);
+    InputCountdown C32_inputs(25);
+    InputCountdown C33_inputs(25);
+    InputCountdown C34_inputs(25);
+    InputCountdown C35_inputs(17);
+    InputCountdown C36_inputs(25);
+    auto add_C11 = [&](bool sequential) {
+        if (C11_inputs.Ready()) {
+            M_Add1(M1, M2, M4, M5, M8, M12, M13, M16, M17, M18, M19, M20, M21, M22, M25, M26, M33, M34, M35, M36, M37, M38, M39, M40, C11, x, sequential, beta);
+        }
+    };
+    auto add_C12 = [&](bool sequential) {
+        if (C12_inputs.Ready()) {
+            M_Add2(M1, M4, M6, M8, M10, M11, M13, M15, M18, M20, M23, M24, M25, M26, M27, M28, M29, M30, M31, M32, M33, M35, M36, M39, C12, x, sequential, beta);
+        }
+    };
+    auto add_C13 = [&](bool sequential) {
+        if (C13_inputs.Ready()) {
+            M_Add3(M2, M3, M5, M7, M9, M12, M14, M16, M18, M20, M23, M24, M25, M26, M27, M28, M29, M30, M31, M32, M33, M35, M36, M39, C13, x, sequential, beta);
+        }
+    };
+    auto add_C14 = [&](bool sequential) {
+        if (C14_inputs.Ready()) {
+            M_Add4(M2, M5, M6, M10, M11, M12, M15, M16, M18, M20, M25, M26, M33, M35, M36, M39, C14, x, sequential, beta);
+        }
+    };
+    auto add_C15 = [&](bool sequential) {
+        if (C15_inputs.Ready()) {
+            M_Add5(M3, M6, M7, M9, M10, M11, M14, M15, M17, M18, M19, M20, M21, M22, M25, M26, M33, M34, M35, M36, M37, M38, M39, M40, C15, x, sequential, beta);
+        }
+    };
+    auto add_C16 = [&](bool sequential) {
+        if (C16_inputs.Ready()) {
+            M_Add6(M1, M3, M4, M7, M8, M9, M13, M14, M18, M20, M25, M26, M33, M35, M36, M39, C16, x, sequential, beta);
+        }
+    };
+    auto add_C21 = [&](bool sequential) {
+        if (C21_inputs.Ready()) {
+            M_Add7(M1, M2, M4, M5, M8, M12, M13, M16, M17, M18, M19, M20, M21, M22, M25, M26, M33, M34, M35, M36, M37, M38, M39, M40, C21, x, sequential, beta);
+        }
+    };
+    auto add_C22 = [&](bool sequential) {
+        if (C22_inputs.Ready()) {
+            M_Add8(M2, M3, M5, M7, M9, M12, M14, M16, M17, M19, M21, M22, M34, M37, M38, M40, C22, x, sequential, beta);
+        }
+    };
+    auto add_C23 = [&](bool sequential) {
+        if (C23_inputs.Ready()) {
+            M_Add9(M1, M4, M6, M8, M10, M11, M13, M15, M17, M19, M21, M22, M34, M37, M38, M40, C23, x, sequential, beta);
+        }
+    };
+    auto add_C24 = [&](bool sequential) {
+        if (C24_inputs.Ready()) {
+            M_Add10(M1, M3, M4, M7, M8, M9, M13, M14, M17, M19, M21, M22, M23, M24, M27, M28, M29, M30, M31, M32, M34, M37, M38, M40, C24, x, sequential, beta);
+        }
+    };
+    auto add_C25 = [&](bool sequential) {
+        if (C25_inputs.Ready()) {
+            M_Add11(M3, M6, M7, M9, M10, M11, M14, M15, M17, M18, M19, M20, M21, M22, M25, M26, M33, M34, M35, M36, M37, M38, M39, M40, C25, x, sequential, beta);
+        }
+    };
+    auto add_C26 = [&](bool sequential) {
+        if (C26_inputs.Ready()) {
+            M_Add12(M2, M5, M6, M10, M11, M12, M15, M16, M17, M19, M21, M22, M23, M24, M27, M28, M29, M30, M31, M32, M34, M37, M38, M40, C26, x, sequential, beta);
+        }
+    };
+    auto add_C31 = [&](bool sequential) {
+        if (C31_inputs.Ready()) {
+            M_Add13(M3, M6, M7, M9, M10, M11, M14, M15, M23, M24, M27, M28, M29, M30, M31, M32, C31, x, sequential, beta);
+        }
+    };
+    auto add_C32 = [&](bool sequential) {
+        if (C32_inputs.Ready()) {
+            M_Add14(M1, M4, M6, M8, M10, M11, M13, M15, M18, M20, M23, M24, M25, M26, M27, M28, M29, M30, M31, M32, M33, M35, M36, M39, C32, x, sequential, beta);
+        }
+    };
+    auto add_C33 = [&](bool sequential) {
+        if (C33_inputs.Ready()) {
+            M_Add15(M2, M3, M5, M7, M9, M12, M14, M16, M18, M20, M23, M24, M25, M26, M27, M28, M29, M30, M31, M32, M33, M35, M36, M39, C33, x, sequential, beta);
+        }
+    };
+    auto add_C34 = [&](bool sequential) {
+        if (C34_inputs.Ready()) {
+            M_Add16(M1, M3, M4, M7, M8, M9, M13, M14, M17, M19, M21, M22, M23, M24, M27, M28, M29, M30, M31, M32, M34, M37, M38, M40, C34, x, sequential, beta);
+        }
+    };
+    auto add_C35 = [&](bool sequential) {
+        if (C35_inputs.Ready()) {
+            M_Add17(M1, M2, M4, M5, M8, M12, M13, M16, M23, M24, M27, M28, M29, M30, M31, M32, C35, x, sequential, beta);
+        }
+    };
+    auto add_C36 = [&](bool sequential) {
+        if (C36_inputs.Ready()) {
+            M_Add18(M2, M5, M6, M10, M11, M12, M15, M16, M17, M19, M21, M22, M23, M24, M27, M28, M29, M30, M31, M32, M34, M37, M38, M40, C36, x, sequential, beta);
+        }
+    };
+    beta = PeelInnerDimension(A, B, C, 3, 3, 6, beta, peel_tasks, [&] {
+        add_C11(peel_tasks);
+        add_C12(peel_tasks);
+        add_C13(peel_tasks);
+        add_C14(peel_tasks);
+        add_C15(peel_tasks);
+        add_C16(peel_tasks);
+        add_C21(peel_tasks);
+        add_C22(peel_tasks);
+        add_C23(peel_tasks);
+        add_C24(peel_tasks);
+        add_C25(peel_tasks);
+        add_C26(peel_tasks);
+        add_C31(peel_tasks);
+        add_C32(peel_tasks);
+        add_C33(peel_tasks);
+        add_C34(peel_tasks);
+        add_C35(peel_tasks);
+        add_C36(peel_tasks);
+    });
+#else
+    beta = PeelInnerDimension(A, B, C, 3, 3, 6, beta, peel_tasks);
+#endif
+
 
 
     // M1 = (.5 * A11 + .5 * A13 + .5 * A22 + .5 * A23 + -.5 * A31 + .5 * A32) * (-.5 * B12 + .5 * B15 + .5 * B16 + .5 * B23 + .5 * B24 + -.5 * B25 + -.5 * B31 + .5 * B33 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential1) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential1, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S1(A11.m(), A11.n());
+    Matrix<Scalar> S1 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add1(A11, A13, A22, A23, A31, A32, S1, x, sequential1);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T1(mem_mngr.GetMem(start_index, 1, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T1(B11.m(), B11.n());
+    Matrix<Scalar> T1 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add1(B12, B15, B16, B23, B24, B25, B31, B33, B36, T1, x, sequential1);
-    FastMatmulRecursive(locker, mem_mngr, S1, T1, M1, total_steps, steps_left - 1, (start_index + 1 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 1));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S1, T1, M1, total_steps, steps_left - 1, (start_index + 1 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S1.deallocate();
     T1.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential1);
+    add_C12(sequential1);
+    add_C16(sequential1);
+    add_C21(sequential1);
+    add_C23(sequential1);
+    add_C24(sequential1);
+    add_C32(sequential1);
+    add_C34(sequential1);
+    add_C35(sequential1);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 1, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 1)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 1) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M2 = (.5 * A11 + -.5 * A13 + .5 * A22 + -.5 * A23 + -.5 * A31 + .5 * A32) * (-.5 * B13 + -.5 * B14 + -.5 * B15 + .5 * B22 + .5 * B25 + -.5 * B26 + -.5 * B31 + -.5 * B32 + .5 * B34)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential2) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential2, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S2(A11.m(), A11.n());
+    Matrix<Scalar> S2 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add2(A11, A13, A22, A23, A31, A32, S2, x, sequential2);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T2(mem_mngr.GetMem(start_index, 2, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T2(B11.m(), B11.n());
+    Matrix<Scalar> T2 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add2(B13, B14, B15, B22, B25, B26, B31, B32, B34, T2, x, sequential2);
-    FastMatmulRecursive(locker, mem_mngr, S2, T2, M2, total_steps, steps_left - 1, (start_index + 2 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 2));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S2, T2, M2, total_steps, steps_left - 1, (start_index + 2 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S2.deallocate();
     T2.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential2);
+    add_C13(sequential2);
+    add_C14(sequential2);
+    add_C21(sequential2);
+    add_C22(sequential2);
+    add_C26(sequential2);
+    add_C33(sequential2);
+    add_C35(sequential2);
+    add_C36(sequential2);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 2, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 2)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 2) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M3 = (-.5 * A11 + -.5 * A13 + .5 * A22 + -.5 * A23 + .5 * A31 + .5 * A32) * (-.5 * B11 + .5 * B13 + -.5 * B16 + -.5 * B21 + .5 * B22 + .5 * B24 + -.5 * B32 + .5 * B35 + -.5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential3) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential3, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S3(A11.m(), A11.n());
+    Matrix<Scalar> S3 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add3(A11, A13, A22, A23, A31, A32, S3, x, sequential3);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T3(mem_mngr.GetMem(start_index, 3, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T3(B11.m(), B11.n());
+    Matrix<Scalar> T3 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add3(B11, B13, B16, B21, B22, B24, B32, B35, B36, T3, x, sequential3);
-    FastMatmulRecursive(locker, mem_mngr, S3, T3, M3, total_steps, steps_left - 1, (start_index + 3 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 3));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S3, T3, M3, total_steps, steps_left - 1, (start_index + 3 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S3.deallocate();
     T3.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C13(sequential3);
+    add_C15(sequential3);
+    add_C16(sequential3);
+    add_C22(sequential3);
+    add_C24(sequential3);
+    add_C25(sequential3);
+    add_C31(sequential3);
+    add_C33(sequential3);
+    add_C34(sequential3);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 3, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 3)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 3) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M4 = (-.5 * A11 + .5 * A13 + -.5 * A22 + -.5 * A23 + .5 * A31 + .5 * A32) * (-.5 * B12 + -.5 * B15 + -.5 * B16 + -.5 * B23 + .5 * B24 + -.5 * B25 + -.5 * B31 + -.5 * B33 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential4) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential4, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S4(A11.m(), A11.n());
+    Matrix<Scalar> S4 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add4(A11, A13, A22, A23, A31, A32, S4, x, sequential4);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T4(mem_mngr.GetMem(start_index, 4, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T4(B11.m(), B11.n());
+    Matrix<Scalar> T4 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add4(B12, B15, B16, B23, B24, B25, B31, B33, B36, T4, x, sequential4);
-    FastMatmulRecursive(locker, mem_mngr, S4, T4, M4, total_steps, steps_left - 1, (start_index + 4 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 4));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S4, T4, M4, total_steps, steps_left - 1, (start_index + 4 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S4.deallocate();
     T4.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential4);
+    add_C12(sequential4);
+    add_C16(sequential4);
+    add_C21(sequential4);
+    add_C23(sequential4);
+    add_C24(sequential4);
+    add_C32(sequential4);
+    add_C34(sequential4);
+    add_C35(sequential4);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 4, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 4)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 4) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M5 = (.5 * A11 + .5 * A13 + .5 * A22 + -.5 * A23 + -.5 * A31 + -.5 * A32) * (-.5 * B13 + .5 * B14 + .5 * B15 + -.5 * B22 + .5 * B25 + -.5 * B26 + -.5 * B31 + .5 * B32 + .5 * B34)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential5) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential5, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S5(A11.m(), A11.n());
+    Matrix<Scalar> S5 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add5(A11, A13, A22, A23, A31, A32, S5, x, sequential5);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T5(mem_mngr.GetMem(start_index, 5, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T5(B11.m(), B11.n());
+    Matrix<Scalar> T5 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add5(B13, B14, B15, B22, B25, B26, B31, B32, B34, T5, x, sequential5);
-    FastMatmulRecursive(locker, mem_mngr, S5, T5, M5, total_steps, steps_left - 1, (start_index + 5 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 5));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S5, T5, M5, total_steps, steps_left - 1, (start_index + 5 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S5.deallocate();
     T5.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential5);
+    add_C13(sequential5);
+    add_C14(sequential5);
+    add_C21(sequential5);
+    add_C22(sequential5);
+    add_C26(sequential5);
+    add_C33(sequential5);
+    add_C35(sequential5);
+    add_C36(sequential5);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 5, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 5)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 5) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M6 = (-.5 * A11 + .5 * A13 + .5 * A22 + -.5 * A23 + -.5 * A31 + .5 * A32) * (-.5 * B11 + -.5 * B12 + .5 * B14 + .5 * B21 + .5 * B23 + .5 * B26 + -.5 * B33 + -.5 * B34 + -.5 * B35)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential6) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential6, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S6(A11.m(), A11.n());
+    Matrix<Scalar> S6 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add6(A11, A13, A22, A23, A31, A32, S6, x, sequential6);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T6(mem_mngr.GetMem(start_index, 6, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T6(B11.m(), B11.n());
+    Matrix<Scalar> T6 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add6(B11, B12, B14, B21, B23, B26, B33, B34, B35, T6, x, sequential6);
-    FastMatmulRecursive(locker, mem_mngr, S6, T6, M6, total_steps, steps_left - 1, (start_index + 6 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 6));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S6, T6, M6, total_steps, steps_left - 1, (start_index + 6 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S6.deallocate();
     T6.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential6);
+    add_C14(sequential6);
+    add_C15(sequential6);
+    add_C23(sequential6);
+    add_C25(sequential6);
+    add_C26(sequential6);
+    add_C31(sequential6);
+    add_C32(sequential6);
+    add_C36(sequential6);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 6, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 6)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 6) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M7 = (-.5 * A11 + -.5 * A13 + .5 * A22 + .5 * A23 + -.5 * A31 + .5 * A32) * (-.5 * B11 + .5 * B13 + .5 * B16 + .5 * B21 + -.5 * B22 + .5 * B24 + -.5 * B32 + .5 * B35 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential7) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential7, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S7(A11.m(), A11.n());
+    Matrix<Scalar> S7 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add7(A11, A13, A22, A23, A31, A32, S7, x, sequential7);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T7(mem_mngr.GetMem(start_index, 7, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T7(B11.m(), B11.n());
+    Matrix<Scalar> T7 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add7(B11, B13, B16, B21, B22, B24, B32, B35, B36, T7, x, sequential7);
-    FastMatmulRecursive(locker, mem_mngr, S7, T7, M7, total_steps, steps_left - 1, (start_index + 7 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 7));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S7, T7, M7, total_steps, steps_left - 1, (start_index + 7 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S7.deallocate();
     T7.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C13(sequential7);
+    add_C15(sequential7);
+    add_C16(sequential7);
+    add_C22(sequential7);
+    add_C24(sequential7);
+    add_C25(sequential7);
+    add_C31(sequential7);
+    add_C33(sequential7);
+    add_C34(sequential7);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 7, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 7)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 7) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M8 = (.5 * A11 + .5 * A13 + .5 * A22 + -.5 * A23 + .5 * A31 + .5 * A32) * (.5 * B12 + -.5 * B15 + .5 * B16 + .5 * B23 + -.5 * B24 + -.5 * B25 + .5 * B31 + -.5 * B33 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential8) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential8, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S8(A11.m(), A11.n());
+    Matrix<Scalar> S8 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add8(A11, A13, A22, A23, A31, A32, S8, x, sequential8);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T8(mem_mngr.GetMem(start_index, 8, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T8(B11.m(), B11.n());
+    Matrix<Scalar> T8 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add8(B12, B15, B16, B23, B24, B25, B31, B33, B36, T8, x, sequential8);
-    FastMatmulRecursive(locker, mem_mngr, S8, T8, M8, total_steps, steps_left - 1, (start_index + 8 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 8));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S8, T8, M8, total_steps, steps_left - 1, (start_index + 8 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S8.deallocate();
     T8.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential8);
+    add_C12(sequential8);
+    add_C16(sequential8);
+    add_C21(sequential8);
+    add_C23(sequential8);
+    add_C24(sequential8);
+    add_C32(sequential8);
+    add_C34(sequential8);
+    add_C35(sequential8);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 8, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 8)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 8) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M9 = (-.5 * A11 + .5 * A13 + .5 * A22 + -.5 * A23 + .5 * A31 + -.5 * A32) * (-.5 * B11 + -.5 * B13 + -.5 * B16 + .5 * B21 + .5 * B22 + -.5 * B24 + -.5 * B32 + -.5 * B35 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential9) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential9, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S9(A11.m(), A11.n());
+    Matrix<Scalar> S9 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add9(A11, A13, A22, A23, A31, A32, S9, x, sequential9);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T9(mem_mngr.GetMem(start_index, 9, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T9(B11.m(), B11.n());
+    Matrix<Scalar> T9 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
+#endif
+    T_Add9(B11, B13, B16, B21, B22, B24, B32, B35, B36, T9, x, sequential9);
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 9));
 #endif
-    T_Add9(B11, B13, B16, B21, B22, B24, B32, B35, B36, T9, x, sequential9);
-    FastMatmulRecursive(locker, mem_mngr, S9, T9, M9, total_steps, steps_left - 1, (start_index + 9 - 1) * 40, x, num_threads, Scalar(0.0));
+        FastMatmulRecursive(locker, mem_mngr, S9, T9, M9, total_steps, steps_left - 1, (start_index + 9 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S9.deallocate();
     T9.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C13(sequential9);
+    add_C15(sequential9);
+    add_C16(sequential9);
+    add_C22(sequential9);
+    add_C24(sequential9);
+    add_C25(sequential9);
+    add_C31(sequential9);
+    add_C33(sequential9);
+    add_C34(sequential9);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 9, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 9)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 9) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M10 = (-.5 * A11 + -.5 * A13 + .5 * A22 + .5 * A23 + .5 * A31 + -.5 * A32) * (-.5 * B11 + .5 * B12 + -.5 * B14 + .5 * B21 + -.5 * B23 + -.5 * B26 + -.5 * B33 + -.5 * B34 + .5 * B35)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential10) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential10, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S10(A11.m(), A11.n());
+    Matrix<Scalar> S10 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add10(A11, A13, A22, A23, A31, A32, S10, x, sequential10);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T10(mem_mngr.GetMem(start_index, 10, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T10(B11.m(), B11.n());
+    Matrix<Scalar> T10 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add10(B11, B12, B14, B21, B23, B26, B33, B34, B35, T10, x, sequential10);
-    FastMatmulRecursive(locker, mem_mngr, S10, T10, M10, total_steps, steps_left - 1, (start_index + 10 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 10));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S10, T10, M10, total_steps, steps_left - 1, (start_index + 10 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S10.deallocate();
     T10.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential10);
+    add_C14(sequential10);
+    add_C15(sequential10);
+    add_C23(sequential10);
+    add_C25(sequential10);
+    add_C26(sequential10);
+    add_C31(sequential10);
+    add_C32(sequential10);
+    add_C36(sequential10);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 10, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 10)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 10) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M11 = (.5 * A11 + .5 * A13 + -.5 * A22 + .5 * A23 + .5 * A31 + .5 * A32) * (-.5 * B11 + .5 * B12 + .5 * B14 + -.5 * B21 + .5 * B23 + -.5 * B26 + -.5 * B33 + .5 * B34 + .5 * B35)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential11) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential11, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S11(A11.m(), A11.n());
+    Matrix<Scalar> S11 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add11(A11, A13, A22, A23, A31, A32, S11, x, sequential11);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T11(mem_mngr.GetMem(start_index, 11, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T11(B11.m(), B11.n());
+    Matrix<Scalar> T11 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add11(B11, B12, B14, B21, B23, B26, B33, B34, B35, T11, x, sequential11);
-    FastMatmulRecursive(locker, mem_mngr, S11, T11, M11, total_steps, steps_left - 1, (start_index + 11 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 11));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S11, T11, M11, total_steps, steps_left - 1, (start_index + 11 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S11.deallocate();
     T11.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential11);
+    add_C14(sequential11);
+    add_C15(sequential11);
+    add_C23(sequential11);
+    add_C25(sequential11);
+    add_C26(sequential11);
+    add_C31(sequential11);
+    add_C32(sequential11);
+    add_C36(sequential11);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 11, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 11)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 11) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M12 = (.5 * A11 + .5 * A13 + .5 * A22 + .5 * A23 + .5 * A31 + -.5 * A32) * (-.5 * B13 + -.5 * B14 + .5 * B15 + .5 * B22 + -.5 * B25 + -.5 * B26 + -.5 * B31 + .5 * B32 + -.5 * B34)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential12) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential12, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S12(A11.m(), A11.n());
+    Matrix<Scalar> S12 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add12(A11, A13, A22, A23, A31, A32, S12, x, sequential12);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T12(mem_mngr.GetMem(start_index, 12, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T12(B11.m(), B11.n());
+    Matrix<Scalar> T12 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add12(B13, B14, B15, B22, B25, B26, B31, B32, B34, T12, x, sequential12);
-    FastMatmulRecursive(locker, mem_mngr, S12, T12, M12, total_steps, steps_left - 1, (start_index + 12 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 12));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S12, T12, M12, total_steps, steps_left - 1, (start_index + 12 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S12.deallocate();
     T12.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential12);
+    add_C13(sequential12);
+    add_C14(sequential12);
+    add_C21(sequential12);
+    add_C22(sequential12);
+    add_C26(sequential12);
+    add_C33(sequential12);
+    add_C35(sequential12);
+    add_C36(sequential12);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 12, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 12)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 12) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M13 = (-.5 * A11 + .5 * A13 + -.5 * A22 + .5 * A23 + -.5 * A31 + .5 * A32) * (-.5 * B12 + -.5 * B15 + .5 * B16 + .5 * B23 + .5 * B24 + .5 * B25 + -.5 * B31 + -.5 * B33 + -.5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential13) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential13, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S13(A11.m(), A11.n());
+    Matrix<Scalar> S13 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add13(A11, A13, A22, A23, A31, A32, S13, x, sequential13);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T13(mem_mngr.GetMem(start_index, 13, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T13(B11.m(), B11.n());
+    Matrix<Scalar> T13 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add13(B12, B15, B16, B23, B24, B25, B31, B33, B36, T13, x, sequential13);
-    FastMatmulRecursive(locker, mem_mngr, S13, T13, M13, total_steps, steps_left - 1, (start_index + 13 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 13));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S13, T13, M13, total_steps, steps_left - 1, (start_index + 13 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S13.deallocate();
     T13.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential13);
+    add_C12(sequential13);
+    add_C16(sequential13);
+    add_C21(sequential13);
+    add_C23(sequential13);
+    add_C24(sequential13);
+    add_C32(sequential13);
+    add_C34(sequential13);
+    add_C35(sequential13);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 13, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 13)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 13) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M14 = (-.5 * A11 + .5 * A13 + .5 * A22 + .5 * A23 + -.5 * A31 + -.5 * A32) * (.5 * B11 + .5 * B13 + -.5 * B16 + .5 * B21 + .5 * B22 + .5 * B24 + .5 * B32 + .5 * B35 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential14) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential14, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S14(A11.m(), A11.n());
+    Matrix<Scalar> S14 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add14(A11, A13, A22, A23, A31, A32, S14, x, sequential14);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T14(mem_mngr.GetMem(start_index, 14, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T14(B11.m(), B11.n());
+    Matrix<Scalar> T14 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add14(B11, B13, B16, B21, B22, B24, B32, B35, B36, T14, x, sequential14);
-    FastMatmulRecursive(locker, mem_mngr, S14, T14, M14, total_steps, steps_left - 1, (start_index + 14 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 14));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S14, T14, M14, total_steps, steps_left - 1, (start_index + 14 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S14.deallocate();
     T14.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C13(sequential14);
+    add_C15(sequential14);
+    add_C16(sequential14);
+    add_C22(sequential14);
+    add_C24(sequential14);
+    add_C25(sequential14);
+    add_C31(sequential14);
+    add_C33(sequential14);
+    add_C34(sequential14);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 14, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 14)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 14) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M15 = (-.5 * A11 + .5 * A13 + .5 * A22 + .5 * A23 + .5 * A31 + .5 * A32) * (.5 * B11 + .5 * B12 + .5 * B14 + .5 * B21 + .5 * B23 + -.5 * B26 + .5 * B33 + -.5 * B34 + .5 * B35)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential15) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential15, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S15(A11.m(), A11.n());
+    Matrix<Scalar> S15 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add15(A11, A13, A22, A23, A31, A32, S15, x, sequential15);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T15(mem_mngr.GetMem(start_index, 15, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T15(B11.m(), B11.n());
+    Matrix<Scalar> T15 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add15(B11, B12, B14, B21, B23, B26, B33, B34, B35, T15, x, sequential15);
-    FastMatmulRecursive(locker, mem_mngr, S15, T15, M15, total_steps, steps_left - 1, (start_index + 15 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 15));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S15, T15, M15, total_steps, steps_left - 1, (start_index + 15 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S15.deallocate();
     T15.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential15);
+    add_C14(sequential15);
+    add_C15(sequential15);
+    add_C23(sequential15);
+    add_C25(sequential15);
+    add_C26(sequential15);
+    add_C31(sequential15);
+    add_C32(sequential15);
+    add_C36(sequential15);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 15, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 15)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 15) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M16 = (.5 * A11 + -.5 * A13 + .5 * A22 + .5 * A23 + .5 * A31 + .5 * A32) * (.5 * B13 + -.5 * B14 + .5 * B15 + .5 * B22 + .5 * B25 + .5 * B26 + .5 * B31 + .5 * B32 + .5 * B34)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential16) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential16, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S16(A11.m(), A11.n());
+    Matrix<Scalar> S16 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add16(A11, A13, A22, A23, A31, A32, S16, x, sequential16);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T16(mem_mngr.GetMem(start_index, 16, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T16(B11.m(), B11.n());
+    Matrix<Scalar> T16 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add16(B13, B14, B15, B22, B25, B26, B31, B32, B34, T16, x, sequential16);
-    FastMatmulRecursive(locker, mem_mngr, S16, T16, M16, total_steps, steps_left - 1, (start_index + 16 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 16));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S16, T16, M16, total_steps, steps_left - 1, (start_index + 16 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S16.deallocate();
     T16.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential16);
+    add_C13(sequential16);
+    add_C14(sequential16);
+    add_C21(sequential16);
+    add_C22(sequential16);
+    add_C26(sequential16);
+    add_C33(sequential16);
+    add_C35(sequential16);
+    add_C36(sequential16);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 16, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 16)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 16) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M17 = (-.5 * A21 + -.5 * A22 + -.5 * A31 + -.5 * A32) * (-.5 * B11 + -.5 * B12 + .5 * B13 + -.5 * B14 + .5 * B15 + -.5 * B16 + -.5 * B21 + .5 * B25 + .5 * B34 + -.5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential17) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential17, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S17(A11.m(), A11.n());
+    Matrix<Scalar> S17 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add17(A21, A22, A31, A32, S17, x, sequential17);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T17(mem_mngr.GetMem(start_index, 17, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T17(B11.m(), B11.n());
+    Matrix<Scalar> T17 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add17(B11, B12, B13, B14, B15, B16, B21, B25, B34, B36, T17, x, sequential17);
-    FastMatmulRecursive(locker, mem_mngr, S17, T17, M17, total_steps, steps_left - 1, (start_index + 17 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 17));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S17, T17, M17, total_steps, steps_left - 1, (start_index + 17 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S17.deallocate();
     T17.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential17);
+    add_C15(sequential17);
+    add_C21(sequential17);
+    add_C22(sequential17);
+    add_C23(sequential17);
+    add_C24(sequential17);
+    add_C25(sequential17);
+    add_C26(sequential17);
+    add_C34(sequential17);
+    add_C36(sequential17);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 17, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 17)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 17) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M18 = (.5 * A11 + .5 * A12 + -.5 * A31 + -.5 * A32) * (-.5 * B11 + -.5 * B15 + -.5 * B21 + .5 * B22 + -.5 * B23 + .5 * B24 + -.5 * B25 + .5 * B26 + -.5 * B32 + -.5 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential18) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential18, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S18(A11.m(), A11.n());
+    Matrix<Scalar> S18 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add18(A11, A12, A31, A32, S18, x, sequential18);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T18(mem_mngr.GetMem(start_index, 18, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T18(B11.m(), B11.n());
+    Matrix<Scalar> T18 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add18(B11, B15, B21, B22, B23, B24, B25, B26, B32, B33, T18, x, sequential18);
-    FastMatmulRecursive(locker, mem_mngr, S18, T18, M18, total_steps, steps_left - 1, (start_index + 18 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 18));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S18, T18, M18, total_steps, steps_left - 1, (start_index + 18 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S18.deallocate();
     T18.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential18);
+    add_C12(sequential18);
+    add_C13(sequential18);
+    add_C14(sequential18);
+    add_C15(sequential18);
+    add_C16(sequential18);
+    add_C21(sequential18);
+    add_C25(sequential18);
+    add_C32(sequential18);
+    add_C33(sequential18);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 18, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 18)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 18) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M19 = (-.5 * A21 + .5 * A22 + -.5 * A31 + .5 * A32) * (-.5 * B11 + -.5 * B12 + .5 * B13 + .5 * B14 + .5 * B15 + .5 * B16 + .5 * B21 + -.5 * B25 + -.5 * B34 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential19) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential19, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S19(A11.m(), A11.n());
+    Matrix<Scalar> S19 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add19(A21, A22, A31, A32, S19, x, sequential19);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T19(mem_mngr.GetMem(start_index, 19, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T19(B11.m(), B11.n());
+    Matrix<Scalar> T19 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add19(B11, B12, B13, B14, B15, B16, B21, B25, B34, B36, T19, x, sequential19);
-    FastMatmulRecursive(locker, mem_mngr, S19, T19, M19, total_steps, steps_left - 1, (start_index + 19 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 19));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S19, T19, M19, total_steps, steps_left - 1, (start_index + 19 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S19.deallocate();
     T19.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential19);
+    add_C15(sequential19);
+    add_C21(sequential19);
+    add_C22(sequential19);
+    add_C23(sequential19);
+    add_C24(sequential19);
+    add_C25(sequential19);
+    add_C26(sequential19);
+    add_C34(sequential19);
+    add_C36(sequential19);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 19, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 19)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 19) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M20 = (.5 * A12 + .5 * A13 + .5 * A22 + .5 * A23) * (.5 * B11 + .5 * B15 + .5 * B21 + .5 * B22 + .5 * B23 + .5 * B24 + -.5 * B25 + -.5 * B26 + .5 * B32 + .5 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential20) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential20, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S20(A11.m(), A11.n());
+    Matrix<Scalar> S20 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add20(A12, A13, A22, A23, S20, x, sequential20);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T20(mem_mngr.GetMem(start_index, 20, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T20(B11.m(), B11.n());
+    Matrix<Scalar> T20 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add20(B11, B15, B21, B22, B23, B24, B25, B26, B32, B33, T20, x, sequential20);
-    FastMatmulRecursive(locker, mem_mngr, S20, T20, M20, total_steps, steps_left - 1, (start_index + 20 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 20));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S20, T20, M20, total_steps, steps_left - 1, (start_index + 20 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S20.deallocate();
     T20.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential20);
+    add_C12(sequential20);
+    add_C13(sequential20);
+    add_C14(sequential20);
+    add_C15(sequential20);
+    add_C16(sequential20);
+    add_C21(sequential20);
+    add_C25(sequential20);
+    add_C32(sequential20);
+    add_C33(sequential20);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 20, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 20)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 20) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M21 = (-.5 * A11 + .5 * A13 + .5 * A21 + -.5 * A23) * (.5 * B11 + .5 * B12 + .5 * B13 + -.5 * B14 + .5 * B15 + .5 * B16 + -.5 * B21 + .5 * B25 + .5 * B34 + -.5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential21) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential21, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S21(mem_mngr.GetMem(start_index, 21, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S21(mem_mngr.GetMem(start_index, 21, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S21(A11.m(), A11.n());
+    Matrix<Scalar> S21 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add21(A11, A13, A21, A23, S21, x, sequential21);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T21(mem_mngr.GetMem(start_index, 21, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T21(mem_mngr.GetMem(start_index, 21, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T21(B11.m(), B11.n());
+    Matrix<Scalar> T21 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add21(B11, B12, B13, B14, B15, B16, B21, B25, B34, B36, T21, x, sequential21);
-    FastMatmulRecursive(locker, mem_mngr, S21, T21, M21, total_steps, steps_left - 1, (start_index + 21 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 21));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S21, T21, M21, total_steps, steps_left - 1, (start_index + 21 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S21.deallocate();
     T21.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential21);
+    add_C15(sequential21);
+    add_C21(sequential21);
+    add_C22(sequential21);
+    add_C23(sequential21);
+    add_C24(sequential21);
+    add_C25(sequential21);
+    add_C26(sequential21);
+    add_C34(sequential21);
+    add_C36(sequential21);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 21, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 21)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 21) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M22 = (-.5 * A11 + -.5 * A13 + -.5 * A21 + -.5 * A23) * (.5 * B11 + -.5 * B12 + -.5 * B13 + -.5 * B14 + .5 * B15 + .5 * B16 + .5 * B21 + -.5 * B25 + -.5 * B34 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential22) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential22, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S22(mem_mngr.GetMem(start_index, 22, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S22(mem_mngr.GetMem(start_index, 22, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S22(A11.m(), A11.n());
+    Matrix<Scalar> S22 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add22(A11, A13, A21, A23, S22, x, sequential22);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T22(mem_mngr.GetMem(start_index, 22, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T22(mem_mngr.GetMem(start_index, 22, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T22(B11.m(), B11.n());
+    Matrix<Scalar> T22 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add22(B11, B12, B13, B14, B15, B16, B21, B25, B34, B36, T22, x, sequential22);
-    FastMatmulRecursive(locker, mem_mngr, S22, T22, M22, total_steps, steps_left - 1, (start_index + 22 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 22));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S22, T22, M22, total_steps, steps_left - 1, (start_index + 22 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S22.deallocate();
     T22.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential22);
+    add_C15(sequential22);
+    add_C21(sequential22);
+    add_C22(sequential22);
+    add_C23(sequential22);
+    add_C24(sequential22);
+    add_C25(sequential22);
+    add_C26(sequential22);
+    add_C34(sequential22);
+    add_C36(sequential22);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 22, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 22)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 22) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M23 = (-.5 * A22 + .5 * A23 + -.5 * A32 + .5 * A33) * (.5 * B14 + .5 * B16 + -.5 * B22 + .5 * B23 + .5 * B31 + .5 * B32 + -.5 * B33 + -.5 * B34 + -.5 * B35 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential23) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential23, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S23(mem_mngr.GetMem(start_index, 23, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S23(mem_mngr.GetMem(start_index, 23, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S23(A11.m(), A11.n());
+    Matrix<Scalar> S23 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add23(A22, A23, A32, A33, S23, x, sequential23);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T23(mem_mngr.GetMem(start_index, 23, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T23(mem_mngr.GetMem(start_index, 23, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T23(B11.m(), B11.n());
+    Matrix<Scalar> T23 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add23(B14, B16, B22, B23, B31, B32, B33, B34, B35, B36, T23, x, sequential23);
-    FastMatmulRecursive(locker, mem_mngr, S23, T23, M23, total_steps, steps_left - 1, (start_index + 23 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 23));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S23, T23, M23, total_steps, steps_left - 1, (start_index + 23 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S23.deallocate();
     T23.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential23);
+    add_C13(sequential23);
+    add_C24(sequential23);
+    add_C26(sequential23);
+    add_C31(sequential23);
+    add_C32(sequential23);
+    add_C33(sequential23);
+    add_C34(sequential23);
+    add_C35(sequential23);
+    add_C36(sequential23);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 23, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 23)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 23) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M24 = (-.5 * A22 + -.5 * A23 + -.5 * A32 + -.5 * A33) * (.5 * B14 + .5 * B16 + -.5 * B22 + .5 * B23 + -.5 * B31 + -.5 * B32 + .5 * B33 + -.5 * B34 + .5 * B35 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential24) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential24, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S24(mem_mngr.GetMem(start_index, 24, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S24(mem_mngr.GetMem(start_index, 24, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S24(A11.m(), A11.n());
+    Matrix<Scalar> S24 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add24(A22, A23, A32, A33, S24, x, sequential24);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T24(mem_mngr.GetMem(start_index, 24, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T24(mem_mngr.GetMem(start_index, 24, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T24(B11.m(), B11.n());
+    Matrix<Scalar> T24 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add24(B14, B16, B22, B23, B31, B32, B33, B34, B35, B36, T24, x, sequential24);
-    FastMatmulRecursive(locker, mem_mngr, S24, T24, M24, total_steps, steps_left - 1, (start_index + 24 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 24));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S24, T24, M24, total_steps, steps_left - 1, (start_index + 24 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S24.deallocate();
     T24.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential24);
+    add_C13(sequential24);
+    add_C24(sequential24);
+    add_C26(sequential24);
+    add_C31(sequential24);
+    add_C32(sequential24);
+    add_C33(sequential24);
+    add_C34(sequential24);
+    add_C35(sequential24);
+    add_C36(sequential24);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 24, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 24)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 24) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M25 = (-.5 * A11 + .5 * A12 + .5 * A31 + -.5 * A32) * (.5 * B11 + .5 * B15 + -.5 * B21 + -.5 * B22 + .5 * B23 + .5 * B24 + -.5 * B25 + .5 * B26 + .5 * B32 + .5 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential25) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential25, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S25(mem_mngr.GetMem(start_index, 25, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S25(mem_mngr.GetMem(start_index, 25, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S25(A11.m(), A11.n());
+    Matrix<Scalar> S25 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add25(A11, A12, A31, A32, S25, x, sequential25);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T25(mem_mngr.GetMem(start_index, 25, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T25(mem_mngr.GetMem(start_index, 25, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T25(B11.m(), B11.n());
+    Matrix<Scalar> T25 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add25(B11, B15, B21, B22, B23, B24, B25, B26, B32, B33, T25, x, sequential25);
-    FastMatmulRecursive(locker, mem_mngr, S25, T25, M25, total_steps, steps_left - 1, (start_index + 25 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 25));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S25, T25, M25, total_steps, steps_left - 1, (start_index + 25 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S25.deallocate();
     T25.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential25);
+    add_C12(sequential25);
+    add_C13(sequential25);
+    add_C14(sequential25);
+    add_C15(sequential25);
+    add_C16(sequential25);
+    add_C21(sequential25);
+    add_C25(sequential25);
+    add_C32(sequential25);
+    add_C33(sequential25);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 25, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 25)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 25) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M26 = (-.5 * A12 + .5 * A13 + .5 * A22 + -.5 * A23) * (-.5 * B11 + -.5 * B15 + .5 * B21 + .5 * B22 + .5 * B23 + -.5 * B24 + -.5 * B25 + .5 * B26 + -.5 * B32 + -.5 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential26) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential26, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S26(mem_mngr.GetMem(start_index, 26, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S26(mem_mngr.GetMem(start_index, 26, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S26(A11.m(), A11.n());
+    Matrix<Scalar> S26 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add26(A12, A13, A22, A23, S26, x, sequential26);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T26(mem_mngr.GetMem(start_index, 26, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T26(mem_mngr.GetMem(start_index, 26, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T26(B11.m(), B11.n());
+    Matrix<Scalar> T26 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add26(B11, B15, B21, B22, B23, B24, B25, B26, B32, B33, T26, x, sequential26);
-    FastMatmulRecursive(locker, mem_mngr, S26, T26, M26, total_steps, steps_left - 1, (start_index + 26 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 26));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S26, T26, M26, total_steps, steps_left - 1, (start_index + 26 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S26.deallocate();
     T26.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential26);
+    add_C12(sequential26);
+    add_C13(sequential26);
+    add_C14(sequential26);
+    add_C15(sequential26);
+    add_C16(sequential26);
+    add_C21(sequential26);
+    add_C25(sequential26);
+    add_C32(sequential26);
+    add_C33(sequential26);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 26, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 26)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 26) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M27 = (.5 * A11 + .5 * A13 + -.5 * A31 + -.5 * A33) * (.5 * B14 + .5 * B16 + -.5 * B22 + .5 * B23 + -.5 * B31 + .5 * B32 + .5 * B33 + .5 * B34 + -.5 * B35 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential27) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential27, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S27(mem_mngr.GetMem(start_index, 27, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S27(mem_mngr.GetMem(start_index, 27, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S27(A11.m(), A11.n());
+    Matrix<Scalar> S27 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add27(A11, A13, A31, A33, S27, x, sequential27);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T27(mem_mngr.GetMem(start_index, 27, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T27(mem_mngr.GetMem(start_index, 27, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T27(B11.m(), B11.n());
+    Matrix<Scalar> T27 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add27(B14, B16, B22, B23, B31, B32, B33, B34, B35, B36, T27, x, sequential27);
-    FastMatmulRecursive(locker, mem_mngr, S27, T27, M27, total_steps, steps_left - 1, (start_index + 27 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 27));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S27, T27, M27, total_steps, steps_left - 1, (start_index + 27 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S27.deallocate();
     T27.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential27);
+    add_C13(sequential27);
+    add_C24(sequential27);
+    add_C26(sequential27);
+    add_C31(sequential27);
+    add_C32(sequential27);
+    add_C33(sequential27);
+    add_C34(sequential27);
+    add_C35(sequential27);
+    add_C36(sequential27);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 27, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 27)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 27) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M28 = (-.5 * A11 + -.5 * A13 + -.5 * A31 + -.5 * A33) * (.5 * B14 + .5 * B16 + -.5 * B22 + .5 * B23 + .5 * B31 + -.5 * B32 + -.5 * B33 + .5 * B34 + .5 * B35 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential28) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential28, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S28(mem_mngr.GetMem(start_index, 28, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S28(mem_mngr.GetMem(start_index, 28, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S28(A11.m(), A11.n());
+    Matrix<Scalar> S28 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add28(A11, A13, A31, A33, S28, x, sequential28);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T28(mem_mngr.GetMem(start_index, 28, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T28(mem_mngr.GetMem(start_index, 28, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T28(B11.m(), B11.n());
+    Matrix<Scalar> T28 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add28(B14, B16, B22, B23, B31, B32, B33, B34, B35, B36, T28, x, sequential28);
-    FastMatmulRecursive(locker, mem_mngr, S28, T28, M28, total_steps, steps_left - 1, (start_index + 28 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 28));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S28, T28, M28, total_steps, steps_left - 1, (start_index + 28 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S28.deallocate();
     T28.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential28);
+    add_C13(sequential28);
+    add_C24(sequential28);
+    add_C26(sequential28);
+    add_C31(sequential28);
+    add_C32(sequential28);
+    add_C33(sequential28);
+    add_C34(sequential28);
+    add_C35(sequential28);
+    add_C36(sequential28);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 28, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 28)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 28) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M29 = (.5 * A11 + -.5 * A13 + .5 * A31 + -.5 * A33) * (.5 * B14 + .5 * B16 + -.5 * B22 + .5 * B23 + -.5 * B31 + -.5 * B32 + -.5 * B33 + -.5 * B34 + -.5 * B35 + -.5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential29) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential29, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S29(mem_mngr.GetMem(start_index, 29, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S29(mem_mngr.GetMem(start_index, 29, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S29(A11.m(), A11.n());
+    Matrix<Scalar> S29 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add29(A11, A13, A31, A33, S29, x, sequential29);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T29(mem_mngr.GetMem(start_index, 29, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T29(mem_mngr.GetMem(start_index, 29, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T29(B11.m(), B11.n());
+    Matrix<Scalar> T29 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add29(B14, B16, B22, B23, B31, B32, B33, B34, B35, B36, T29, x, sequential29);
-    FastMatmulRecursive(locker, mem_mngr, S29, T29, M29, total_steps, steps_left - 1, (start_index + 29 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 29));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S29, T29, M29, total_steps, steps_left - 1, (start_index + 29 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S29.deallocate();
     T29.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential29);
+    add_C13(sequential29);
+    add_C24(sequential29);
+    add_C26(sequential29);
+    add_C31(sequential29);
+    add_C32(sequential29);
+    add_C33(sequential29);
+    add_C34(sequential29);
+    add_C35(sequential29);
+    add_C36(sequential29);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 29, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 29)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 29) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M30 = (.5 * A22 + -.5 * A23 + -.5 * A32 + .5 * A33) * (.5 * B14 + .5 * B16 + -.5 * B22 + .5 * B23 + -.5 * B31 + .5 * B32 + -.5 * B33 + .5 * B34 + .5 * B35 + -.5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential30) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential30, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S30(mem_mngr.GetMem(start_index, 30, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S30(mem_mngr.GetMem(start_index, 30, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S30(A11.m(), A11.n());
+    Matrix<Scalar> S30 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add30(A22, A23, A32, A33, S30, x, sequential30);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T30(mem_mngr.GetMem(start_index, 30, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T30(mem_mngr.GetMem(start_index, 30, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T30(B11.m(), B11.n());
+    Matrix<Scalar> T30 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add30(B14, B16, B22, B23, B31, B32, B33, B34, B35, B36, T30, x, sequential30);
-    FastMatmulRecursive(locker, mem_mngr, S30, T30, M30, total_steps, steps_left - 1, (start_index + 30 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 30));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S30, T30, M30, total_steps, steps_left - 1, (start_index + 30 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S30.deallocate();
     T30.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential30);
+    add_C13(sequential30);
+    add_C24(sequential30);
+    add_C26(sequential30);
+    add_C31(sequential30);
+    add_C32(sequential30);
+    add_C33(sequential30);
+    add_C34(sequential30);
+    add_C35(sequential30);
+    add_C36(sequential30);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 30, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 30)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 30) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M31 = (-.5 * A22 + -.5 * A23 + .5 * A32 + .5 * A33) * (.5 * B14 + .5 * B16 + -.5 * B22 + .5 * B23 + .5 * B31 + -.5 * B32 + .5 * B33 + .5 * B34 + -.5 * B35 + -.5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential31) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential31, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S31(mem_mngr.GetMem(start_index, 31, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S31(mem_mngr.GetMem(start_index, 31, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S31(A11.m(), A11.n());
+    Matrix<Scalar> S31 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add31(A22, A23, A32, A33, S31, x, sequential31);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T31(mem_mngr.GetMem(start_index, 31, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T31(mem_mngr.GetMem(start_index, 31, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T31(B11.m(), B11.n());
+    Matrix<Scalar> T31 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add31(B14, B16, B22, B23, B31, B32, B33, B34, B35, B36, T31, x, sequential31);
-    FastMatmulRecursive(locker, mem_mngr, S31, T31, M31, total_steps, steps_left - 1, (start_index + 31 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 31));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S31, T31, M31, total_steps, steps_left - 1, (start_index + 31 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S31.deallocate();
     T31.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential31);
+    add_C13(sequential31);
+    add_C24(sequential31);
+    add_C26(sequential31);
+    add_C31(sequential31);
+    add_C32(sequential31);
+    add_C33(sequential31);
+    add_C34(sequential31);
+    add_C35(sequential31);
+    add_C36(sequential31);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 31, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 31)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 31) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M32 = (.5 * A11 + -.5 * A13 + -.5 * A31 + .5 * A33) * (.5 * B14 + .5 * B16 + -.5 * B22 + .5 * B23 + .5 * B31 + .5 * B32 + .5 * B33 + -.5 * B34 + .5 * B35 + -.5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential32) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential32, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S32(mem_mngr.GetMem(start_index, 32, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S32(mem_mngr.GetMem(start_index, 32, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S32(A11.m(), A11.n());
+    Matrix<Scalar> S32 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add32(A11, A13, A31, A33, S32, x, sequential32);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T32(mem_mngr.GetMem(start_index, 32, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T32(mem_mngr.GetMem(start_index, 32, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T32(B11.m(), B11.n());
+    Matrix<Scalar> T32 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add32(B14, B16, B22, B23, B31, B32, B33, B34, B35, B36, T32, x, sequential32);
-    FastMatmulRecursive(locker, mem_mngr, S32, T32, M32, total_steps, steps_left - 1, (start_index + 32 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 32));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S32, T32, M32, total_steps, steps_left - 1, (start_index + 32 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S32.deallocate();
     T32.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C12(sequential32);
+    add_C13(sequential32);
+    add_C24(sequential32);
+    add_C26(sequential32);
+    add_C31(sequential32);
+    add_C32(sequential32);
+    add_C33(sequential32);
+    add_C34(sequential32);
+    add_C35(sequential32);
+    add_C36(sequential32);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 32, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 32)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 32) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M33 = (.5 * A11 + -.5 * A12 + .5 * A31 + -.5 * A32) * (-.5 * B11 + -.5 * B15 + .5 * B21 + -.5 * B22 + .5 * B23 + .5 * B24 + .5 * B25 + .5 * B26 + -.5 * B32 + -.5 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential33) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential33, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S33(mem_mngr.GetMem(start_index, 33, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S33(mem_mngr.GetMem(start_index, 33, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S33(A11.m(), A11.n());
+    Matrix<Scalar> S33 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add33(A11, A12, A31, A32, S33, x, sequential33);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T33(mem_mngr.GetMem(start_index, 33, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T33(mem_mngr.GetMem(start_index, 33, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T33(B11.m(), B11.n());
+    Matrix<Scalar> T33 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add33(B11, B15, B21, B22, B23, B24, B25, B26, B32, B33, T33, x, sequential33);
-    FastMatmulRecursive(locker, mem_mngr, S33, T33, M33, total_steps, steps_left - 1, (start_index + 33 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 33));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S33, T33, M33, total_steps, steps_left - 1, (start_index + 33 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S33.deallocate();
     T33.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential33);
+    add_C12(sequential33);
+    add_C13(sequential33);
+    add_C14(sequential33);
+    add_C15(sequential33);
+    add_C16(sequential33);
+    add_C21(sequential33);
+    add_C25(sequential33);
+    add_C32(sequential33);
+    add_C33(sequential33);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 33, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 33)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 33) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M34 = (.5 * A11 + -.5 * A13 + .5 * A21 + -.5 * A23) * (.5 * B11 + .5 * B12 + .5 * B13 + .5 * B14 + .5 * B15 + -.5 * B16 + .5 * B21 + -.5 * B25 + -.5 * B34 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential34) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential34, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S34(mem_mngr.GetMem(start_index, 34, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S34(mem_mngr.GetMem(start_index, 34, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S34(A11.m(), A11.n());
+    Matrix<Scalar> S34 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add34(A11, A13, A21, A23, S34, x, sequential34);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T34(mem_mngr.GetMem(start_index, 34, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T34(mem_mngr.GetMem(start_index, 34, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T34(B11.m(), B11.n());
+    Matrix<Scalar> T34 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add34(B11, B12, B13, B14, B15, B16, B21, B25, B34, B36, T34, x, sequential34);
-    FastMatmulRecursive(locker, mem_mngr, S34, T34, M34, total_steps, steps_left - 1, (start_index + 34 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 34));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S34, T34, M34, total_steps, steps_left - 1, (start_index + 34 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S34.deallocate();
     T34.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential34);
+    add_C15(sequential34);
+    add_C21(sequential34);
+    add_C22(sequential34);
+    add_C23(sequential34);
+    add_C24(sequential34);
+    add_C25(sequential34);
+    add_C26(sequential34);
+    add_C34(sequential34);
+    add_C36(sequential34);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 34, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 34)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 34) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M35 = (.5 * A12 + -.5 * A13 + .5 * A22 + -.5 * A23) * (-.5 * B11 + -.5 * B15 + -.5 * B21 + .5 * B22 + .5 * B23 + .5 * B24 + .5 * B25 + -.5 * B26 + -.5 * B32 + -.5 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential35) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential35, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S35(mem_mngr.GetMem(start_index, 35, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S35(mem_mngr.GetMem(start_index, 35, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S35(A11.m(), A11.n());
+    Matrix<Scalar> S35 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add35(A12, A13, A22, A23, S35, x, sequential35);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T35(mem_mngr.GetMem(start_index, 35, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T35(mem_mngr.GetMem(start_index, 35, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T35(B11.m(), B11.n());
+    Matrix<Scalar> T35 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add35(B11, B15, B21, B22, B23, B24, B25, B26, B32, B33, T35, x, sequential35);
-    FastMatmulRecursive(locker, mem_mngr, S35, T35, M35, total_steps, steps_left - 1, (start_index + 35 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 35));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S35, T35, M35, total_steps, steps_left - 1, (start_index + 35 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S35.deallocate();
     T35.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential35);
+    add_C12(sequential35);
+    add_C13(sequential35);
+    add_C14(sequential35);
+    add_C15(sequential35);
+    add_C16(sequential35);
+    add_C21(sequential35);
+    add_C25(sequential35);
+    add_C32(sequential35);
+    add_C33(sequential35);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 35, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 35)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 35) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M36 = (.5 * A11 + .5 * A12 + .5 * A31 + .5 * A32) * (-.5 * B11 + -.5 * B15 + -.5 * B21 + -.5 * B22 + .5 * B23 + -.5 * B24 + -.5 * B25 + -.5 * B26 + -.5 * B32 + -.5 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential36) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential36, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S36(mem_mngr.GetMem(start_index, 36, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S36(mem_mngr.GetMem(start_index, 36, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S36(A11.m(), A11.n());
+    Matrix<Scalar> S36 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add36(A11, A12, A31, A32, S36, x, sequential36);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T36(mem_mngr.GetMem(start_index, 36, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T36(mem_mngr.GetMem(start_index, 36, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T36(B11.m(), B11.n());
+    Matrix<Scalar> T36 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add36(B11, B15, B21, B22, B23, B24, B25, B26, B32, B33, T36, x, sequential36);
-    FastMatmulRecursive(locker, mem_mngr, S36, T36, M36, total_steps, steps_left - 1, (start_index + 36 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 36));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S36, T36, M36, total_steps, steps_left - 1, (start_index + 36 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S36.deallocate();
     T36.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential36);
+    add_C12(sequential36);
+    add_C13(sequential36);
+    add_C14(sequential36);
+    add_C15(sequential36);
+    add_C16(sequential36);
+    add_C21(sequential36);
+    add_C25(sequential36);
+    add_C32(sequential36);
+    add_C33(sequential36);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 36, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 36)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 36) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M37 = (-.5 * A21 + .5 * A22 + .5 * A31 + -.5 * A32) * (-.5 * B11 + .5 * B12 + -.5 * B13 + -.5 * B14 + .5 * B15 + -.5 * B16 + .5 * B21 + -.5 * B25 + -.5 * B34 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential37) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential37, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S37(mem_mngr.GetMem(start_index, 37, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S37(mem_mngr.GetMem(start_index, 37, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S37(A11.m(), A11.n());
+    Matrix<Scalar> S37 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add37(A21, A22, A31, A32, S37, x, sequential37);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T37(mem_mngr.GetMem(start_index, 37, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T37(mem_mngr.GetMem(start_index, 37, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T37(B11.m(), B11.n());
+    Matrix<Scalar> T37 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add37(B11, B12, B13, B14, B15, B16, B21, B25, B34, B36, T37, x, sequential37);
-    FastMatmulRecursive(locker, mem_mngr, S37, T37, M37, total_steps, steps_left - 1, (start_index + 37 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 37));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S37, T37, M37, total_steps, steps_left - 1, (start_index + 37 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S37.deallocate();
     T37.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential37);
+    add_C15(sequential37);
+    add_C21(sequential37);
+    add_C22(sequential37);
+    add_C23(sequential37);
+    add_C24(sequential37);
+    add_C25(sequential37);
+    add_C26(sequential37);
+    add_C34(sequential37);
+    add_C36(sequential37);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 37, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 37)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 37) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M38 = (-.5 * A21 + -.5 * A22 + .5 * A31 + .5 * A32) * (.5 * B11 + -.5 * B12 + .5 * B13 + -.5 * B14 + -.5 * B15 + -.5 * B16 + .5 * B21 + -.5 * B25 + -.5 * B34 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential38) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential38, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S38(mem_mngr.GetMem(start_index, 38, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S38(mem_mngr.GetMem(start_index, 38, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S38(A11.m(), A11.n());
+    Matrix<Scalar> S38 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add38(A21, A22, A31, A32, S38, x, sequential38);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T38(mem_mngr.GetMem(start_index, 38, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T38(mem_mngr.GetMem(start_index, 38, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T38(B11.m(), B11.n());
+    Matrix<Scalar> T38 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add38(B11, B12, B13, B14, B15, B16, B21, B25, B34, B36, T38, x, sequential38);
-    FastMatmulRecursive(locker, mem_mngr, S38, T38, M38, total_steps, steps_left - 1, (start_index + 38 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 38));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S38, T38, M38, total_steps, steps_left - 1, (start_index + 38 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S38.deallocate();
     T38.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential38);
+    add_C15(sequential38);
+    add_C21(sequential38);
+    add_C22(sequential38);
+    add_C23(sequential38);
+    add_C24(sequential38);
+    add_C25(sequential38);
+    add_C26(sequential38);
+    add_C34(sequential38);
+    add_C36(sequential38);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 38, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 38)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 38) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M39 = (-.5 * A12 + -.5 * A13 + .5 * A22 + .5 * A23) * (.5 * B11 + .5 * B15 + -.5 * B21 + .5 * B22 + .5 * B23 + -.5 * B24 + .5 * B25 + .5 * B26 + .5 * B32 + .5 * B33)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential39) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential39, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S39(mem_mngr.GetMem(start_index, 39, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S39(mem_mngr.GetMem(start_index, 39, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S39(A11.m(), A11.n());
+    Matrix<Scalar> S39 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add39(A12, A13, A22, A23, S39, x, sequential39);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T39(mem_mngr.GetMem(start_index, 39, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T39(mem_mngr.GetMem(start_index, 39, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T39(B11.m(), B11.n());
+    Matrix<Scalar> T39 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add39(B11, B15, B21, B22, B23, B24, B25, B26, B32, B33, T39, x, sequential39);
-    FastMatmulRecursive(locker, mem_mngr, S39, T39, M39, total_steps, steps_left - 1, (start_index + 39 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 39));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S39, T39, M39, total_steps, steps_left - 1, (start_index + 39 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S39.deallocate();
     T39.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential39);
+    add_C12(sequential39);
+    add_C13(sequential39);
+    add_C14(sequential39);
+    add_C15(sequential39);
+    add_C16(sequential39);
+    add_C21(sequential39);
+    add_C25(sequential39);
+    add_C32(sequential39);
+    add_C33(sequential39);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 39, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 39)) {
+        TaskWait();
 # if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    SwitchToDFS(locker, num_threads);
+    if (schedule.threads(level, start_index, 39) == 0) {
+        SwitchToDFS(locker, num_threads);
+    }
 # endif
     }
 #endif
 
     // M40 = (-.5 * A11 + -.5 * A13 + .5 * A21 + .5 * A23) * (-.5 * B11 + .5 * B12 + .5 * B13 + -.5 * B14 + -.5 * B15 + .5 * B16 + .5 * B21 + -.5 * B25 + -.5 * B34 + .5 * B36)
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-# pragma omp task if(sequential40) shared(mem_mngr, locker) untied
-    {
+    SpawnTask(sequential40, [&] {
 #endif
 #ifdef _PARALLEL_
-    Matrix<Scalar> S40(mem_mngr.GetMem(start_index, 40, total_steps - steps_left, S), A11.m(), A11.m(), A11.n());
+    Matrix<Scalar> S40(mem_mngr.GetMem(start_index, 40, total_steps - steps_left, S), TemporaryStride<Scalar>(A11.m()), A11.m(), A11.n());
 #else
-    Matrix<Scalar> S40(A11.m(), A11.n());
+    Matrix<Scalar> S40 = TemporaryMatrix<Scalar>(A11.m(), A11.n());
 #endif
     S_Add40(A11, A13, A21, A23, S40, x, sequential40);
 #ifdef _PARALLEL_
-    Matrix<Scalar> T40(mem_mngr.GetMem(start_index, 40, total_steps - steps_left, T), B11.m(), B11.m(), B11.n());
+    Matrix<Scalar> T40(mem_mngr.GetMem(start_index, 40, total_steps - steps_left, T), TemporaryStride<Scalar>(B11.m()), B11.m(), B11.n());
 #else
-    Matrix<Scalar> T40(B11.m(), B11.n());
+    Matrix<Scalar> T40 = TemporaryMatrix<Scalar>(B11.m(), B11.n());
 #endif
     T_Add40(B11, B12, B13, B14, B15, B16, B21, B25, B34, B36, T40, x, sequential40);
-    FastMatmulRecursive(locker, mem_mngr, S40, T40, M40, total_steps, steps_left - 1, (start_index + 40 - 1) * 40, x, num_threads, Scalar(0.0));
+    {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, 40));
+#endif
+        FastMatmulRecursive(locker, mem_mngr, S40, T40, M40, total_steps, steps_left - 1, (start_index + 40 - 1) * 40, x, num_threads, Scalar(0.0));
+    }
 #ifndef _PARALLEL_
     S40.deallocate();
     T40.deallocate();
 #endif
 #if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    add_C11(sequential40);
+    add_C15(sequential40);
+    add_C21(sequential40);
+    add_C22(sequential40);
+    add_C23(sequential40);
+    add_C24(sequential40);
+    add_C25(sequential40);
+    add_C26(sequential40);
+    add_C34(sequential40);
+    add_C36(sequential40);
 locker.Decrement();
-    }
-    if (should_task_wait(40, total_steps, steps_left, start_index, 40, num_threads)) {
-# pragma omp taskwait
+    });
+    if (schedule.wait(level, start_index, 40)) {
+        TaskWait();
     }
 #endif
 
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+    if (peel_tasks) {
+        TaskWait();
+    }
+#endif
+#if !defined(_PARALLEL_) || (_PARALLEL_ != _BFS_PAR_ && _PARALLEL_ != _HYBRID_PAR_)
     M_Add1(M1, M2, M4, M5, M8, M12, M13, M16, M17, M18, M19, M20, M21, M22, M25, M26, M33, M34, M35, M36, M37, M38, M39, M40, C11, x, false, beta);
     M_Add2(M1, M4, M6, M8, M10, M11, M13, M15, M18, M20, M23, M24, M25, M26, M27, M28, M29, M30, M31, M32, M33, M35, M36, M39, C12, x, false, beta);
     M_Add3(M2, M3, M5, M7, M9, M12, M14, M16, M18, M20, M23, M24, M25, M26, M27, M28, M29, M30, M31, M32, M33, M35, M36, M39, C13, x, false, beta);
@@ -5061,78 +3124,28 @@ locker.Decrement();
     M_Add16(M1, M3, M4, M7, M8, M9, M13, M14, M17, M19, M21, M22, M23, M24, M27, M28, M29, M30, M31, M32, M34, M37, M38, M40, C34, x, false, beta);
     M_Add17(M1, M2, M4, M5, M8, M12, M13, M16, M23, M24, M27, M28, M29, M30, M31, M32, C35, x, false, beta);
     M_Add18(M2, M5, M6, M10, M11, M12, M15, M16, M17, M19, M21, M22, M23, M24, M27, M28, M29, M30, M31, M32, M34, M37, M38, M40, C36, x, false, beta);
-
-    // Handle edge cases with dynamic peeling
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
-    if (total_steps == steps_left) {
-        mkl_set_num_threads_local(num_threads);
-        mkl_set_dynamic(0);
-    }
 #endif
-    DynamicPeeling(A, B, C, 3, 3, 6, beta);
+}
+
+// Base case, rank, and temporaries of one step of the algorithm
+inline LevelShape Shape() {
+    return LevelShape(3, 3, 6, 40, 0, 0, 0,
+            {true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true},
+            {true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true});
+}
+
+// Plan for multiplying a num_rows_A x num_cols_A matrix with a num_cols_A x num_cols_B matrix
+template <typename Scalar>
+FastMatmulPlan<Scalar> MakePlan(int num_rows_A, int num_cols_A, int num_cols_B, int num_steps, double x=1e-8) {
+    return FastMatmulPlan<Scalar>(FastMatmulRecursive<Scalar>, Shape(), num_rows_A, num_cols_A, num_cols_B, num_steps, x);
 }
 
 // C := alpha * A * B + beta * C
 template <typename Scalar>
 double FastMatmul(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C,
     int num_steps, double x=1e-8, Scalar alpha=Scalar(1.0), Scalar beta=Scalar(0.0)) {
-    MemoryManager<Scalar> mem_mngr;
-#ifdef _PARALLEL_
-    mem_mngr.Allocate(3, 3, 6, 40, num_steps, A.m(), A.n(), B.n());
-#endif
-    A.set_multiplier(alpha);
-    int num_multiplies_per_step = 40;
-    int total_multiplies = pow(num_multiplies_per_step, num_steps);
-
-    // Set parameters needed for all types of parallelism.
-    int num_threads = 0;
-#ifdef _PARALLEL_
-# pragma omp parallel
-    {
-        if (omp_get_thread_num() == 0) { num_threads = omp_get_num_threads(); }
-    }
-    omp_set_nested(1);
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_)
-# pragma omp parallel
-    {
-        mkl_set_num_threads_local(1);
-        mkl_set_dynamic(0);
-    }
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _DFS_PAR_)
-    mkl_set_dynamic(0);
-#endif
-
-#if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
-    if (num_threads > total_multiplies) {
-        mkl_set_dynamic(0);
-    } else {
-# pragma omp parallel
-        {
-            mkl_set_num_threads_local(1);
-            mkl_set_dynamic(0);
-        }
-    }
-#endif
-
-    LockAndCounter locker(total_multiplies - (total_multiplies % num_threads));
-    using FpMilliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
-    auto t1 = std::chrono::high_resolution_clock::now();
-
-#ifdef _PARALLEL_
-# pragma omp parallel
-    {
-# pragma omp single
-#endif
-        FastMatmulRecursive(locker, mem_mngr, A, B, C, num_steps, num_steps, 0, x, num_threads, beta);
-#ifdef _PARALLEL_
-    }
-#endif
-    auto t2 = std::chrono::high_resolution_clock::now();
-    return FpMilliseconds(t2 - t1).count();
+    FastMatmulPlan<Scalar> plan = MakePlan<Scalar>(A.m(), A.n(), B.n(), num_steps, x);
+    return plan.Execute(A, B, C, alpha, beta);
 }
 
 }  // namespace tichavsky_kovac336_40_960
@@ -9,7 +9,6 @@
 
 #include "common.hpp"
 #include "linalg.hpp"
-#include "mkl.h"
 
 #include "special/fast424_26_206_pw.hpp"
 #include "special/fast424_26_206_st.hpp"
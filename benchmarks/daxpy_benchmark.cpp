@@ -8,7 +8,6 @@
 */
 
 #include "common.hpp"
-#include "mkl.h"
 #include "timing.hpp"
 
 #include <stdlib.h>
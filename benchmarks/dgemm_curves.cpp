@@ -27,7 +27,7 @@ enum {
 // NUM_TRIALS matrix multiplies.
 void RunSingleTest(Matrix<double>& A, Matrix<double>& B, Matrix<double>& C) {
 #ifdef _PARALLEL_
-  mkl_set_num_threads(mkl_get_max_threads());
+  blas::SetNumThreads(omp_get_max_threads());
 #endif
 
   int num_trials = 5;
@@ -99,7 +99,7 @@ int main(int argc, char **argv) {
   if (argc > 2) {
     std::cout << "no dynamic MKL" << std::endl;
 #ifdef _PARALLEL_
-    mkl_set_dynamic(0);
+    blas::SetDynamic(false);
 #endif
   }
   int type = atoi(argv[1]);
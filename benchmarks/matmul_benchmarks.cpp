@@ -9,6 +9,7 @@
 
 #include "all_algorithms.hpp"
 #include "common.hpp"
+#include "planner.hpp"
 #ifdef __INTEL_MKL__
 # include "mkl.h"
 #endif
@@ -22,21 +23,10 @@
 // The median of five trials is printed to std::cout.
 // If run_check is true, then it also
 void SingleBenchmark(int m, int k, int n, int num_steps, int algorithm) {
-  // Run a set number of trials and pick the median time.
-  int num_trials = 5;
-  std::vector<double> times(num_trials);
-  for (int trial = 0; trial < num_trials; ++trial) {
-    Matrix<double> A = RandomMatrix<double>(m, k);
-    Matrix<double> B = RandomMatrix<double>(k, n);
-    Matrix<double> C1(m, n);
-    times[trial] = RunAlgorithm(algorithm, A, B, C1, num_steps);
-  }
-
-  // Spit out the median time
-  std::sort(times.begin(), times.end());
-  size_t ind = num_trials / 2;
+  // Run a set number of trials and spit out the median time.
+  double time = MedianTime(m, k, n, num_steps, algorithm, 5);
   std::cout << " " << m << " " << k << " " << n << " "
-            << num_steps << " " << times[ind] << " "
+            << num_steps << " " << time << " "
             << "; ";
 }
 
@@ -0,0 +1,69 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#include "all_algorithms.hpp"
+#include "common.hpp"
+#include "options.hpp"
+#include "planner.hpp"
+#ifdef __INTEL_MKL__
+# include "mkl.h"
+#endif
+
+#include <iostream>
+#include <vector>
+
+// Tune the planner for one problem shape and add the result to the tuning
+// database, e.g.,
+//
+//    ./tune_planner -m 4000 -k 2000 -n 4000 -threads 8 -db fast_matmul_tuning.db
+//
+// Options: -m, -k, -n (problem size), -threads (number of threads; ignored
+// in sequential mode), -max_steps (largest number of recursive steps to try),
+// -trials (number of trials per candidate), -db (tuning database file).
+int main(int argc, char **argv) {
+  auto opts = GetOpts(argc, argv);
+  int m = GetIntOpt(opts, "m", 4000);
+  int k = GetIntOpt(opts, "k", 4000);
+  int n = GetIntOpt(opts, "n", 4000);
+  int max_steps = GetIntOpt(opts, "max_steps", 2);
+  int num_trials = GetIntOpt(opts, "trials", 5);
+  std::string db_file = GetStrOpt(opts, "db", "fast_matmul_tuning.db");
+
+  int num_threads = 1;
+#ifdef _PARALLEL_
+  num_threads = GetIntOpt(opts, "threads", omp_get_max_threads());
+  omp_set_num_threads(num_threads);
+  blas::SetNumThreads(num_threads);
+#endif
+
+  // All of the exact fast algorithms.
+  std::vector<int> algorithms = {
+    STRASSEN, FAST322_11_50, FAST332_15_103, FAST323_15_103, HK332_15_94,
+    HK323_15_94, HK323_15_84, FAST333_23_125, FAST333_23_152, FAST333_23_221,
+    SMIRNOV333_23_128, SMIRNOV333_23_139, FAST422_14_84, FAST432_20_144,
+    FAST423_20_144, FAST324_20_144, FAST342_20_144, FAST234_20_144,
+    FAST243_20_144, FAST424_26_257, FAST442_26_257, FAST424_26_206,
+    FAST433_29_234, FAST343_29_234, FAST522_18_99, FAST252_18_99,
+    SMIRNOV336_40_960, SMIRNOV363_40_960, SMIRNOV633_40_960,
+  };
+  std::vector<int> num_steps;
+  for (int i = 1; i <= max_steps; ++i) {
+    num_steps.push_back(i);
+  }
+
+  Planner planner(db_file);
+  std::cout << "Tuning " << m << " x " << k << " x " << n << " with " << num_threads
+            << " threads (" << ParallelMode() << ")" << std::endl;
+  MatmulPlan plan = planner.Tune(m, k, n, num_threads, algorithms, num_steps, num_trials,
+                                 true);
+  planner.Save();
+  std::cout << "Best: " << Alg2Str(plan.algorithm) << "_" << plan.num_steps << " ("
+            << plan.time << " ms)" << std::endl;
+  return 0;
+}
@@ -8,6 +8,12 @@
 import sys
 import subexpr_elim
 
+# Additions with at least this many operands use the cache-blocked kernel
+# with adds_type 3.  This is the break-even point from
+# benchmarks/add_benchmark.cpp for 1000 x 1000 operands, below the 24 and 28
+# operand M additions of the <3,3,6> algorithms.
+BLOCKED_ADD_MIN_OPERANDS = 18
+
 '''
 This is the main code generation script.  How to use this program:
 
@@ -17,10 +23,12 @@ coeff_file is the path to the coefficients file.
 M,K,N are the matrix dimensions:
    multiplying an M x K matrix A by a K x N matrix B and storing in a M x N matrix C
 out_file is the name of the output file
-adds_type is the type of matrix additions to use.  It is one of {0, 1, 2}:
+adds_type is the type of matrix additions to use.  It is one of {0, 1, 2, 3}:
    0: write-once additions
    1: streaming additions
    2: pairwise additions
+   3: write-once additions, cache-blocked for additions with at least
+      BLOCKED_ADD_MIN_OPERANDS operands
 
 Suppose there are R matrix multiplications in the subproblem.
 Let alpha_{ij}_r and be the coefficients for submatrix A_{ij} in the r-th
@@ -81,20 +89,24 @@ def data_call(name):
 def data_access(name):
     return 'data%s[i + j * stride%s]' % (name, name)
 
-def instantiate_tmp(header, tmp_name, mult_index, mat_name):
+def instantiate_tmp(header, tmp_name, mult_index, mat_name, tmp_type=None):
+    # tmp_type is the memory manager type (S, T, M, AX, BX, MX) if it differs
+    # from the name of the temporary.
+    if tmp_type is None:
+        tmp_type = tmp_name
+        tmp_name = '%s%d' % (tmp_name, mult_index)
     write_line(header, 0, '#ifdef _PARALLEL_')
-    inst = 'Matrix<Scalar> %s%d(' % (tmp_name, mult_index)
-    inst += 'mem_mngr.GetMem(start_index, %d, total_steps - steps_left, %s), ' % (mult_index, tmp_name)
-    inst += '%s11.m(), %s11.m(), %s11.n());' % (mat_name, mat_name, mat_name)
+    inst = 'Matrix<Scalar> %s(' % tmp_name
+    inst += 'mem_mngr.GetMem(start_index, %d, total_steps - steps_left, %s), ' % (mult_index, tmp_type)
+    inst += 'TemporaryStride<Scalar>(%s11.m()), %s11.m(), %s11.n());' % (mat_name, mat_name, mat_name)
     write_line(header, 1, inst)
     write_line(header, 0, '#else')
-    inst = 'Matrix<Scalar> %s%d(%s11.m(), %s11.n());' % (tmp_name, mult_index, mat_name, mat_name)
-    write_line(header, 1, inst)
+    write_line(header, 1, instantiate(tmp_name, mat_name))
     write_line(header, 0, '#endif')
 
 
 def instantiate(subblock, mat_name):
-    return 'Matrix<Scalar> %s(%s11.m(), %s11.n());' % (subblock, mat_name, mat_name)
+    return 'Matrix<Scalar> %s = TemporaryMatrix<Scalar>(%s11.m(), %s11.n());' % (subblock, mat_name, mat_name)
 
 
 def parse_coeff(coeff):
@@ -231,6 +243,15 @@ def arith_expression(coeff, value, place):
     return expr
 
 
+def coeff_value(coeff):
+    ''' Return the coefficient as a Scalar expression. '''
+    if is_one(coeff):
+        return 'Scalar(1)'
+    elif is_negone(coeff):
+        return 'Scalar(-1)'
+    return 'Scalar(%s)' % coeff
+
+
 def need_streaming_cse_tmp(ind, coeffs, mat_dims):
     ''' Given an index, determine whether or not we need an extra temporary
     matrix for streaming additions.  This occurs when we have an expression
@@ -426,7 +447,7 @@ def output_addition(output_mat, coeffs, mat_dims, rank):
     return add + '%s);' % output_mat
 
 
-def write_output_add(header, index, coeffs, mat_dims, rank):
+def output_add_call(index, coeffs, mat_dims, rank, sequential='false'):
     add = 'M_Add%d(' % (index)
     for i, coeff in enumerate(coeffs):
         if is_nonzero(coeff):
@@ -435,13 +456,52 @@ def write_output_add(header, index, coeffs, mat_dims, rank):
                 suffix = '_X%d' % (suffix - rank)
             add += 'M%s, ' % suffix
     output_mat = 'C' + get_suffix(index - 1, mat_dims[0], mat_dims[1])
-    add += '%s, x, false, beta);' % output_mat
-    write_line(header, 1, add)
+    return add + '%s, x, %s, beta);' % (output_mat, sequential)
+
+
+def write_output_add(header, index, coeffs, mat_dims, rank):
+    write_line(header, 1, output_add_call(index, coeffs, mat_dims, rank))
 
 
-def write_add_func(header, coeffs, index, mat_name, bfs_par_avail):
+def early_outputs(coeffs, num_multiplies, streaming_adds):
+    ''' Indices (0-based) of the blocks of C whose output addition can run as
+    soon as its multiplies are done, i.e., the ones that read no M_X
+    temporary.  The streaming additions form all of C in one loop, so there
+    are none with them.
+    '''
+    if streaming_adds:
+        return []
+    return [i for i, row in enumerate(coeffs[2])
+            if all(j < num_multiplies for j, c in enumerate(row) if is_nonzero(c))]
+
+
+def write_output_countdowns(header, coeffs, dims, num_multiplies, early):
+    ''' Declare the input countdown of each early output addition, and a
+    function that runs the addition once its last input is done.  The update
+    for the inner dimension from dynamic peeling is one more input.
+    '''
+    write_line(header, 1, '// Each block of C is summed by whichever task finishes its last input, while')
+    write_line(header, 1, '// the other multiplies still run (see InputCountdown).')
+    for i in early:
+        suffix = get_suffix(i, dims[0], dims[2])
+        write_line(header, 1, 'InputCountdown C%s_inputs(%d);' % (
+                suffix, num_nonzero(coeffs[2][i]) + 1))
+    for i in early:
+        suffix = get_suffix(i, dims[0], dims[2])
+        write_line(header, 1, 'auto add_C%s = [&](bool sequential) {' % suffix)
+        write_line(header, 2, 'if (C%s_inputs.Ready()) {' % suffix)
+        add = output_add_call(i + 1, coeffs[2][i], (dims[0], dims[2]), num_multiplies,
+                              'sequential')
+        write_line(header, 3, add)
+        write_line(header, 2, '}')
+        write_line(header, 1, '};')
+
+
+def write_add_func(header, coeffs, index, mat_name, bfs_par_avail, blocked=False):
     ''' Write the add function for a set of coefficients.  This is a custom add
-    function used for a single multiply in a single fast algorithm.
+    function used for a single multiply in a single fast algorithm.  The
+    operands are summed in one pass by the vectorized MultiAdd kernel, or by
+    the BlockedMultiAdd kernel if blocked is True and the addition is long.
 
     coeffs is the set of coefficients used for the add
     '''
@@ -459,65 +519,20 @@ def write_add_func(header, coeffs, index, mat_name, bfs_par_avail):
     add += ') {'
     write_line(header, 0, add)
 
-    # All of the strides
-    for i in range(nnz):
-        write_line(header, 1, stride_call(mat_name + str(i + 1)))
-    write_line(header, 1, stride_call('C'))
-
-    # All of the data pointers
-    for i in range(nnz):
-        write_line(header, 1, 'const Scalar *data%s%d = %s%d.data();' % (
-                mat_name, i + 1, mat_name, i + 1))
-    write_line(header, 1, 'Scalar *dataC = C.data();')
-
-    # Handle the C := alpha A * B + beta C
+    operands = ['%s%d' % (mat_name, i + 1) for i in range(nnz)]
+    write_line(header, 1, 'const Scalar *data[%d] = {%s};' % (
+            nnz, ', '.join(['%s.data()' % op for op in operands])))
+    write_line(header, 1, 'const int strides[%d] = {%s};' % (
+            nnz, ', '.join(['%s.stride()' % op for op in operands])))
+    write_line(header, 1, 'const Scalar coeffs[%d] = {%s};' % (
+            nnz, ', '.join([coeff_value(coeff) for coeff in nonzero_coeffs])))
+    kernel = 'MultiAdd'
+    if blocked and nnz >= BLOCKED_ADD_MIN_OPERANDS:
+        kernel = 'BlockedMultiAdd'
+    call = '%s<Scalar, %d>(data, strides, coeffs, C, sequential' % (kernel, nnz)
     if is_output:
-        write_line(header, 1, 'if (beta != Scalar(0.0)) {')
-        write_line(header, 0, '#ifdef _PARALLEL_')
-        write_line(header, 0, '# pragma omp parallel for if(!sequential)')
-        write_line(header, 0, '#endif')
-        write_line(header, 2, 'for (int j = 0; j < C.n(); ++j) {')
-        write_line(header, 3, 'for (int i = 0; i < C.m(); ++i) {')
-        add = data_access('C') + ' ='
-        for j, coeff in enumerate(nonzero_coeffs):
-            ind = j + 1
-            add += arith_expression(coeff, data_access(mat_name + str(ind)), j)
-        add += ' + beta * %s;' % (data_access('C'))
-
-        write_line(header, 4, add)
-        write_line(header, 3, '}')
-        write_line(header, 2, '}')
-        write_line(header, 1, '} else {')
-        write_line(header, 0, '#ifdef _PARALLEL_')
-        write_line(header, 0, '# pragma omp parallel for if(!sequential)')
-        write_line(header, 0, '#endif')
-        write_line(header, 2, 'for (int j = 0; j < C.n(); ++j) {')
-        write_line(header, 3, 'for (int i = 0; i < C.m(); ++i) {')
-        add = data_access('C') + ' ='
-        for j, coeff in enumerate(nonzero_coeffs):
-            ind = j + 1
-            add += arith_expression(coeff, data_access(mat_name + str(ind)), j)
-        add += ';'
-        write_line(header, 4, add)
-        write_line(header, 3, '}')
-        write_line(header, 2, '}')
-        write_line(header, 1, '}')
-    else:
-        write_line(header, 0, '#ifdef _PARALLEL_')
-        write_line(header, 0, '# pragma omp parallel for if(!sequential)')
-        write_line(header, 0, '#endif')
-        write_line(header, 1, 'for (int j = 0; j < C.n(); ++j) {')
-        write_line(header, 2, 'for (int i = 0; i < C.m(); ++i) {')
-        add = data_access('C') + ' ='
-        for j, coeff in enumerate(nonzero_coeffs):
-            ind = j + 1
-            add += arith_expression(coeff, data_access(mat_name + str(ind)), j)
-    
-        add += ';'
-        write_line(header, 3, add)
-        write_line(header, 2, '}')
-        write_line(header, 1, '}')
-
+        call += ', beta'
+    write_line(header, 1, call + ');')
     write_line(header, 0, '}')  # end of function
 
 
@@ -569,7 +584,8 @@ def write_pairwise_add_func(header, coeffs, index, mat_name):
     write_line(header, 0, '}')
 
 
-def write_multiply(header, index, a_coeffs, b_coeffs, dims, streaming_adds, num_multiplies):
+def write_multiply(header, index, a_coeffs, b_coeffs, dims, streaming_adds, num_multiplies,
+                   outputs):
     comment = '// M%d = (' % (index)
     comment += ' + '.join([str(c) + ' * A%s' % get_suffix(i, dims[0], dims[1]) \
                                for i, c in enumerate(a_coeffs) if is_nonzero(c)])
@@ -581,9 +597,9 @@ def write_multiply(header, index, a_coeffs, b_coeffs, dims, streaming_adds, num_
 
     # Shared memory wrappers (start)
     write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)')
-    task = '# pragma omp task if(sequential%d) shared(mem_mngr, locker) untied' % index
-    write_line(header, 0, task)
-    write_line(header, 1, '{')
+    # Everything is captured by reference: the temporaries are views that must
+    # not be copied, and the parent always waits for its tasks before returning.
+    write_line(header, 1, 'SpawnTask(sequential%d, [&] {' % index)
     write_line(header, 0, '#endif')
 
     def addition_str(coeffs, mat_name, tmp_name, mat_dims):
@@ -623,12 +639,19 @@ def write_multiply(header, index, a_coeffs, b_coeffs, dims, streaming_adds, num_
             loc = [i for i, c in enumerate(coeffs) if is_nonzero(c)]
             return mat_name + get_suffix(loc[0], mat_dims[0], mat_dims[1])
 
-    # Finally, write the actual call to matrix multiply.
-    write_line(header, 1,
+    # Finally, write the actual call to matrix multiply.  The leaf threads of a
+    # remainder group are set only around the call, since the additions may
+    # reach task scheduling points, where an untied task can change threads.
+    write_line(header, 1, '{')
+    write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)')
+    write_line(header, 2, 'ScopedLeafThreads leaf_threads(schedule.threads(level, start_index, %d));' % index)
+    write_line(header, 0, '#endif')
+    write_line(header, 2,
                'FastMatmulRecursive(locker, mem_mngr, %s, %s, %s, total_steps, steps_left - 1, %s, x, num_threads, Scalar(0.0));' % (
             subblock_name(a_coeffs, 'A', 'S', (dims[0], dims[1])),
             subblock_name(b_coeffs, 'B', 'T', (dims[1], dims[2])),
             res_mat, '(start_index + %d - 1) * %d' % (index, num_multiplies)))
+    write_line(header, 1, '}')
 
     # If we are not in parallel mode, de-allocate the temporary matrices
     write_line(header, 0, '#ifndef _PARALLEL_')
@@ -640,24 +663,31 @@ def write_multiply(header, index, a_coeffs, b_coeffs, dims, streaming_adds, num_
     
     # Shared memory wrappers (end)
     write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)')
+    for suffix in outputs:
+        write_line(header, 1, 'add_C%s(sequential%d);' % (suffix, index))
     write_line(header, 0, 'locker.Decrement();')
-    write_line(header, 1, '}')
-    write_line(header, 1, 'if (should_task_wait(%d, total_steps, steps_left, start_index, %d, num_threads)) {' % (
-            num_multiplies, index))
-    write_line(header, 0, '# pragma omp taskwait')
+    write_line(header, 1, '});')
+    write_line(header, 1, 'if (schedule.wait(level, start_index, %d)) {' % index)
+    write_line(header, 2, 'TaskWait();')
     if index != num_multiplies:
         write_line(header, 0, '# if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)')
-        write_line(header, 1, 'SwitchToDFS(locker, num_threads);')
+        # Remainder groups wait for each other, but the switch is only at the
+        # end of the BFS part.
+        write_line(header, 1, 'if (schedule.threads(level, start_index, %d) == 0) {' % index)
+        write_line(header, 2, 'SwitchToDFS(locker, num_threads);')
+        write_line(header, 1, '}')
         write_line(header, 0, '# endif')
     write_line(header, 1, '}')
     write_line(header, 0, '#endif\n')
 
 
-def create_add_functions(header, coeffs, pairwise):
+def create_add_functions(header, coeffs, pairwise, blocked):
     ''' Generate all of the custom add functions.
 
     header is the file to which we are writing
     coeffs is the set of all coefficients
+    pairwise selects pairwise additions
+    blocked selects cache-blocked kernels for long write-once additions
     '''
     def all_adds(coeffs, name, bfs_par_avail):
         for i, coeff_set in enumerate(coeffs):
@@ -665,7 +695,7 @@ def create_add_functions(header, coeffs, pairwise):
                 if pairwise:
                     write_pairwise_add_func(header, coeff_set, i + 1, name)
                 else:
-                    write_add_func(header, coeff_set, i + 1, name, bfs_par_avail)
+                    write_add_func(header, coeff_set, i + 1, name, bfs_par_avail, blocked)
                 write_break(header)
 
     # S matrices formed from A subblocks
@@ -688,7 +718,7 @@ def create_add_functions(header, coeffs, pairwise):
         all_adds(coeffs[5], 'MX', True)
 
 
-def create_multiplications(header, coeffs, dims, streaming_adds, num_multiplies):
+def create_multiplications(header, coeffs, dims, streaming_adds, num_multiplies, early):
     ''' Generate all of the recursive multiplication calls.
 
     header is the file to which we are writing
@@ -696,11 +726,15 @@ def create_multiplications(header, coeffs, dims, streaming_adds, num_multiplies)
     dims is a 3-tuple (m, k, n) of the dimensions of the problem
     streaming_adds inidicates whether or not we are using the streaming version
                    of matrix additions
+    early are the blocks of C that the multiplies add to when they finish
     '''
     for i in xrange(len(coeffs[0][0])):
         a_coeffs = [c[i] for c in coeffs[0]]
         b_coeffs = [c[i] for c in coeffs[1]]
-        write_multiply(header, i + 1, a_coeffs, b_coeffs, dims, streaming_adds, num_multiplies)
+        outputs = [get_suffix(j, dims[0], dims[2]) for j in early
+                   if is_nonzero(coeffs[2][j][i])]
+        write_multiply(header, i + 1, a_coeffs, b_coeffs, dims, streaming_adds, num_multiplies,
+                       outputs)
 
 
 def write_input_cse_sub(header, coeffs, index, mat_name, add_name, mat_dims):
@@ -709,7 +743,7 @@ def write_input_cse_sub(header, coeffs, index, mat_name, add_name, mat_dims):
         return
 
     tmp_mat_name = '%s_X%d' % (mat_name, index)
-    write_line(header, 1, instantiate(tmp_mat_name, mat_name))
+    instantiate_tmp(header, tmp_mat_name, index, mat_name, '%sX' % mat_name)
     add = '%s%d(' % (add_name, index)
     for i, coeff in enumerate(coeffs):
         if is_nonzero(coeff):
@@ -725,7 +759,7 @@ def write_output_cse_sub(header, coeffs, index, mat_name, add_name, mat_dims):
         return
 
     tmp_mat_name = '%s_X%d' % (mat_name, index)
-    write_line(header, 1, instantiate(tmp_mat_name, mat_name))
+    instantiate_tmp(header, tmp_mat_name, index, 'C', 'MX')
     add = '%s%d(' % (add_name, index)
     for i, coeff in enumerate(coeffs):
         if is_nonzero(coeff):
@@ -777,7 +811,7 @@ def create_output_cse_subs(header, coeffs, dims, streaming_adds):
                                  (dims[0], dims[2]))
 
 
-def create_output(header, coeffs, dims, streaming_adds):
+def create_output(header, coeffs, dims, streaming_adds, early):
     num_multiplies = len(coeffs[0][0])
 
     if streaming_adds:
@@ -788,87 +822,60 @@ def create_output(header, coeffs, dims, streaming_adds):
         streaming_additions(header, coeffs[2], 'C', 'M', (dims[0], dims[2]),
                             True, num_multiplies, sub_coeffs)
     else:
+        # With BFS and HYBRID, the tasks of the multiplies already formed the
+        # early blocks.
+        if len(early) > 0:
+            write_line(header, 0, '#if !defined(_PARALLEL_) || (_PARALLEL_ != _BFS_PAR_ && _PARALLEL_ != _HYBRID_PAR_)')
+            for i in early:
+                write_output_add(header, i + 1, coeffs[2][i], (dims[0], dims[2]),
+                                 num_multiplies)
+            write_line(header, 0, '#endif')
         for i, row in enumerate(coeffs[2]):
-            write_output_add(header, i + 1, row, (dims[0], dims[2]),
-                             num_multiplies)
+            if i not in early:
+                write_output_add(header, i + 1, row, (dims[0], dims[2]),
+                                 num_multiplies)
+
 
+def create_wrapper_func(header, coeffs, dims, streaming_adds):
+    num_multiplies = len(coeffs[0][0])
+    num_subs = [len(coeffs[i]) if len(coeffs) > i else 0 for i in (3, 4, 5)]
+
+    # Which multiplications form an S (T) temporary in the memory manager.
+    def needs_tmp(coeff_set):
+        needs = []
+        for i in xrange(num_multiplies):
+            col = [c[i] for c in coeff_set]
+            needs.append(need_tmp_mat(col) and not streaming_adds)
+        return '{' + ', '.join(['true' if need else 'false' for need in needs]) + '}'
+
+    # Shape of the algorithm for the memory manager
+    write_line(header, 0, '// Base case, rank, and temporaries of one step of the algorithm')
+    write_line(header, 0, 'inline LevelShape Shape() {')
+    write_line(header, 1, 'return LevelShape(%d, %d, %d, %d, %d, %d, %d,' % (
+            dims + (num_multiplies,) + tuple(num_subs)))
+    write_line(header, 3, '%s,' % needs_tmp(coeffs[0]))
+    write_line(header, 3, '%s);' % needs_tmp(coeffs[1]))
+    write_line(header, 0, '}\n')
+
+    # Reusable plan that does all of the setup once
+    write_line(header, 0, '// Plan for multiplying a num_rows_A x num_cols_A matrix with a ' +
+               'num_cols_A x num_cols_B matrix')
+    write_line(header, 0, 'template <typename Scalar>')
+    write_line(header, 0, 'FastMatmulPlan<Scalar> MakePlan(int num_rows_A, int num_cols_A, ' +
+               'int num_cols_B, int num_steps, double x=1e-8) {')
+    write_line(header, 1, 'return FastMatmulPlan<Scalar>(FastMatmulRecursive<Scalar>, Shape(), ' +
+               'num_rows_A, num_cols_A, num_cols_B, num_steps, x);')
+    write_line(header, 0, '}\n')
 
-def create_wrapper_func(header, num_multiplies, dims):
-    # Wrapper to deal with OpenMP
+    # Wrapper for a single call
     write_line(header, 0, '// C := alpha * A * B + beta * C')
     write_line(header, 0, 'template <typename Scalar>')
     write_line(header, 0, 'double FastMatmul(Matrix<Scalar>& A, Matrix<Scalar>& B, ' +
                'Matrix<Scalar>& C,')
     write_line(header, 1, 'int num_steps, double x=1e-8, Scalar alpha=Scalar(1.0), ' +
                'Scalar beta=Scalar(0.0)) {')
-    write_line(header, 1, 'MemoryManager<Scalar> mem_mngr;')
-    write_line(header, 0, '#ifdef _PARALLEL_')
-    write_line(header, 1, 'mem_mngr.Allocate(%d, %d, %d, %d, num_steps, A.m(), A.n(), B.n());'
-               % (dims[0], dims[1], dims[2], num_multiplies))
-    write_line(header, 0, '#endif')               
-
-    write_line(header, 1, 'A.set_multiplier(alpha);')
-    write_line(header, 1, 'int num_multiplies_per_step = %d;' % num_multiplies)
-    write_line(header, 1, 'int total_multiplies = pow(num_multiplies_per_step, num_steps);')
-    write_line(header, 0, '')
-
-    write_line(header, 1, '// Set parameters needed for all types of parallelism.')
-    write_line(header, 1, 'int num_threads = 0;')
-    write_line(header, 0, '#ifdef _PARALLEL_')
-    write_line(header, 0, '# pragma omp parallel')
-    write_line(header, 1,  '{')
-    write_line(header, 2, 'if (omp_get_thread_num() == 0) { num_threads = omp_get_num_threads(); }')
-    write_line(header, 1,  '}')
-    write_line(header, 1, 'omp_set_nested(1);')
-    write_line(header, 0, '#endif')
-    write_line(header, 0, '')
-
-    write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_)')
-    write_line(header, 0, '# pragma omp parallel')
-    write_line(header, 1, '{')
-    write_line(header, 2, 'mkl_set_num_threads_local(1);')
-    write_line(header, 2, 'mkl_set_dynamic(0);')
-    write_line(header, 1, '}')
-    write_line(header, 0, '#endif')
-    write_line(header, 0, '')
-
-    write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _DFS_PAR_)')
-    write_line(header, 1, 'mkl_set_dynamic(0);')
-    write_line(header, 0, '#endif')
-    write_line(header, 0, '')
-
-    write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)')
-    write_line(header, 1, 'if (num_threads > total_multiplies) {')
-    write_line(header, 2, 'mkl_set_dynamic(0);')
-    write_line(header, 1, '} else {')
-    write_line(header, 0, '# pragma omp parallel')
-    write_line(header, 2, '{')
-    write_line(header, 3, 'mkl_set_num_threads_local(1);')
-    write_line(header, 3, 'mkl_set_dynamic(0);')
-    write_line(header, 2, '}')
-    write_line(header, 1, '}')
-    write_line(header, 0, '#endif')
-    write_line(header, 0, '')
-
-    write_line(header, 1, 'LockAndCounter locker(total_multiplies - (total_multiplies % num_threads));')
-    write_line(header, 1, 'using FpMilliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;')
-    write_line(header, 1, 'auto t1 = std::chrono::high_resolution_clock::now();')
-    write_line(header, 0, '')
-
-    write_line(header, 0, '#ifdef _PARALLEL_')
-    write_line(header, 0, '# pragma omp parallel')
-    write_line(header, 1, '{')
-    write_line(header, 0, '# pragma omp single')
-    write_line(header, 0, '#endif')
-
-    write_line(header, 2, 'FastMatmulRecursive(locker, mem_mngr, A, B, C, num_steps, num_steps, 0, x, num_threads, beta);')
-
-    write_line(header, 0, '#ifdef _PARALLEL_')
-    write_line(header, 1, '}')
-    write_line(header, 0, '#endif')
-
-    write_line(header, 1, 'auto t2 = std::chrono::high_resolution_clock::now();')
-    write_line(header, 1, 'return FpMilliseconds(t2 - t1).count();')
+    write_line(header, 1, 'FastMatmulPlan<Scalar> plan = MakePlan<Scalar>(A.m(), A.n(), B.n(), num_steps, x);')
+    write_line(header, 1, 'return plan.Execute(A, B, C, alpha, beta);')
     write_line(header, 0, '}\n')
 
 
@@ -882,6 +889,7 @@ def main():
 
         streaming_adds = False
         pairwise_adds = False
+        blocked_adds = False
         if len(sys.argv) > 4:
             arg = int(sys.argv[4])
             if arg == 0:
@@ -890,6 +898,8 @@ def main():
                 streaming_adds = True
             elif arg == 2:
                 pairwise_adds = True
+            elif arg == 3:
+                blocked_adds = True
             else:
                 raise Exception('Unknown fourth argument.')
 
@@ -919,7 +929,7 @@ def main():
         write_line(header, 0, 'namespace %s {\n' % namespace_name)
 
         if not streaming_adds:
-            create_add_functions(header, coeffs, pairwise_adds)
+            create_add_functions(header, coeffs, pairwise_adds, blocked_adds)
 
         # Start of fast matrix multiplication function
         write_line(header, 0, 'template <typename Scalar>')
@@ -960,50 +970,69 @@ def main():
         write_line(header, 0, '#ifdef _PARALLEL_')
         for i in xrange(num_multiplies):
             write_line(header, 1,
-                       'Matrix<Scalar> M%d(mem_mngr.GetMem(start_index, %d, total_steps - steps_left, M), C11.m(), C11.m(), C11.n(), C.multiplier());' % (i + 1, i + 1))
+                       'Matrix<Scalar> M%d(mem_mngr.GetMem(start_index, %d, total_steps - steps_left, M), TemporaryStride<Scalar>(C11.m()), C11.m(), C11.n(), C.multiplier());' % (i + 1, i + 1))
         write_line(header, 0, '#else')
         for i in xrange(num_multiplies):
-            write_line(header, 1, 'Matrix<Scalar> M%d(C11.m(), C11.n(), C.multiplier());' % (i + 1))
+            write_line(header, 1, 'Matrix<Scalar> M%d = TemporaryMatrix<Scalar>(C11.m(), C11.n(), C.multiplier());' % (i + 1))
         write_line(header, 0, '#endif')
 
         write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)')
+        write_line(header, 1,
+                   'const TaskSchedule& schedule = locker.schedule() != NULL ? *locker.schedule() : TaskSchedule::Get(%d, total_steps, num_threads);' % num_multiplies)
+        write_line(header, 1, 'const int level = total_steps - steps_left;')
         for i in xrange(num_multiplies):
             write_line(header, 1,
-                       'bool sequential%d = should_launch_task(%d, total_steps, steps_left, start_index, %d, num_threads);' % (
-                    i + 1, num_multiplies, i + 1))
+                       'bool sequential%d = schedule.launch(level, start_index, %d);' % (i + 1, i + 1))
         write_line(header, 0, '#else')
         for i in xrange(num_multiplies):
             write_line(header, 1, 'bool sequential%d = false;' % (i + 1))
         write_line(header, 0, '#endif')
 
 
+        # Dynamic peeling runs alongside the multiplications, in tasks if they are.
+        write_break(header)
+        write_line(header, 1, '// Handle edge cases with dynamic peeling.  The update for the inner')
+        write_line(header, 1, '// dimension goes first, and the output additions add to it.')
+        write_line(header, 1, 'bool peel_tasks = sequential1;')
+        write_line(header, 1, 'PeelFringe(A, B, C, %d, %d, %d, beta, peel_tasks);' % dims)
+        early = early_outputs(coeffs, num_multiplies, streaming_adds)
+        if len(early) > 0:
+            write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)')
+            write_output_countdowns(header, coeffs, dims, num_multiplies, early)
+            write_line(header, 1, 'beta = PeelInnerDimension(A, B, C, %d, %d, %d, beta, peel_tasks, [&] {' % dims)
+            for i in early:
+                write_line(header, 2, 'add_C%s(peel_tasks);' % get_suffix(i, dims[0], dims[2]))
+            write_line(header, 1, '});')
+            write_line(header, 0, '#else')
+        write_line(header, 1, 'beta = PeelInnerDimension(A, B, C, %d, %d, %d, beta, peel_tasks);' % dims)
+        if len(early) > 0:
+            write_line(header, 0, '#endif')
+
         # Handle common subexpression elimination on the S and T matrices.
         create_input_cse_subs(header, coeffs, dims, streaming_adds)
         write_break(header)
 
         # Write the mutliplication blocks.
-        create_multiplications(header, coeffs, dims, streaming_adds, num_multiplies)
+        create_multiplications(header, coeffs, dims, streaming_adds, num_multiplies, early)
 
         # Handle common subexpression elimination on the M matrices.
         create_output_cse_subs(header, coeffs, dims, streaming_adds)
 
-        # Add the multiplication blocks to form the output.
-        create_output(header, coeffs, dims, streaming_adds)
-
-        write_break(header)
-        write_line(header, 1, '// Handle edge cases with dynamic peeling')
+        # The peeling tasks write C, so they finish before the output additions
+        # (and before returning).
         write_line(header, 0, '#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)')
-        write_line(header, 1, 'if (total_steps == steps_left) {')
-        write_line(header, 2, 'mkl_set_num_threads_local(num_threads);')
-        write_line(header, 2, 'mkl_set_dynamic(0);')
+        write_line(header, 1, 'if (peel_tasks) {')
+        write_line(header, 2, 'TaskWait();')
         write_line(header, 1, '}')
         write_line(header, 0, '#endif')
-        write_line(header, 1, 'DynamicPeeling(A, B, C, %d, %d, %d, beta);' % dims)
+
+        # Add the multiplication blocks to form the output.
+        create_output(header, coeffs, dims, streaming_adds, early)
 
         # end of function
         write_line(header, 0, '}\n')
 
-        create_wrapper_func(header, num_multiplies, dims)
+        create_wrapper_func(header, coeffs, dims, streaming_adds)
 
         # end of namespace
         write_line(header, 0, '}  // namespace %s\n' % namespace_name)
@@ -10,10 +10,11 @@
 #
 #           ./gen_all_algorithms.sh adds_type
 #
-# adds_type is the type of matrix additions to use.  It is one of {0, 1, 2}:
+# adds_type is the type of matrix additions to use.  It is one of {0, 1, 2, 3}:
 #    0: write-once additions
 #    1: streaming additions
 #    2: pairwise additions
+#    3: write-once additions, cache-blocked when they are long
 
 # Where the U, V, W versions of the algorithms live
 ALGS_DIR=algorithms
@@ -0,0 +1,113 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License, 
+   which can be found in the LICENSE file in the root directory, or at 
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#include "algorithm_registry.hpp"
+#include "runtime_matmul.hpp"
+#include "linalg.hpp"
+#include "options.hpp"
+#include "timing.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+
+// Load an algorithm from a coefficient file at run time, e.g.,
+//
+//    ./runtime_alg -coeffs codegen/algorithms/grey323-15-103 -base 3,2,3 -steps 2
+//
+// or use a different generated algorithm at each level of the recursion:
+//
+//    ./runtime_alg -algs fast424_26_257,fast333_23_152,strassen
+//
+// Options: -coeffs (coefficient file), -base (m,k,n base case),
+// -m, -k, -n (problem size), -steps (number of recursive steps),
+// -algs (comma-separated algorithm names, one per level),
+// -memory_budget (MB for temporaries; mixes BFS and DFS steps to fit),
+// -huge_pages (0: default pages, 1: transparent huge pages, 2: hugetlbfs),
+// -numa (1: split the top-level multiplies over the NUMA nodes),
+// -fused (1: fuse the additions of the last level into a native GEMM),
+// -batch (1: run all of the leaf multiplies as one batch),
+// -block_recursive (1: also time the multiply on block-recursive operands).
+int main(int argc, char **argv) {
+  auto opts = GetOpts(argc, argv);
+  std::string coeff_file = GetStrOpt(opts, "coeffs", "codegen/algorithms/strassen");
+  std::string base = GetStrOpt(opts, "base", "2,2,2");
+  int m = GetIntOpt(opts, "m", 4000);
+  int k = GetIntOpt(opts, "k", 4000);
+  int n = GetIntOpt(opts, "n", 4000);
+  int numsteps = GetIntOpt(opts, "steps", 2);
+  long memory_budget = GetIntOpt(opts, "memory_budget", 0);
+  int huge_pages = GetIntOpt(opts, "huge_pages", 0);
+  bool numa = GetIntOpt(opts, "numa", 0) != 0;
+  runtime::FuseLastLevel() = GetIntOpt(opts, "fused", 0) != 0;
+  runtime::BatchLeaves() = GetIntOpt(opts, "batch", 0) != 0;
+  bool block_recursive = GetIntOpt(opts, "block_recursive", 0) != 0;
+  int base_m, base_k, base_n;
+  if (sscanf(base.c_str(), "%d,%d,%d", &base_m, &base_k, &base_n) != 3) {
+    std::cerr << "Base case must be given as m,k,n" << std::endl;
+    return -1;
+  }
+
+  std::vector<FastAlgorithm> algs;
+  if (OptExists(opts, "algs")) {
+    algs = LoadAlgorithms(GetStrOpt(opts, "algs", ""));
+  } else {
+    algs.assign(numsteps, FastAlgorithm(coeff_file, base_m, base_k, base_n));
+  }
+  for (int level = 0; level < algs.size(); ++level) {
+    std::cout << "Level " << level << ": " << algs[level].name() << " (rank "
+              << algs[level].rank() << ")" << std::endl;
+  }
+
+  if (huge_pages == 1) {
+    HugePages::set_policy(PagePolicy::TRANSPARENT_HUGE);
+  } else if (huge_pages == 2) {
+    HugePages::set_policy(PagePolicy::HUGETLB);
+  }
+
+  Matrix<double> A = RandomMatrix<double>(m, k);
+  Matrix<double> B = RandomMatrix<double>(k, n);
+  Matrix<double> C1(m, n), C2(m, n);
+
+  Time([&] { MatMul(A, B, C1); }, "Classical gemm");
+  std::unique_ptr<NumaPartition> partition;
+#ifdef _PARALLEL_
+  if (numa) {
+    partition.reset(new NumaPartition(omp_get_max_threads()));
+    std::cout << "NUMA nodes: " << partition->num_nodes() << std::endl;
+  }
+#endif
+  double time = runtime::FastMatmul(algs, A, B, C2, 1.0, 0.0, memory_budget << 20,
+                                    partition.get());
+  std::cout << "Fast time: " << time << " ms" << std::endl;
+#if defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
+  SwitchWaitStats wait_stats = LockAndCounter::Stats();
+  std::cout << "Wait at the switch to DFS: " << wait_stats.wait_ms << " ms over "
+            << wait_stats.num_waits << " threads" << std::endl;
+#endif
+  if (huge_pages > 0) {
+    HugePages::PrintStats();
+  }
+
+  // Test for correctness.
+  std::cout << "Maximum relative difference: " << MaxRelativeDiff(C1, C2) << std::endl;
+
+  if (block_recursive) {
+    auto A_rec = runtime::BlockRecursiveLayout<double>(algs, 'A', m, k);
+    auto B_rec = runtime::BlockRecursiveLayout<double>(algs, 'B', k, n);
+    auto C_rec = runtime::BlockRecursiveLayout<double>(algs, 'C', m, n);
+    Time([&] { A_rec.CopyFrom(A); B_rec.CopyFrom(B); }, "Conversion to block-recursive");
+    time = runtime::FastMatmul(algs, A_rec, B_rec, C_rec);
+    std::cout << "Block-recursive fast time: " << time << " ms" << std::endl;
+    C_rec.CopyTo(C2);
+    std::cout << "Maximum relative difference: " << MaxRelativeDiff(C1, C2) << std::endl;
+  }
+
+  return 0;
+}
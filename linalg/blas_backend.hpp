@@ -0,0 +1,107 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _BLAS_BACKEND_HPP_
+#define _BLAS_BACKEND_HPP_
+
+// The BLAS library is picked at compile time:
+//
+//    -DBLAS_OPENBLAS   OpenBLAS
+//    -DBLAS_BLIS       BLIS (through its BLAS interface)
+//    -DBLAS_MKL        MKL, which is also the default for parallel builds
+//
+// Sequential builds with none of these link against any BLAS and do not
+// control its threads.  Everything outside of this file goes through the
+// functions in namespace blas below to control threading, so the rest of the
+// code does not depend on the library.
+//
+// Independently of the library, the leaf multiplies of the fast algorithms
+// can run on the native GEMM in fused_gemm.hpp (see LeafGemm).
+
+#if defined(BLAS_OPENBLAS)
+extern "C" {
+  void openblas_set_num_threads(int num_threads);
+}
+#elif defined(BLAS_BLIS)
+# include <cstdint>
+extern "C" {
+  void bli_thread_set_num_threads(int64_t num_threads);
+}
+#elif defined(_PARALLEL_) || defined(__INTEL_MKL__) || defined(BLAS_MKL)
+# ifndef BLAS_MKL
+#  define BLAS_MKL
+# endif
+# include "mkl.h"
+// ?gemm_batch first shipped with MKL 11.3.
+# if defined(INTEL_MKL_VERSION) && INTEL_MKL_VERSION >= 110300
+#  define BLAS_HAS_GEMM_BATCH
+# endif
+#endif
+
+
+enum class GemmBackend {
+  BLAS,    // gemm from the BLAS library
+  NATIVE,  // NativeGemm in fused_gemm.hpp
+};
+
+
+namespace blas {
+  // Number of threads for native GEMMs called by this thread.  0 means all of
+  // the threads of a new parallel region.
+  inline int& NativeThreadsLocal() {
+    static thread_local int num_threads = 0;
+    return num_threads;
+  }
+
+
+  // Number of threads for GEMMs called by this thread, like
+  // mkl_set_num_threads_local.  OpenBLAS and BLIS only have a global setting,
+  // which cannot differ between tasks, so there it only affects the native
+  // GEMM.  (OpenBLAS runs single-threaded inside of parallel regions anyway.)
+  inline void SetNumThreadsLocal(int num_threads) {
+    NativeThreadsLocal() = num_threads;
+#ifdef BLAS_MKL
+    mkl_set_num_threads_local(num_threads);
+#endif
+  }
+
+
+  // Number of threads for GEMMs called from outside of parallel regions.
+  inline void SetNumThreads(int num_threads) {
+#if defined(BLAS_MKL)
+    mkl_set_num_threads(num_threads);
+#elif defined(BLAS_OPENBLAS)
+    openblas_set_num_threads(num_threads);
+#elif defined(BLAS_BLIS)
+    bli_thread_set_num_threads(num_threads);
+#endif
+  }
+
+
+  // Whether the library may use fewer threads than it was given.
+  inline void SetDynamic(bool dynamic) {
+#ifdef BLAS_MKL
+    mkl_set_dynamic(dynamic ? 1 : 0);
+#endif
+  }
+}
+
+
+// Backend for the leaf multiplies (MatMul).  Building with -DNATIVE_GEMM
+// makes the native GEMM the default.
+inline GemmBackend& LeafGemm() {
+#ifdef NATIVE_GEMM
+  static GemmBackend backend = GemmBackend::NATIVE;
+#else
+  static GemmBackend backend = GemmBackend::BLAS;
+#endif
+  return backend;
+}
+
+#endif  // _BLAS_BACKEND_HPP_
@@ -10,15 +10,11 @@
 #ifndef _BLAS_WRAP_HPP_
 #define _BLAS_WRAP_HPP_
 
-#include "common.hpp"
-
-#ifdef __INTEL_MKL__
-# include "mkl.h"
-# include "mkl_types.h"
-#endif
+#include "blas_backend.hpp"
 
 #include <functional>
 #include <stdexcept>
+#include <vector>
 
 #if defined(BLAS_POST)
 # define BLAS_NAME(name) name ## _
@@ -119,6 +115,33 @@ namespace blas {
                       C, &ldc);
   }
 
+#ifdef BLAS_HAS_GEMM_BATCH
+  // C[i] <-- alpha[i] * A[i] * B[i] for i < count, with no transposes, in one
+  // call to MKL's dgemm_batch.  Each multiply is its own group.
+  void GemmBatch(int count, const int *m, const int *n, const int *k, double **A,
+                 const int *lda, double **B, const int *ldb, double **C, const int *ldc,
+                 const double *alpha) {
+    std::vector<char> trans(count, 'N');
+    std::vector<double> beta(count, 0.0);
+    std::vector<int> group_size(count, 1);
+    dgemm_batch(&trans[0], &trans[0], m, n, k, alpha, const_cast<const double **>(A), lda,
+                const_cast<const double **>(B), ldb, &beta[0], C, ldc, &count,
+                &group_size[0]);
+  }
+
+  // Same as above, with MKL's sgemm_batch.
+  void GemmBatch(int count, const int *m, const int *n, const int *k, float **A,
+                 const int *lda, float **B, const int *ldb, float **C, const int *ldc,
+                 const float *alpha) {
+    std::vector<char> trans(count, 'N');
+    std::vector<float> beta(count, 0.0f);
+    std::vector<int> group_size(count, 1);
+    sgemm_batch(&trans[0], &trans[0], m, n, k, alpha, const_cast<const float **>(A), lda,
+                const_cast<const float **>(B), ldb, &beta[0], C, ldc, &count,
+                &group_size[0]);
+  }
+#endif
+
   // C <-- alpha * A + C
   void Axpy(double *C, double *A, int n, double alpha, int incx, int incy) {
     BLAS_NAME(daxpy) (&n, &alpha, A, &incx, C, &incy);
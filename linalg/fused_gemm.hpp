@@ -0,0 +1,439 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _FUSED_GEMM_HPP_
+#define _FUSED_GEMM_HPP_
+
+// A native GEMM in the style of GotoBLAS and BLIS, where the packing and the
+// write-back are fused with the additions of a fast algorithm:
+//
+//    C_t += gamma_t * (sum_i alpha_i A_i) * (sum_j beta_j B_j)   for every t.
+//
+// The sums are formed while the blocks of A and B are packed into the
+// contiguous buffers that the micro-kernel reads, and each tile of the
+// product is added to every C_t before it leaves the registers' neighborhood.
+// So a multiply of a fast algorithm needs no S, T, or M temporaries, and the
+// additions cost no extra passes over memory.
+//
+// The loops are the usual five: columns of C in blocks of nc, the inner
+// dimension in blocks of kc (pack B), rows of C in blocks of mc (pack A), and
+// the nr x mr tiles that the micro-kernel computes from the packed buffers.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "blas_backend.hpp"
+#include "simd_add.hpp"
+#include "stack_arena.hpp"
+
+#ifdef _PARALLEL_
+# include <omp.h>
+#endif
+
+
+// One term, coeff * X, of a linear combination of equally sized column-major
+// blocks X.
+template <typename Scalar>
+struct GemmTerm {
+  GemmTerm(Scalar *data, int stride, Scalar coeff) : data(data), stride(stride),
+                                                     coeff(coeff) {}
+  Scalar *data;
+  int stride;
+  Scalar coeff;
+};
+
+
+// The micro-kernel computes an mr x nr tile of the product from kc columns of
+// a packed panel of A and kc rows of a packed panel of B:
+//
+//    tile[i + j * mr] = sum_{p < kc} a[p * mr + i] * b[p * nr + j].
+template <typename Scalar>
+struct GemmMicroKernel {
+  typedef void (*Func)(int kc, const Scalar *a, const Scalar *b, Scalar *tile);
+  Func func;
+  int mr;
+  int nr;
+};
+
+// Largest tile of any micro-kernel (the AVX-512 float kernel).
+const int kMaxGemmTile = 32 * 12;
+
+
+// Without vector instructions.
+template <typename Scalar, int MR, int NR>
+void GemmKernelScalar(int kc, const Scalar *a, const Scalar *b, Scalar *tile) {
+  Scalar c[MR * NR] = {0};
+  for (int p = 0; p < kc; ++p) {
+    for (int j = 0; j < NR; ++j) {
+      Scalar bj = b[p * NR + j];
+      for (int i = 0; i < MR; ++i) {
+        c[i + j * MR] += a[p * MR + i] * bj;
+      }
+    }
+  }
+  for (int i = 0; i < MR * NR; ++i) {
+    tile[i] = c[i];
+  }
+}
+
+
+#ifdef _SIMD_ADD_X86_
+// The accumulators only stay in registers if the loops over them are fully
+// unrolled, which g++ does not always do at -O2.
+# if defined(__GNUC__) && !defined(__INTEL_COMPILER) && !defined(__clang__) && __GNUC__ >= 8
+#  define _GEMM_UNROLL_ _Pragma("GCC unroll 16")
+# else
+#  define _GEMM_UNROLL_
+# endif
+
+// MV vectors of A times NR broadcast entries of B, accumulated in MV * NR
+// registers.  The AVX2 and AVX-512 versions are the same code with different
+// target attributes, as for the addition kernels.
+template <typename Ops, int MV, int NR, typename Scalar>
+_AVX2_TARGET_ void GemmKernelAvx2(int kc, const Scalar *a, const Scalar *b, Scalar *tile) {
+  typedef typename Ops::Vec Vec;
+  const int kMR = MV * Ops::kWidth;
+  Vec c[MV][NR];
+  _GEMM_UNROLL_
+  for (int j = 0; j < NR; ++j) {
+    _GEMM_UNROLL_
+    for (int i = 0; i < MV; ++i) {
+      c[i][j] = Ops::Set1(Scalar(0.0));
+    }
+  }
+  for (int p = 0; p < kc; ++p) {
+    Vec av[MV];
+    _GEMM_UNROLL_
+    for (int i = 0; i < MV; ++i) {
+      av[i] = Ops::Load(a + p * kMR + i * Ops::kWidth);
+    }
+    _GEMM_UNROLL_
+    for (int j = 0; j < NR; ++j) {
+      Vec bj = Ops::Set1(b[p * NR + j]);
+      _GEMM_UNROLL_
+      for (int i = 0; i < MV; ++i) {
+        c[i][j] = Ops::Fmadd(av[i], bj, c[i][j]);
+      }
+    }
+  }
+  _GEMM_UNROLL_
+  for (int j = 0; j < NR; ++j) {
+    _GEMM_UNROLL_
+    for (int i = 0; i < MV; ++i) {
+      Ops::Store(tile + j * kMR + i * Ops::kWidth, c[i][j]);
+    }
+  }
+}
+
+template <typename Ops, int MV, int NR, typename Scalar>
+_AVX512_TARGET_ void GemmKernelAvx512(int kc, const Scalar *a, const Scalar *b,
+                                      Scalar *tile) {
+  typedef typename Ops::Vec Vec;
+  const int kMR = MV * Ops::kWidth;
+  Vec c[MV][NR];
+  _GEMM_UNROLL_
+  for (int j = 0; j < NR; ++j) {
+    _GEMM_UNROLL_
+    for (int i = 0; i < MV; ++i) {
+      c[i][j] = Ops::Set1(Scalar(0.0));
+    }
+  }
+  for (int p = 0; p < kc; ++p) {
+    Vec av[MV];
+    _GEMM_UNROLL_
+    for (int i = 0; i < MV; ++i) {
+      av[i] = Ops::Load(a + p * kMR + i * Ops::kWidth);
+    }
+    _GEMM_UNROLL_
+    for (int j = 0; j < NR; ++j) {
+      Vec bj = Ops::Set1(b[p * NR + j]);
+      _GEMM_UNROLL_
+      for (int i = 0; i < MV; ++i) {
+        c[i][j] = Ops::Fmadd(av[i], bj, c[i][j]);
+      }
+    }
+  }
+  _GEMM_UNROLL_
+  for (int j = 0; j < NR; ++j) {
+    _GEMM_UNROLL_
+    for (int i = 0; i < MV; ++i) {
+      Ops::Store(tile + j * kMR + i * Ops::kWidth, c[i][j]);
+    }
+  }
+}
+
+
+// Two vectors by 6 columns (12 accumulators) for AVX2 and two vectors by 12
+// columns (24 accumulators) for AVX-512.
+template <typename Scalar>
+GemmMicroKernel<Scalar> SelectGemmKernel(SimdLevel level, std::true_type) {
+  GemmMicroKernel<Scalar> kernel;
+  switch (level) {
+  case SimdLevel::AVX512:
+    kernel.func = GemmKernelAvx512<Avx512Ops<Scalar>, 2, 12, Scalar>;
+    kernel.mr = 2 * Avx512Ops<Scalar>::kWidth;
+    kernel.nr = 12;
+    break;
+  case SimdLevel::AVX2:
+    kernel.func = GemmKernelAvx2<Avx2Ops<Scalar>, 2, 6, Scalar>;
+    kernel.mr = 2 * Avx2Ops<Scalar>::kWidth;
+    kernel.nr = 6;
+    break;
+  default:
+    kernel.func = GemmKernelScalar<Scalar, 4, 4>;
+    kernel.mr = 4;
+    kernel.nr = 4;
+    break;
+  }
+  return kernel;
+}
+#endif  // _SIMD_ADD_X86_
+
+template <typename Scalar, typename HasVectorKernels>
+GemmMicroKernel<Scalar> SelectGemmKernel(SimdLevel level, HasVectorKernels) {
+  GemmMicroKernel<Scalar> kernel;
+  kernel.func = GemmKernelScalar<Scalar, 4, 4>;
+  kernel.mr = 4;
+  kernel.nr = 4;
+  return kernel;
+}
+
+// The micro-kernel for the instruction set level.
+template <typename Scalar>
+GemmMicroKernel<Scalar> SelectGemmKernel(SimdLevel level) {
+#ifdef _SIMD_ADD_X86_
+  typedef std::integral_constant<bool, std::is_same<Scalar, double>::value ||
+                                 std::is_same<Scalar, float>::value> HasVectorKernels;
+#else
+  typedef std::false_type HasVectorKernels;
+#endif
+  return SelectGemmKernel<Scalar>(level, HasVectorKernels());
+}
+
+
+// Cache blocking: a kc x nc block of B is packed to stay in the last-level
+// cache, an mc x kc block of A is packed to stay in L2, and a kc x nr panel
+// of B stays in L1 while the micro-kernel sweeps over the panels of A.
+const int kGemmKc = 256;
+const long kGemmPackedABytes = 192 << 10;
+const long kGemmPackedBBytes = 4 << 20;
+
+
+// Memory for packed blocks.  Each calling thread keeps its buffer between
+// calls, so the multiplies of a fast algorithm do not allocate.  The threads
+// of a nested team are new on every parallel region in libgomp, so they use
+// slices of their caller's buffer rather than buffers of their own.
+template <typename Scalar>
+Scalar *GemmPackBuffer(size_t size) {
+  struct Buffer {
+    std::unique_ptr<char[]> memory;
+    size_t bytes;
+  };
+  static thread_local Buffer buffer = {nullptr, 0};
+  size_t bytes = size * sizeof(Scalar) + StackArena::kAlignment;
+  if (buffer.bytes < bytes) {
+    buffer.memory.reset(new char[bytes]);
+    buffer.bytes = bytes;
+  }
+  uintptr_t addr = reinterpret_cast<uintptr_t>(buffer.memory.get());
+  return reinterpret_cast<Scalar *>(StackArena::RoundUp(addr));
+}
+
+
+// dst[p * mr + i] = sum_t coeff_t * X_t(row + i, col + p) for p < kc and
+// i < rows, padded with zeros to mr rows.
+template <typename Scalar>
+void PackAPanel(const GemmTerm<Scalar> *terms, int num_terms, int row, int col, int rows,
+                int kc, int mr, Scalar *dst) {
+  for (int p = 0; p < kc; ++p) {
+    Scalar *d = dst + p * mr;
+    for (int t = 0; t < num_terms; ++t) {
+      const GemmTerm<Scalar>& term = terms[t];
+      const Scalar *src = term.data + row + static_cast<long>(col + p) * term.stride;
+      if (t == 0) {
+        for (int i = 0; i < rows; ++i) {
+          d[i] = term.coeff * src[i];
+        }
+      } else {
+        for (int i = 0; i < rows; ++i) {
+          d[i] += term.coeff * src[i];
+        }
+      }
+    }
+    for (int i = rows; i < mr; ++i) {
+      d[i] = Scalar(0.0);
+    }
+  }
+}
+
+
+// dst[p * nr + j] = sum_t coeff_t * X_t(row + p, col + j) for p < kc and
+// j < cols, padded with zeros to nr columns.
+template <typename Scalar>
+void PackBPanel(const GemmTerm<Scalar> *terms, int num_terms, int row, int col, int cols,
+                int kc, int nr, Scalar *dst) {
+  for (int j = 0; j < cols; ++j) {
+    for (int t = 0; t < num_terms; ++t) {
+      const GemmTerm<Scalar>& term = terms[t];
+      const Scalar *src = term.data + row + static_cast<long>(col + j) * term.stride;
+      if (t == 0) {
+        for (int p = 0; p < kc; ++p) {
+          dst[p * nr + j] = term.coeff * src[p];
+        }
+      } else {
+        for (int p = 0; p < kc; ++p) {
+          dst[p * nr + j] += term.coeff * src[p];
+        }
+      }
+    }
+  }
+  for (int j = cols; j < nr; ++j) {
+    for (int p = 0; p < kc; ++p) {
+      dst[p * nr + j] = Scalar(0.0);
+    }
+  }
+}
+
+
+// C_t(row + i, col + j) += coeff_t * tile[i + j * mr] for every term.
+template <typename Scalar>
+void ScatterTile(const Scalar *tile, int mr, const GemmTerm<Scalar> *terms, int num_terms,
+                 int row, int col, int rows, int cols) {
+  for (int t = 0; t < num_terms; ++t) {
+    const GemmTerm<Scalar>& term = terms[t];
+    Scalar *c = term.data + row + static_cast<long>(col) * term.stride;
+    for (int j = 0; j < cols; ++j) {
+      for (int i = 0; i < rows; ++i) {
+        c[i + static_cast<long>(j) * term.stride] += term.coeff * tile[i + j * mr];
+      }
+    }
+  }
+}
+
+
+// C_t += coeff_t * (sum A_terms) * (sum B_terms) for every C term, where the
+// num_A A terms are m x k, the num_B B terms are k x n, and the num_C C terms
+// are m x n.  The blocks of C must not overlap.  If sequential is false, the
+// packing of B and the blocks of rows of C are split over num_threads threads
+// (0 for the default number of a new parallel region).
+template <typename Scalar>
+void FusedGemm(int m, int n, int k, const GemmTerm<Scalar> *A_terms, int num_A,
+               const GemmTerm<Scalar> *B_terms, int num_B, const GemmTerm<Scalar> *C_terms,
+               int num_C, bool sequential, int num_threads=0) {
+  if (m <= 0 || n <= 0 || k <= 0 || num_A == 0 || num_B == 0 || num_C == 0) {
+    return;
+  }
+#ifdef _PARALLEL_
+  const int team_size = num_threads > 0 ? num_threads : omp_get_max_threads();
+#endif
+  const GemmMicroKernel<Scalar> kernel = SelectGemmKernel<Scalar>(ActiveSimdLevel());
+  const int mr = kernel.mr;
+  const int nr = kernel.nr;
+  const int kc = kGemmKc;
+  const long kc_bytes = kc * static_cast<long>(sizeof(Scalar));
+  const int mc = std::max(1L, kGemmPackedABytes / kc_bytes / mr) * mr;
+  const int nc = std::max(1L, kGemmPackedBBytes / kc_bytes / nr) * nr;
+  // The packed B, and then one packed block of A for each thread.  Sizing
+  // for at least the default team keeps the buffer from growing when a
+  // thread later gets a larger team.
+  int num_A_blocks = 1;
+#ifdef _PARALLEL_
+  if (!sequential) {
+    num_A_blocks = std::max(team_size, omp_get_max_threads());
+  }
+#endif
+  const size_t packed_A_size = static_cast<size_t>(mc) * kc;
+  Scalar *packed_B = GemmPackBuffer<Scalar>(static_cast<size_t>(kc) * nc +
+                                            packed_A_size * num_A_blocks);
+
+  for (int jc = 0; jc < n; jc += nc) {
+    int nc_curr = std::min(nc, n - jc);
+    int num_B_panels = (nc_curr + nr - 1) / nr;
+    for (int pc = 0; pc < k; pc += kc) {
+      int kc_curr = std::min(kc, k - pc);
+#ifdef _PARALLEL_
+# pragma omp parallel for if(!sequential) num_threads(team_size)
+#endif
+      for (int jp = 0; jp < num_B_panels; ++jp) {
+        PackBPanel(B_terms, num_B, pc, jc + jp * nr, std::min(nr, nc_curr - jp * nr), kc_curr, nr,
+                   packed_B + static_cast<long>(jp) * nr * kc_curr);
+      }
+
+      int num_row_blocks = (m + mc - 1) / mc;
+#ifdef _PARALLEL_
+# pragma omp parallel for if(!sequential) num_threads(team_size) schedule(dynamic)
+#endif
+      for (int ib = 0; ib < num_row_blocks; ++ib) {
+        int ic = ib * mc;
+        int mc_curr = std::min(mc, m - ic);
+        int num_A_panels = (mc_curr + mr - 1) / mr;
+        int thread_num = 0;
+#ifdef _PARALLEL_
+        thread_num = omp_get_thread_num();
+#endif
+        Scalar *packed_A = packed_B + static_cast<size_t>(kc) * nc + packed_A_size * thread_num;
+        for (int ip = 0; ip < num_A_panels; ++ip) {
+          PackAPanel(A_terms, num_A, ic + ip * mr, pc, std::min(mr, mc_curr - ip * mr), kc_curr,
+                     mr, packed_A + static_cast<long>(ip) * mr * kc_curr);
+        }
+        alignas(64) Scalar tile[kMaxGemmTile];
+        for (int jp = 0; jp < num_B_panels; ++jp) {
+          const Scalar *b = packed_B + static_cast<long>(jp) * nr * kc_curr;
+          for (int ip = 0; ip < num_A_panels; ++ip) {
+            kernel.func(kc_curr, packed_A + static_cast<long>(ip) * mr * kc_curr, b, tile);
+            ScatterTile(tile, mr, C_terms, num_C, ic + ip * mr, jc + jp * nr,
+                        std::min(mr, mc_curr - ip * mr), std::min(nr, nc_curr - jp * nr));
+          }
+        }
+      }
+    }
+  }
+}
+
+
+// The same with the terms in vectors.
+template <typename Scalar>
+void FusedGemm(int m, int n, int k, const std::vector< GemmTerm<Scalar> >& A_terms,
+               const std::vector< GemmTerm<Scalar> >& B_terms,
+               const std::vector< GemmTerm<Scalar> >& C_terms, bool sequential,
+               int num_threads=0) {
+  FusedGemm(m, n, k, A_terms.data(), static_cast<int>(A_terms.size()), B_terms.data(),
+            static_cast<int>(B_terms.size()), C_terms.data(), static_cast<int>(C_terms.size()),
+            sequential, num_threads);
+}
+
+
+// C <-- alpha * A * B + beta * C for column-major A (m x k), B (k x n), and
+// C (m x n), i.e., gemm with no transposes.  This is the native leaf backend
+// (see LeafGemm).  It runs on the number of threads that
+// blas::SetNumThreadsLocal set for this thread, and on a new parallel region
+// of the default size if it was not called.  It does not allocate.
+template <typename Scalar>
+void NativeGemm(int m, int n, int k, Scalar *A, int lda, Scalar *B, int ldb, Scalar *C,
+                int ldc, Scalar alpha, Scalar beta) {
+  if (beta != Scalar(1.0)) {
+    for (int j = 0; j < n; ++j) {
+      Scalar *col = C + static_cast<long>(j) * ldc;
+      for (int i = 0; i < m; ++i) {
+        col[i] = beta == Scalar(0.0) ? Scalar(0.0) : beta * col[i];
+      }
+    }
+  }
+  GemmTerm<Scalar> A_term(A, lda, Scalar(1.0));
+  GemmTerm<Scalar> B_term(B, ldb, Scalar(1.0));
+  GemmTerm<Scalar> C_term(C, ldc, alpha);
+  int num_threads = blas::NativeThreadsLocal();
+  FusedGemm(m, n, k, &A_term, 1, &B_term, 1, &C_term, 1, num_threads == 1, num_threads);
+}
+
+#endif  // _FUSED_GEMM_HPP_
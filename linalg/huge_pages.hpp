@@ -0,0 +1,275 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _HUGE_PAGES_HPP_
+#define _HUGE_PAGES_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+# include <sys/mman.h>
+#endif
+
+// Page policy for large allocations (matrices, memory manager buffers, and
+// stack arenas):
+//   DEFAULT: the usual heap allocation.
+//   TRANSPARENT_HUGE: anonymous memory aligned to 2 MB and advised for
+//       transparent huge pages (madvise(MADV_HUGEPAGE)).  The kernel decides
+//       whether it actually backs the memory with huge pages.
+//   HUGETLB: explicit huge pages (mmap with MAP_HUGETLB).  These must have
+//       been reserved by the administrator (vm.nr_hugepages); if there are
+//       none left, the allocation falls back to TRANSPARENT_HUGE.
+enum class PagePolicy {DEFAULT, TRANSPARENT_HUGE, HUGETLB};
+
+
+// What HugePages::Stats() reports about the allocations that are currently
+// live with a huge page policy.
+struct HugePageStats {
+  long num_allocations;  // Live allocations made with a huge page policy
+  long bytes;            // Bytes mapped for them
+  long hugetlb_bytes;    // Bytes backed by explicit huge pages
+  long transparent_bytes;  // Bytes backed by transparent huge pages right now
+  long num_fallbacks;    // HUGETLB requests that fell back, since the start
+};
+
+
+// Allocation of memory on huge pages.  Everything is static so that Matrix,
+// MemoryManager, and StackArena share one policy.  Memory is only taken from
+// here if the policy is not DEFAULT and the request is at least Threshold()
+// bytes; otherwise Allocate() returns NULL and the caller uses the heap.
+// Allocations are aligned to the huge page size.
+class HugePages {
+public:
+  static const size_t kHugePageSize = 2 << 20;
+
+  static PagePolicy policy() { return State().policy; }
+  static void set_policy(PagePolicy policy) { State().policy = policy; }
+
+  // Smallest request that uses the huge page policy.  Smaller requests would
+  // waste most of a huge page.
+  static size_t threshold() { return State().threshold; }
+  static void set_threshold(size_t bytes) { State().threshold = bytes; }
+
+  // Memory for bytes bytes, or NULL if the policy does not apply.
+  static void *Allocate(size_t bytes) {
+#ifdef __linux__
+    GlobalState& state = State();
+    PagePolicy policy = state.policy;
+    if (policy == PagePolicy::DEFAULT || bytes == 0 || bytes < state.threshold) {
+      return NULL;
+    }
+    size_t size = RoundUp(bytes);
+    Region region = {size, false};
+    void *ptr = NULL;
+    if (policy == PagePolicy::HUGETLB) {
+      ptr = MapHugetlb(size);
+      region.hugetlb = ptr != NULL;
+    }
+    if (ptr == NULL) {
+      ptr = MapTransparent(size);
+    }
+    if (ptr == NULL) {
+      return NULL;
+    }
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (policy == PagePolicy::HUGETLB && !region.hugetlb) {
+      ++state.num_fallbacks;
+    }
+    state.regions[ptr] = region;
+    state.num_regions.store(state.regions.size(), std::memory_order_release);
+    return ptr;
+#else
+    return NULL;
+#endif
+  }
+
+  // Release memory from Allocate().  Returns false (and does nothing) if ptr
+  // did not come from Allocate().  Every Matrix::deallocate() calls this, so
+  // without live regions (e.g., with the DEFAULT policy) it does not lock.
+  static bool Free(void *ptr) {
+#ifdef __linux__
+    GlobalState& state = State();
+    if (state.num_regions.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto it = state.regions.find(ptr);
+    if (it == state.regions.end()) {
+      return false;
+    }
+    munmap(ptr, it->second.size);
+    state.regions.erase(it);
+    state.num_regions.store(state.regions.size(), std::memory_order_release);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // Statistics for the live allocations.  The transparent huge page count is
+  // read from /proc/self/smaps, so it reflects the pages that have been
+  // touched so far.
+  static HugePageStats Stats() {
+    GlobalState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    HugePageStats stats = {0, 0, 0, 0, state.num_fallbacks};
+    for (auto& kv : state.regions) {
+      ++stats.num_allocations;
+      stats.bytes += kv.second.size;
+      if (kv.second.hugetlb) {
+        stats.hugetlb_bytes += kv.second.size;
+      }
+    }
+    stats.transparent_bytes = TransparentBytes(state.regions);
+    return stats;
+  }
+
+  // Print the policy, what the kernel allows, and what was obtained.
+  static void PrintStats(std::ostream& out=std::cout) {
+    HugePageStats stats = Stats();
+    out << "Huge pages: policy " << PolicyName(policy())
+        << ", transparent huge pages " << TransparentSetting() << std::endl;
+    out << "  " << stats.num_allocations << " allocations, " << (stats.bytes >> 20)
+        << " MB mapped, " << (stats.hugetlb_bytes >> 20) << " MB explicit huge pages, "
+        << (stats.transparent_bytes >> 20) << " MB transparent huge pages, "
+        << stats.num_fallbacks << " fallbacks from explicit huge pages" << std::endl;
+  }
+
+  static std::string PolicyName(PagePolicy policy) {
+    switch (policy) {
+    case PagePolicy::TRANSPARENT_HUGE:
+      return "transparent";
+    case PagePolicy::HUGETLB:
+      return "hugetlb";
+    default:
+      return "default";
+    }
+  }
+
+  // The kernel's transparent huge page mode, e.g., "madvise", or "unavailable".
+  static std::string TransparentSetting() {
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string line;
+    if (!std::getline(file, line)) {
+      return "unavailable";
+    }
+    size_t start = line.find('[');
+    size_t end = line.find(']');
+    if (start == std::string::npos || end == std::string::npos || end < start) {
+      return line;
+    }
+    return line.substr(start + 1, end - start - 1);
+  }
+
+private:
+  struct Region {
+    size_t size;
+    bool hugetlb;
+  };
+
+  struct GlobalState {
+    GlobalState() : policy(PagePolicy::DEFAULT), threshold(kHugePageSize),
+                    num_fallbacks(0), num_regions(0) {}
+    PagePolicy policy;
+    size_t threshold;
+    long num_fallbacks;
+    std::map<void *, Region> regions;
+    // regions.size(), which Free() reads without the lock.
+    std::atomic<long> num_regions;
+    std::mutex mutex;
+  };
+
+  static GlobalState& State() {
+    static GlobalState state;
+    return state;
+  }
+
+  static size_t RoundUp(size_t bytes) {
+    return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  }
+
+#ifdef __linux__
+  static void *MapHugetlb(size_t size) {
+# ifdef MAP_HUGETLB
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+# else
+    return NULL;
+# endif
+  }
+
+  // Map an extra huge page and trim both ends so that the memory is aligned
+  // to a huge page, which the kernel needs to use huge pages for all of it.
+  static void *MapTransparent(size_t size) {
+    size_t padded = size + kHugePageSize;
+    void *raw = mmap(NULL, padded, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      return NULL;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (aligned > start) {
+      munmap(raw, aligned - start);
+    }
+    size_t tail = start + padded - (aligned + size);
+    if (tail > 0) {
+      munmap(reinterpret_cast<void *>(aligned + size), tail);
+    }
+    void *ptr = reinterpret_cast<void *>(aligned);
+# ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+# endif
+    return ptr;
+  }
+#endif
+
+  // Sum of AnonHugePages in /proc/self/smaps over the mappings that overlap
+  // the transparent huge page regions.
+  static long TransparentBytes(const std::map<void *, Region>& regions) {
+    long total = 0;
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool overlaps = false;
+    while (std::getline(smaps, line)) {
+      uintptr_t start, end;
+      char dash;
+      std::istringstream header(line);
+      if (line.find("AnonHugePages:") == 0) {
+        if (overlaps) {
+          std::istringstream value(line.substr(14));
+          long kb = 0;
+          value >> kb;
+          total += kb << 10;
+        }
+      } else if (header >> std::hex >> start >> dash >> end && dash == '-') {
+        overlaps = false;
+        for (auto& kv : regions) {
+          uintptr_t begin = reinterpret_cast<uintptr_t>(kv.first);
+          if (!kv.second.hugetlb && begin < end && begin + kv.second.size > start) {
+            overlaps = true;
+            break;
+          }
+        }
+      }
+    }
+    return total;
+  }
+};
+
+#endif  // _HUGE_PAGES_HPP_
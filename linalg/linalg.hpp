@@ -16,9 +16,7 @@
 # include <omp.h>
 #endif
 
-#if defined(_PARALLEL_) || defined(__INTEL_MKL__)
-# include "mkl.h"
-#endif
+#include "blas_backend.hpp"
 
 #include <assert.h>
 #include <cstddef>
@@ -27,7 +25,13 @@
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
+#include "fused_gemm.hpp"
+#include "huge_pages.hpp"
+#include "simd_add.hpp"
+#include "stack_arena.hpp"
+#include "task_pool.hpp"
 #include "timing.hpp"
 
 
@@ -145,14 +149,28 @@ public:
     }
   }
 
+  // Memory comes from the current stack arena, if there is one with room,
+  // and then from huge pages if the page policy applies (see HugePages).
   void allocate() {
     if (n_ > 0 && m_ > 0) {
       assert(stride_ >= m_);
+      size_t size = static_cast<size_t>(stride_) * n_;
+      StackArena *arena = StackArena::Current();
+      if (arena != NULL) {
+        data_ = static_cast<Scalar *>(arena->Allocate(sizeof(Scalar) * size));
+        if (data_ != NULL) {
+          return;
+        }
+      }
+      data_ = static_cast<Scalar *>(HugePages::Allocate(sizeof(Scalar) * size));
+      if (data_ != NULL) {
+        return;
+      }
 #ifdef __INTEL_MKL__
       int alignment = 32;
-      data_ = static_cast<Scalar *>(mkl_malloc(sizeof(Scalar) * m_ * n_, alignment));
+      data_ = static_cast<Scalar *>(mkl_malloc(sizeof(Scalar) * size, alignment));
 #else
-      data_ = new Scalar[m_ * n_];
+      data_ = new Scalar[size];
 #endif
       assert(data_ != NULL);
     }
@@ -161,11 +179,16 @@ public:
 
   void deallocate() {
     if (data_ != NULL) {
+      StackArena *arena = StackArena::Current();
+      if (arena != NULL && arena->Owns(data_)) {
+        arena->Free(data_);
+      } else if (!HugePages::Free(data_)) {
 #ifdef __INTEL_MKL__
-      mkl_free(data_);
+        mkl_free(data_);
 #else
-      delete[] data_;
+        delete[] data_;
 #endif
+      }
       data_ = NULL;
     }
   }
@@ -192,6 +215,34 @@ private:
 };
 
 
+// Column strides whose size in bytes is a multiple of kAliasingBytes map the
+// columns of a matrix to a few cache sets (only 8 of the 64 sets of a
+// typical L1 cache, at 512 bytes), which shows up as sharp dips in GEMM and
+// addition performance at sizes like 4096.
+const int kAliasingBytes = 512;
+
+// Columns this short do not span enough sets to matter.
+const int kMinPaddedColumnBytes = 4096;
+
+// Leading dimension of an internal m-row temporary: m, plus one cache line
+// (StackArena::kAlignment) if the columns would alias as above.
+template <typename Scalar>
+int TemporaryStride(int m) {
+  long bytes = static_cast<long>(m) * sizeof(Scalar);
+  if (bytes < kMinPaddedColumnBytes || bytes % kAliasingBytes != 0) {
+    return m;
+  }
+  return m + static_cast<int>(StackArena::kAlignment / sizeof(Scalar));
+}
+
+
+// An m x n temporary with the leading dimension from TemporaryStride.
+template <typename Scalar>
+Matrix<Scalar> TemporaryMatrix(int m, int n, Scalar multiplier=Scalar(1.0)) {
+  return Matrix<Scalar>(NULL, TemporaryStride<Scalar>(m), m, n, multiplier, false);
+}
+
+
 // Perform one step of dynamic peeling in the multiplication
 //            C = A * B + beta C
 // This should be called once at the end of a recursive fast
@@ -244,6 +295,80 @@ void DynamicPeeling(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C,
 }
 
 
+// The GEMMs of DynamicPeeling for the rows of C below the part computed by
+// the fast algorithm and the columns to its right.  They do not depend on the
+// fast part, so they can run alongside it: if in_tasks, they are launched as
+// tasks (see SpawnTask), which the caller must wait for before returning.
+template<typename Scalar>
+void PeelFringe(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C, int dim1, int dim2,
+                int dim3, Scalar beta, bool in_tasks) {
+  int extra_rows_A = A.m() - (A.m() / dim1) * dim1;
+  int extra_cols_B = B.n() - (B.n() / dim3) * dim3;
+
+  // Far right columns of C
+  if (extra_cols_B > 0) {
+    SpawnTask(in_tasks, [&A, &B, &C, extra_cols_B, beta] {
+      int start_ind = B.n() - extra_cols_B;
+      Matrix<Scalar> B_extra = B.Submatrix(0, start_ind, B.m(), extra_cols_B);
+      Matrix<Scalar> C_extra = C.Submatrix(0, start_ind, C.m(), extra_cols_B);
+      MatMul(A, B_extra, C_extra, beta);
+    });
+  }
+
+  // Bottom rows of C
+  if (extra_rows_A > 0) {
+    SpawnTask(in_tasks, [&A, &B, &C, extra_rows_A, extra_cols_B, beta] {
+      int start_ind = A.m() - extra_rows_A;
+      int num_cols = B.n() - extra_cols_B;
+      Matrix<Scalar> A_extra = A.Submatrix(start_ind, 0, extra_rows_A, A.n());
+      Matrix<Scalar> B_extra = B.Submatrix(0, 0, B.m(), num_cols);
+      Matrix<Scalar> C_extra = C.Submatrix(start_ind, 0, extra_rows_A, num_cols);
+      MatMul(A_extra, B_extra, C_extra, beta);
+    });
+  }
+}
+
+
+// The GEMM of DynamicPeeling for the inner dimension, applied before the
+// output additions instead of after them:
+//
+//    C_core <-- A(:, extra) * B(extra, :) + beta * C_core,
+//
+// where C_core is the part of C computed by the fast algorithm.  The output
+// additions must then add to C_core, so the return value is their beta: 1 if
+// this wrote C_core and beta otherwise.  With in_tasks, the GEMM is a task,
+// which the caller must wait for before the output additions.
+//
+// done runs once C_core is ready for the output additions: in the task after
+// the GEMM, or right away if there is nothing to update.
+template<typename Scalar, typename Func>
+Scalar PeelInnerDimension(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C, int dim1,
+                          int dim2, int dim3, Scalar beta, bool in_tasks, Func done) {
+  int extra_cols_A = A.n() - (A.n() / dim2) * dim2;
+  int row_dim = (A.m() / dim1) * dim1;
+  int col_dim = (B.n() / dim3) * dim3;
+  if (extra_cols_A == 0 || row_dim == 0 || col_dim == 0) {
+    done();
+    return beta;
+  }
+  SpawnTask(in_tasks, [&A, &B, &C, extra_cols_A, row_dim, col_dim, beta, done] {
+    int inner_dim_start = A.n() - extra_cols_A;
+    Matrix<Scalar> A_extra = A.Submatrix(0, inner_dim_start, row_dim, extra_cols_A);
+    Matrix<Scalar> B_extra = B.Submatrix(inner_dim_start, 0, extra_cols_A, col_dim);
+    Matrix<Scalar> C_extra = C.Submatrix(0, 0, row_dim, col_dim);
+    MatMul(A_extra, B_extra, C_extra, beta);
+    done();
+  });
+  return Scalar(1.0);
+}
+
+template<typename Scalar>
+Scalar PeelInnerDimension(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C, int dim1,
+                          int dim2, int dim3, Scalar beta, bool in_tasks) {
+  return PeelInnerDimension(A, B, C, dim1, dim2, dim3, beta, in_tasks, [] {});
+}
+
+
 // Streams out all entries in the matrix.
 template <typename Scalar>
 std::ostream& operator<<(std::ostream& os, Matrix<Scalar>& mat) {
@@ -264,11 +389,89 @@ void MatMul(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C,
   assert(A.m() == C.m() && A.n() == B.m() && B.n() == C.n());
   assert(A.m() > 0 && A.n() > 0);
   Scalar alpha = C.multiplier();
+  if (LeafGemm() == GemmBackend::NATIVE) {
+    NativeGemm(A.m(), B.n(), A.n(), A.data(), A.stride(), B.data(), B.stride(), C.data(),
+               C.stride(), alpha, beta);
+    return;
+  }
   blas::Gemm('N', 'N', A.m(), B.n(), A.n(), A.data(), A.stride(), B.data(),
              B.stride(), C.data(), C.stride(), alpha, beta);
 }
 
 
+// One multiply C <-- alpha * A * B of a batch (see BatchedMatMul).  A is
+// m x k, B is k x n, and C is m x n.
+template <typename Scalar>
+struct GemmBatchEntry {
+  GemmBatchEntry(Matrix<Scalar>& A_mat, Matrix<Scalar>& B_mat, Matrix<Scalar>& C_mat) :
+    m(A_mat.m()), n(B_mat.n()), k(A_mat.n()), A(A_mat.data()), lda(A_mat.stride()),
+    B(B_mat.data()), ldb(B_mat.stride()), C(C_mat.data()), ldc(C_mat.stride()),
+    alpha(C_mat.multiplier()) {}
+  int m, n, k;
+  Scalar *A;
+  int lda;
+  Scalar *B;
+  int ldb;
+  Scalar *C;
+  int ldc;
+  Scalar alpha;
+};
+
+
+// Run every multiply of the batch.  The outputs must not overlap.  With the
+// BLAS backend and a library that has gemm_batch, this is one call, which
+// leaves the load balancing to the library.  Otherwise the multiplies are
+// split over the threads and each runs on one thread.
+template <typename Scalar>
+void BatchedMatMul(std::vector< GemmBatchEntry<Scalar> >& batch) {
+  int count = static_cast<int>(batch.size());
+  if (count == 0) {
+    return;
+  }
+#ifdef BLAS_HAS_GEMM_BATCH
+  if (LeafGemm() == GemmBackend::BLAS) {
+    std::vector<int> m(count), n(count), k(count), lda(count), ldb(count), ldc(count);
+    std::vector<Scalar *> A(count), B(count), C(count);
+    std::vector<Scalar> alpha(count);
+    for (int i = 0; i < count; ++i) {
+      GemmBatchEntry<Scalar>& entry = batch[i];
+      m[i] = entry.m;
+      n[i] = entry.n;
+      k[i] = entry.k;
+      A[i] = entry.A;
+      lda[i] = entry.lda;
+      B[i] = entry.B;
+      ldb[i] = entry.ldb;
+      C[i] = entry.C;
+      ldc[i] = entry.ldc;
+      alpha[i] = entry.alpha;
+    }
+    blas::GemmBatch(count, &m[0], &n[0], &k[0], &A[0], &lda[0], &B[0], &ldb[0], &C[0],
+                    &ldc[0], &alpha[0]);
+    return;
+  }
+#endif
+#ifdef _PARALLEL_
+# pragma omp parallel
+#endif
+  {
+    int num_threads = blas::NativeThreadsLocal();
+    blas::SetNumThreadsLocal(1);
+#ifdef _PARALLEL_
+# pragma omp for schedule(dynamic)
+#endif
+    for (int i = 0; i < count; ++i) {
+      GemmBatchEntry<Scalar>& entry = batch[i];
+      Matrix<Scalar> A(entry.A, entry.lda, entry.m, entry.k);
+      Matrix<Scalar> B(entry.B, entry.ldb, entry.k, entry.n);
+      Matrix<Scalar> C(entry.C, entry.ldc, entry.m, entry.n, entry.alpha);
+      MatMul(A, B, C);
+    }
+    blas::SetNumThreadsLocal(num_threads);
+  }
+}
+
+
 // C <-- alpha * A + C.  n is the number of entries.
 template<typename Scalar>
 void AxpyWrap(Scalar *C, Scalar *A, int n, Scalar alpha) {
@@ -407,6 +610,84 @@ void UpdateAddDaxpy(Matrix<Scalar>& A1,
 }
 
 
+// Inside a task (sequential = true), an addition of more than this many
+// entries is split into ranges of columns that idle threads can take (see
+// TaskLoop).  This keeps the additions of the top-level tasks off the critical
+// path when there are fewer tasks than threads.  0 turns the splitting off.
+inline int& AddTaskGrain() {
+  static int grain = 1 << 16;
+  return grain;
+}
+
+
+// Run body(begin, end) on ranges of the n columns of an addition with m rows:
+// with a parallel for over the columns, or, if sequential, with TaskLoop in
+// ranges of about AddTaskGrain() entries.
+template <typename Body>
+void ForAddColumns(int m, int n, bool sequential, Body body) {
+#ifdef _PARALLEL_
+  if (!sequential) {
+# pragma omp parallel for
+    for (int j = 0; j < n; ++j) {
+      body(j, j + 1);
+    }
+    return;
+  }
+  int grain = AddTaskGrain() > 0 ? std::max(1, AddTaskGrain() / std::max(m, 1)) : n;
+  TaskLoop(0, n, grain, body);
+#else
+  body(0, n);
+#endif
+}
+
+
+// C <-- sum_{t < N} coeffs[t] * A_t + beta * C, where the data of A_t starts
+// at data[t] and has leading dimension strides[t].  C is not read if beta is
+// zero.  Each column goes to the vectorized kernel in simd_add.hpp.  Large
+// write-once outputs are written with non-temporal stores.
+template <typename Scalar, int N>
+void MultiAdd(const Scalar * const *data, const int *strides, const Scalar *coeffs,
+              Matrix<Scalar>& C, bool sequential, Scalar beta=Scalar(0.0)) {
+  const int strideC = C.stride();
+  Scalar *dataC = C.data();
+  SimdLevel level = ActiveSimdLevel();
+  bool nontemporal = beta == Scalar(0.0) &&
+    UseNonTemporalStores(sizeof(Scalar) * static_cast<long>(C.m()) * C.n());
+  ForAddColumns(C.m(), C.n(), sequential, [&](int begin, int end) {
+      for (int j = begin; j < end; ++j) {
+        const Scalar *columns[N];
+        for (int t = 0; t < N; ++t) {
+          columns[t] = data[t] + static_cast<long>(j) * strides[t];
+        }
+        MultiAddColumn<Scalar, N>(dataC + static_cast<long>(j) * strideC, columns, coeffs,
+                                  C.m(), beta, level, nontemporal);
+      }
+    });
+}
+
+
+// Same as MultiAdd, but each column of C is formed in cache-resident blocks,
+// with at most kAddMaxStreams operands read at once (see simd_add.hpp).
+// This pays off for long additions; add_benchmark measures where.
+template <typename Scalar, int N>
+void BlockedMultiAdd(const Scalar * const *data, const int *strides, const Scalar *coeffs,
+                     Matrix<Scalar>& C, bool sequential, Scalar beta=Scalar(0.0)) {
+  const int strideC = C.stride();
+  Scalar *dataC = C.data();
+  SimdLevel level = ActiveSimdLevel();
+  ForAddColumns(C.m(), C.n(), sequential, [&](int begin, int end) {
+      for (int j = begin; j < end; ++j) {
+        const Scalar *columns[N];
+        for (int t = 0; t < N; ++t) {
+          columns[t] = data[t] + static_cast<long>(j) * strides[t];
+        }
+        BlockedMultiAddColumn<Scalar, N>(dataC + static_cast<long>(j) * strideC, columns,
+                                         coeffs, C.m(), beta, level);
+      }
+    });
+}
+
+
 // C := 0
 template <typename Scalar>
 void ZeroOut(Matrix<Scalar>& C) {
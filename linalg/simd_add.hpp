@@ -0,0 +1,367 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _SIMD_ADD_HPP_
+#define _SIMD_ADD_HPP_
+
+// Vectorized kernels for the multi-operand additions that form the S, T, and
+// M matrices:
+//
+//    c[i] = sum_{t < N} coeffs[t] * data[t][i] + beta * c[i],  0 <= i < m.
+//
+// The additions are bandwidth bound, so the kernels read every operand once
+// and write c once.  There are AVX2 and AVX-512 versions for float and
+// double, with aligned and unaligned loads.  They are compiled with target
+// attributes, so the build does not need -mavx2, and the instruction set is
+// picked at run time from the CPU features.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# define _SIMD_ADD_X86_
+# include <immintrin.h>
+# define _AVX2_TARGET_ __attribute__((target("avx2,fma")))
+# define _AVX512_TARGET_ __attribute__((target("avx512f")))
+#endif
+
+
+enum class SimdLevel {SCALAR, AVX2, AVX512};
+
+// The widest instruction set that the CPU and the OS support.
+inline SimdLevel DetectSimdLevel() {
+#ifdef _SIMD_ADD_X86_
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::AVX2;
+  }
+#endif
+  return SimdLevel::SCALAR;
+}
+
+// The instruction set that the addition kernels use.  It can be lowered
+// (e.g., to SimdLevel::SCALAR for comparisons), but not raised above what
+// DetectSimdLevel() returns.
+inline SimdLevel& ActiveSimdLevel() {
+  static SimdLevel level = DetectSimdLevel();
+  return level;
+}
+
+
+// Size of the last-level cache, from sysfs, or 8 MB if it is unknown.
+inline long DetectLastLevelCacheBytes() {
+  long bytes = 0;
+  for (int index = 0; ; ++index) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", index);
+    std::ifstream file(path);
+    long size = 0;
+    char unit = 'K';
+    if (!(file >> size)) {
+      break;
+    }
+    file >> unit;
+    bytes = std::max(bytes, unit == 'M' ? size << 20 : size << 10);
+  }
+  return bytes > 0 ? bytes : 8L << 20;
+}
+
+inline long LastLevelCacheBytes() {
+  static long bytes = DetectLastLevelCacheBytes();
+  return bytes;
+}
+
+// A write-once destination (beta = 0) that is much larger than the last-level
+// cache will not be in cache when it is read again, so writing it with
+// non-temporal stores saves the read-for-ownership of every cache line.
+// Destinations of at least this fraction of the last-level cache use them.
+inline double& NonTemporalFraction() {
+  static double fraction = 0.5;
+  return fraction;
+}
+
+inline bool UseNonTemporalStores(long bytes) {
+  return bytes >= NonTemporalFraction() * LastLevelCacheBytes();
+}
+
+
+// Elements [begin, end) of the column, without vector instructions.
+template <typename Scalar, int N>
+void MultiAddScalar(Scalar *c, const Scalar * const *data, const Scalar *coeffs,
+                    int begin, int end, Scalar beta) {
+  if (beta != Scalar(0.0)) {
+    for (int i = begin; i < end; ++i) {
+      Scalar val = beta * c[i];
+      for (int t = 0; t < N; ++t) {
+        val += coeffs[t] * data[t][i];
+      }
+      c[i] = val;
+    }
+  } else {
+    for (int i = begin; i < end; ++i) {
+      Scalar val = coeffs[0] * data[0][i];
+      for (int t = 1; t < N; ++t) {
+        val += coeffs[t] * data[t][i];
+      }
+      c[i] = val;
+    }
+  }
+}
+
+
+#ifdef _SIMD_ADD_X86_
+// Vector operations for each instruction set and scalar type.
+template <typename Scalar> struct Avx2Ops;
+template <typename Scalar> struct Avx512Ops;
+
+template <> struct Avx2Ops<double> {
+  typedef __m256d Vec;
+  static const int kWidth = 4;
+  _AVX2_TARGET_ static Vec Set1(double v) { return _mm256_set1_pd(v); }
+  _AVX2_TARGET_ static Vec Load(const double *p) { return _mm256_load_pd(p); }
+  _AVX2_TARGET_ static Vec LoadU(const double *p) { return _mm256_loadu_pd(p); }
+  _AVX2_TARGET_ static void Store(double *p, Vec v) { _mm256_store_pd(p, v); }
+  _AVX2_TARGET_ static void Stream(double *p, Vec v) { _mm256_stream_pd(p, v); }
+  _AVX2_TARGET_ static Vec Mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+  _AVX2_TARGET_ static Vec Fmadd(Vec a, Vec b, Vec c) { return _mm256_fmadd_pd(a, b, c); }
+};
+
+template <> struct Avx2Ops<float> {
+  typedef __m256 Vec;
+  static const int kWidth = 8;
+  _AVX2_TARGET_ static Vec Set1(float v) { return _mm256_set1_ps(v); }
+  _AVX2_TARGET_ static Vec Load(const float *p) { return _mm256_load_ps(p); }
+  _AVX2_TARGET_ static Vec LoadU(const float *p) { return _mm256_loadu_ps(p); }
+  _AVX2_TARGET_ static void Store(float *p, Vec v) { _mm256_store_ps(p, v); }
+  _AVX2_TARGET_ static void Stream(float *p, Vec v) { _mm256_stream_ps(p, v); }
+  _AVX2_TARGET_ static Vec Mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+  _AVX2_TARGET_ static Vec Fmadd(Vec a, Vec b, Vec c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+template <> struct Avx512Ops<double> {
+  typedef __m512d Vec;
+  static const int kWidth = 8;
+  _AVX512_TARGET_ static Vec Set1(double v) { return _mm512_set1_pd(v); }
+  _AVX512_TARGET_ static Vec Load(const double *p) { return _mm512_load_pd(p); }
+  _AVX512_TARGET_ static Vec LoadU(const double *p) { return _mm512_loadu_pd(p); }
+  _AVX512_TARGET_ static void Store(double *p, Vec v) { _mm512_store_pd(p, v); }
+  _AVX512_TARGET_ static void Stream(double *p, Vec v) { _mm512_stream_pd(p, v); }
+  _AVX512_TARGET_ static Vec Mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+  _AVX512_TARGET_ static Vec Fmadd(Vec a, Vec b, Vec c) { return _mm512_fmadd_pd(a, b, c); }
+};
+
+template <> struct Avx512Ops<float> {
+  typedef __m512 Vec;
+  static const int kWidth = 16;
+  _AVX512_TARGET_ static Vec Set1(float v) { return _mm512_set1_ps(v); }
+  _AVX512_TARGET_ static Vec Load(const float *p) { return _mm512_load_ps(p); }
+  _AVX512_TARGET_ static Vec LoadU(const float *p) { return _mm512_loadu_ps(p); }
+  _AVX512_TARGET_ static void Store(float *p, Vec v) { _mm512_store_ps(p, v); }
+  _AVX512_TARGET_ static void Stream(float *p, Vec v) { _mm512_stream_ps(p, v); }
+  _AVX512_TARGET_ static Vec Mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+  _AVX512_TARGET_ static Vec Fmadd(Vec a, Vec b, Vec c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+
+// Vector loop over [begin, end), where c + begin is aligned to a vector and
+// end - begin is a multiple of the vector width.  The operands are read with
+// aligned loads if Aligned is true.  The AVX2 and AVX-512 versions are the
+// same code, but they need different target attributes.
+template <typename Ops, int N, bool Aligned, typename Scalar>
+_AVX2_TARGET_ void MultiAddAvx2(Scalar *c, const Scalar * const *data, const Scalar *coeffs,
+                                int begin, int end, Scalar beta, bool nontemporal) {
+  typedef typename Ops::Vec Vec;
+  Vec vcoeffs[N];
+  for (int t = 0; t < N; ++t) {
+    vcoeffs[t] = Ops::Set1(coeffs[t]);
+  }
+  Vec vbeta = Ops::Set1(beta);
+  bool scale = beta != Scalar(0.0);
+  for (int i = begin; i < end; i += Ops::kWidth) {
+    Vec val = Aligned ? Ops::Load(data[0] + i) : Ops::LoadU(data[0] + i);
+    val = Ops::Mul(vcoeffs[0], val);
+    for (int t = 1; t < N; ++t) {
+      Vec op = Aligned ? Ops::Load(data[t] + i) : Ops::LoadU(data[t] + i);
+      val = Ops::Fmadd(vcoeffs[t], op, val);
+    }
+    if (scale) {
+      val = Ops::Fmadd(vbeta, Ops::Load(c + i), val);
+    }
+    if (nontemporal) {
+      Ops::Stream(c + i, val);
+    } else {
+      Ops::Store(c + i, val);
+    }
+  }
+  if (nontemporal) {
+    _mm_sfence();
+  }
+}
+
+template <typename Ops, int N, bool Aligned, typename Scalar>
+_AVX512_TARGET_ void MultiAddAvx512(Scalar *c, const Scalar * const *data, const Scalar *coeffs,
+                                    int begin, int end, Scalar beta, bool nontemporal) {
+  typedef typename Ops::Vec Vec;
+  Vec vcoeffs[N];
+  for (int t = 0; t < N; ++t) {
+    vcoeffs[t] = Ops::Set1(coeffs[t]);
+  }
+  Vec vbeta = Ops::Set1(beta);
+  bool scale = beta != Scalar(0.0);
+  for (int i = begin; i < end; i += Ops::kWidth) {
+    Vec val = Aligned ? Ops::Load(data[0] + i) : Ops::LoadU(data[0] + i);
+    val = Ops::Mul(vcoeffs[0], val);
+    for (int t = 1; t < N; ++t) {
+      Vec op = Aligned ? Ops::Load(data[t] + i) : Ops::LoadU(data[t] + i);
+      val = Ops::Fmadd(vcoeffs[t], op, val);
+    }
+    if (scale) {
+      val = Ops::Fmadd(vbeta, Ops::Load(c + i), val);
+    }
+    if (nontemporal) {
+      Ops::Stream(c + i, val);
+    } else {
+      Ops::Store(c + i, val);
+    }
+  }
+  if (nontemporal) {
+    _mm_sfence();
+  }
+}
+
+
+// Split the column into a scalar head (until c is aligned), a vector body,
+// and a scalar tail.  The body uses aligned loads if every operand is
+// aligned at the start of the body.  Only the body can use non-temporal
+// stores, since they need an aligned vector.
+template <typename Ops, int N, typename Scalar, typename AlignedKernel,
+          typename UnalignedKernel>
+void MultiAddVector(Scalar *c, const Scalar * const *data, const Scalar *coeffs, int m,
+                    Scalar beta, bool nontemporal, AlignedKernel aligned_kernel,
+                    UnalignedKernel unaligned_kernel) {
+  const uintptr_t kBytes = Ops::kWidth * sizeof(Scalar);
+  int head = 0;
+  while (head < m && reinterpret_cast<uintptr_t>(c + head) % kBytes != 0) {
+    ++head;
+  }
+  int body_end = head + (m - head) / Ops::kWidth * Ops::kWidth;
+  MultiAddScalar<Scalar, N>(c, data, coeffs, 0, head, beta);
+  bool aligned = true;
+  for (int t = 0; t < N; ++t) {
+    aligned &= reinterpret_cast<uintptr_t>(data[t] + head) % kBytes == 0;
+  }
+  if (aligned) {
+    aligned_kernel(c, data, coeffs, head, body_end, beta, nontemporal);
+  } else {
+    unaligned_kernel(c, data, coeffs, head, body_end, beta, nontemporal);
+  }
+  MultiAddScalar<Scalar, N>(c, data, coeffs, body_end, m, beta);
+}
+#endif  // _SIMD_ADD_X86_
+
+
+#ifdef _SIMD_ADD_X86_
+// The kernels for float and double.
+template <typename Scalar, int N>
+void MultiAddColumn(Scalar *c, const Scalar * const *data, const Scalar *coeffs, int m,
+                    Scalar beta, SimdLevel level, bool nontemporal, std::true_type) {
+  switch (level) {
+  case SimdLevel::AVX512:
+    MultiAddVector<Avx512Ops<Scalar>, N>(
+        c, data, coeffs, m, beta, nontemporal, MultiAddAvx512<Avx512Ops<Scalar>, N, true, Scalar>,
+        MultiAddAvx512<Avx512Ops<Scalar>, N, false, Scalar>);
+    break;
+  case SimdLevel::AVX2:
+    MultiAddVector<Avx2Ops<Scalar>, N>(
+        c, data, coeffs, m, beta, nontemporal, MultiAddAvx2<Avx2Ops<Scalar>, N, true, Scalar>,
+        MultiAddAvx2<Avx2Ops<Scalar>, N, false, Scalar>);
+    break;
+  default:
+    MultiAddScalar<Scalar, N>(c, data, coeffs, 0, m, beta);
+    break;
+  }
+}
+#endif
+
+// Other scalar types have no vector kernels.
+template <typename Scalar, int N, typename HasVectorKernels>
+void MultiAddColumn(Scalar *c, const Scalar * const *data, const Scalar *coeffs, int m,
+                    Scalar beta, SimdLevel level, bool nontemporal, HasVectorKernels) {
+  MultiAddScalar<Scalar, N>(c, data, coeffs, 0, m, beta);
+}
+
+
+// c[i] = sum_{t < N} coeffs[t] * data[t][i] + beta * c[i] for 0 <= i < m,
+// with the instruction set level.  c is not read if beta is zero.  If
+// nontemporal is true, the vector stores bypass the cache (see
+// UseNonTemporalStores()).
+template <typename Scalar, int N>
+void MultiAddColumn(Scalar *c, const Scalar * const *data, const Scalar *coeffs, int m,
+                    Scalar beta, SimdLevel level, bool nontemporal=false) {
+#ifdef _SIMD_ADD_X86_
+  typedef std::integral_constant<bool, std::is_same<Scalar, double>::value ||
+                                 std::is_same<Scalar, float>::value> HasVectorKernels;
+#else
+  typedef std::false_type HasVectorKernels;
+#endif
+  MultiAddColumn<Scalar, N>(c, data, coeffs, m, beta, level, nontemporal,
+                            HasVectorKernels());
+}
+
+
+// Cache blocking for long additions.  Summing all N operands in one pass
+// keeps N + 1 streams in flight, which is more than the hardware prefetchers
+// track once N gets large.  The blocked additions instead cut each column of
+// C into blocks of kAddBlockBytes, which stay in L1, and add the operands to
+// a block in passes over at most kAddMaxStreams operands each.
+const int kAddBlockBytes = 16384;
+const int kAddMaxStreams = 8;
+
+// The passes over one block: the first pass applies beta and later passes
+// accumulate into the block.
+template <typename Scalar, int N>
+struct MultiAddPasses {
+  static void Run(Scalar *c, const Scalar * const *data, const Scalar *coeffs, int m,
+                  Scalar beta, SimdLevel level) {
+    const int kPass = N < kAddMaxStreams ? N : kAddMaxStreams;
+    MultiAddColumn<Scalar, kPass>(c, data, coeffs, m, beta, level);
+    MultiAddPasses<Scalar, N - kPass>::Run(c, data + kPass, coeffs + kPass, m,
+                                           Scalar(1.0), level);
+  }
+};
+
+template <typename Scalar>
+struct MultiAddPasses<Scalar, 0> {
+  static void Run(Scalar *c, const Scalar * const *data, const Scalar *coeffs, int m,
+                  Scalar beta, SimdLevel level) {}
+};
+
+
+// Same result as MultiAddColumn, computed block by block.
+template <typename Scalar, int N>
+void BlockedMultiAddColumn(Scalar *c, const Scalar * const *data, const Scalar *coeffs,
+                           int m, Scalar beta, SimdLevel level) {
+  const int kBlockRows = kAddBlockBytes / sizeof(Scalar);
+  const Scalar *block_data[N];
+  for (int i = 0; i < m; i += kBlockRows) {
+    for (int t = 0; t < N; ++t) {
+      block_data[t] = data[t] + i;
+    }
+    int rows = m - i < kBlockRows ? m - i : kBlockRows;
+    MultiAddPasses<Scalar, N>::Run(c + i, block_data, coeffs, rows, beta, level);
+  }
+}
+
+#endif  // _SIMD_ADD_HPP_
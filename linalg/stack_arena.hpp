@@ -0,0 +1,156 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _STACK_ARENA_HPP_
+#define _STACK_ARENA_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "huge_pages.hpp"
+
+// A stack allocator over one preallocated slab of memory.  The sequential
+// recursion allocates its temporaries depth first, so they can be taken from
+// the top of the stack and released in (nearly) the reverse order.  Blocks
+// that are freed out of order are marked and popped once everything above
+// them has been freed.
+//
+// While an arena is installed with ArenaScope, Matrix::allocate() takes
+// memory from it and falls back to the heap if the arena is full.
+class StackArena {
+public:
+  // Every block starts on a cache line.
+  static const size_t kAlignment = 64;
+
+  StackArena() : capacity_(0), top_(0), high_water_(0) {}
+
+  explicit StackArena(size_t capacity) : StackArena() {
+    Reserve(capacity);
+  }
+
+  StackArena(StackArena&& that) = default;
+  StackArena& operator=(StackArena&& that) = default;
+
+  // Replace the slab with one of at least capacity bytes.  The arena must be
+  // empty.
+  void Reserve(size_t capacity) {
+    capacity_ = RoundUp(capacity);
+    slab_.reset();
+    if (capacity_ > 0) {
+      char *slab = static_cast<char *>(HugePages::Allocate(capacity_ + kAlignment));
+      slab_.reset(slab != NULL ? slab : new char[capacity_ + kAlignment]);
+    }
+    top_ = 0;
+    high_water_ = 0;
+    blocks_.clear();
+    blocks_.reserve(64);
+  }
+
+  // Memory for bytes bytes from the top of the stack, or NULL if it does not
+  // fit.
+  void *Allocate(size_t bytes) {
+    bytes = RoundUp(bytes);
+    if (slab_ == NULL || top_ + bytes > capacity_) {
+      return NULL;
+    }
+    Block block = {top_, false};
+    blocks_.push_back(block);
+    void *ptr = base() + top_;
+    top_ += bytes;
+    if (top_ > high_water_) {
+      high_water_ = top_;
+    }
+    return ptr;
+  }
+
+  // Release memory that was returned by Allocate().
+  void Free(void *ptr) {
+    size_t offset = static_cast<char *>(ptr) - base();
+    for (int i = static_cast<int>(blocks_.size()) - 1; i >= 0; --i) {
+      if (blocks_[i].offset == offset) {
+        blocks_[i].freed = true;
+        break;
+      }
+    }
+    while (!blocks_.empty() && blocks_.back().freed) {
+      top_ = blocks_.back().offset;
+      blocks_.pop_back();
+    }
+  }
+
+  // True if ptr points into the slab.
+  bool Owns(const void *ptr) const {
+    if (slab_ == NULL) {
+      return false;
+    }
+    const char *p = static_cast<const char *>(ptr);
+    return p >= base() && p < base() + capacity_;
+  }
+
+  size_t capacity() const { return capacity_; }
+  // Largest number of bytes in use at once.
+  size_t high_water() const { return high_water_; }
+
+  // Round up to a multiple of the block alignment.
+  static size_t RoundUp(size_t bytes) {
+    return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  // The arena that Matrix::allocate() uses on the calling thread, or NULL.
+  // It is per thread, so sequential multiplies can run on several threads at
+  // once, each with its own arena.
+  static StackArena *& Current() {
+    static thread_local StackArena *current = NULL;
+    return current;
+  }
+
+private:
+  struct Block {
+    size_t offset;
+    bool freed;
+  };
+
+  char *base() const {
+    uintptr_t addr = reinterpret_cast<uintptr_t>(slab_.get());
+    return reinterpret_cast<char *>(RoundUp(addr));
+  }
+
+  // The slab may come from huge pages.
+  struct SlabDeleter {
+    void operator()(char *slab) const {
+      if (!HugePages::Free(slab)) {
+        delete[] slab;
+      }
+    }
+  };
+
+  std::unique_ptr<char[], SlabDeleter> slab_;
+  size_t capacity_;
+  size_t top_;
+  size_t high_water_;
+  std::vector<Block> blocks_;
+};
+
+
+// Install an arena for Matrix::allocate() on the calling thread for the
+// lifetime of this object.
+class ArenaScope {
+public:
+  explicit ArenaScope(StackArena *arena) : previous_(StackArena::Current()) {
+    StackArena::Current() = arena;
+  }
+  ~ArenaScope() { StackArena::Current() = previous_; }
+
+private:
+  StackArena *previous_;
+};
+
+#endif  // _STACK_ARENA_HPP_
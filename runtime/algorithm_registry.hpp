@@ -0,0 +1,101 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _ALGORITHM_REGISTRY_HPP_
+#define _ALGORITHM_REGISTRY_HPP_
+
+// Look up the coefficient files of the generated algorithms by the name of
+// their header (e.g., "fast424_26_257"), so that the run-time recursion can
+// use the same algorithms.  This mirrors codegen/gen_all_algorithms.sh.
+
+#include "fast_algorithm.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct AlgorithmInfo {
+  const char *name;
+  const char *coeff_file;  // Relative to codegen/algorithms
+  int m;
+  int k;
+  int n;
+};
+
+const AlgorithmInfo kAlgorithmRegistry[] = {
+  {"smirnov336_40_960", "smirnov336-40-960", 3, 3, 6},
+  {"smirnov363_40_960", "smirnov363-40-960", 3, 6, 3},
+  {"smirnov633_40_960", "smirnov633-40-960", 6, 3, 3},
+  {"tichavsky_kovac336_40_960", "tichavsky_kovac336-40-960", 3, 3, 6},
+  {"tichavsky_kovac363_40_960", "tichavsky_kovac363-40-960", 3, 6, 3},
+  {"fast522_18_99", "grey522-18-99", 5, 2, 2},
+  {"fast252_18_99", "grey252-18-99", 2, 5, 2},
+  {"fast442_26_257", "grey442-26-257", 4, 4, 2},
+  {"fast424_26_257", "grey424-26-257", 4, 2, 4},
+  {"fast424_26_206", "eliminated/grey424-26-206", 4, 2, 4},
+  {"fast433_29_234", "grey433-29-234", 4, 3, 3},
+  {"fast343_29_234", "grey343-29-234", 3, 4, 3},
+  {"fast432_20_144", "grey432-20-144", 4, 3, 2},
+  {"fast423_20_144", "grey423-20-144", 4, 2, 3},
+  {"fast324_20_144", "grey324-20-144", 3, 2, 4},
+  {"fast342_20_144", "grey342-20-144", 3, 4, 2},
+  {"fast234_20_144", "grey234-20-144", 2, 3, 4},
+  {"fast243_20_144", "grey243-20-144", 2, 4, 3},
+  {"classical423", "classical423-24-72", 4, 2, 3},
+  {"fast422_14_84", "grey422-14-84", 4, 2, 2},
+  {"fast333_23_152", "grey333-23-152", 3, 3, 3},
+  {"fast333_23_221", "grey333-23-221", 3, 3, 3},
+  {"fast333_23_125", "eliminated/grey333-23-125", 3, 3, 3},
+  {"smirnov333_23_139", "smirnov333-23-139", 3, 3, 3},
+  {"smirnov333_23_128", "eliminated/smirnov333-23-128", 3, 3, 3},
+  {"classical333", "classical333-27-81", 3, 3, 3},
+  {"schonhage333_21_117_approx", "schonhage333-21-117-approx", 3, 3, 3},
+  {"smirnov333_20_182_approx", "smirnov333-20-182-approx", 3, 3, 3},
+  {"fast332_15_103", "grey332-15-103", 3, 3, 2},
+  {"fast323_15_103", "grey323-15-103", 3, 2, 3},
+  {"hk332_15_94", "hk332-15-94", 3, 3, 2},
+  {"hk323_15_94", "hk323-15-94", 3, 2, 3},
+  {"hk323_15_84", "eliminated/hk323-15-84", 3, 2, 3},
+  {"fast323_15_89", "eliminated/grey323-15-89", 3, 2, 3},
+  {"fast322_11_50", "grey322-11-50", 3, 2, 2},
+  {"bini322_10_52_approx", "bini322-10-52-approx", 3, 2, 2},
+  {"strassen", "strassen", 2, 2, 2},
+  {"classical222", "classical222-8-24", 2, 2, 2},
+};
+
+
+// Load the algorithm with the given name.  coeff_dir is the directory of
+// the coefficient files.
+FastAlgorithm LoadAlgorithm(std::string name, std::string coeff_dir="codegen/algorithms",
+                            double x=1e-8) {
+  for (const AlgorithmInfo& info : kAlgorithmRegistry) {
+    if (name == info.name) {
+      return FastAlgorithm(coeff_dir + "/" + info.coeff_file, info.m, info.k, info.n, x);
+    }
+  }
+  throw std::runtime_error("Unknown algorithm " + name);
+}
+
+
+// Load a comma-separated list of algorithms, e.g.,
+// "fast424_26_257,fast333_23_152,strassen".  The i-th algorithm is used at the
+// i-th level of the recursion.
+std::vector<FastAlgorithm> LoadAlgorithms(std::string names,
+                                          std::string coeff_dir="codegen/algorithms") {
+  std::vector<FastAlgorithm> algs;
+  std::stringstream names_stream(names);
+  std::string name;
+  while (std::getline(names_stream, name, ',')) {
+    algs.push_back(LoadAlgorithm(name, coeff_dir));
+  }
+  return algs;
+}
+
+#endif  // _ALGORITHM_REGISTRY_HPP_
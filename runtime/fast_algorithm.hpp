@@ -0,0 +1,293 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _FAST_ALGORITHM_HPP_
+#define _FAST_ALGORITHM_HPP_
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// A linear combination sum_i coeffs[i] * X_{inds[i]} of matrix blocks.
+// The meaning of the indices depends on where the combination is used
+// (see FastAlgorithm below).
+struct LinearCombination {
+  std::vector<int> inds;
+  std::vector<double> coeffs;
+
+  int size() const { return static_cast<int>(inds.size()); }
+};
+
+
+// Evaluate a coefficient from a coefficient file.  This is the same grammar
+// that parse_coeff in codegen/gen.py accepts:
+//
+//     * --> *i | -* | *p | [a-z] | [floating point number]
+//     p --> 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9
+//     *i --> 1 / (*)
+//     -* --> -(*)
+//     *p --> (*)^p
+//
+// So -x2i is evaluated as - (1 / ((x)^2)).  Any single letter is treated as
+// the parameter x.
+double EvalCoeff(const std::string& coeff, double x) {
+  if (coeff.empty()) {
+    throw std::runtime_error("Cannot parse empty coefficient");
+  }
+
+  // First try to convert to a float.
+  const char *begin = coeff.c_str();
+  char *end = NULL;
+  double val = strtod(begin, &end);
+  if (end != begin && *end == '\0') {
+    return val;
+  }
+
+  if (coeff.size() == 1) {
+    // Parameterized coefficient, e.g., 'x'.
+    return x;
+  } else if (coeff[0] == '(') {
+    if (coeff[coeff.size() - 1] != ')') {
+      throw std::runtime_error("Cannot parse coefficient: " + coeff);
+    }
+    double sum = 0.0;
+    std::stringstream terms(coeff.substr(1, coeff.size() - 2));
+    std::string term;
+    while (std::getline(terms, term, '+')) {
+      sum += EvalCoeff(term, x);
+    }
+    return sum;
+  } else if (coeff[0] == '-') {
+    return -EvalCoeff(coeff.substr(1), x);
+  } else if (coeff[coeff.size() - 1] == 'i') {
+    return 1.0 / EvalCoeff(coeff.substr(0, coeff.size() - 1), x);
+  } else if (isdigit(coeff[0])) {
+    // Multiplier out in front
+    return (coeff[0] - '0') * EvalCoeff(coeff.substr(1), x);
+  } else if (isdigit(coeff[coeff.size() - 1])) {
+    // Exponent
+    int exp = coeff[coeff.size() - 1] - '0';
+    return pow(EvalCoeff(coeff.substr(0, coeff.size() - 1), x), exp);
+  }
+  throw std::runtime_error("Cannot parse coefficient: " + coeff);
+}
+
+
+// A fast matrix multiplication algorithm for the <m, k, n> base case that is
+// read at run time from a coefficient file.  The file format is the same one
+// used by codegen/gen.py: the U, V, and W coefficients, optionally followed by
+// the substitution coefficients from common subexpression elimination for
+// the A, B, and M matrices.  Groups are separated by lines starting with '#'.
+//
+// Indexing conventions for the linear combinations:
+//   - S(r) and T(r) index the m * k (resp. k * n) subblocks of A (resp. B) in
+//     row-major order, followed by the eliminated subexpressions A_X (B_X).
+//   - C(i) indexes the rank multiplications M1, ..., MR followed by the
+//     eliminated subexpressions M_X.
+//   - AX(i), BX(i), and MX(i) use the same indexing as S, T, and C.
+//
+// All of the combinations are built once when the algorithm is loaded, so the
+// recursion only needs to walk them.
+class FastAlgorithm {
+public:
+  FastAlgorithm(std::string coeff_file, int m, int k, int n, double x=1e-8) :
+    coeff_file_(coeff_file), m_(m), k_(k), n_(n), rank_(0) {
+    Read();
+    set_x(x);
+  }
+
+  int m() const { return m_; }
+  int k() const { return k_; }
+  int n() const { return n_; }
+  int rank() const { return rank_; }
+  double x() const { return x_; }
+
+  // Name of the algorithm, taken from the coefficient file name.
+  std::string name() const {
+    size_t start = coeff_file_.find_last_of('/');
+    return coeff_file_.substr(start == std::string::npos ? 0 : start + 1);
+  }
+
+  // Number of eliminated subexpressions for A, B, and M.
+  int num_AX() const { return static_cast<int>(AX_.size()); }
+  int num_BX() const { return static_cast<int>(BX_.size()); }
+  int num_MX() const { return static_cast<int>(MX_.size()); }
+
+  // Combination of A blocks used in the r-th multiplication (0-indexed).
+  const LinearCombination& S(int r) const { return S_[r]; }
+  // Combination of B blocks used in the r-th multiplication (0-indexed).
+  const LinearCombination& T(int r) const { return T_[r]; }
+  // Combination of multiplications for the i-th block of C (row-major).
+  const LinearCombination& C(int i) const { return C_[i]; }
+
+  const LinearCombination& AX(int i) const { return AX_[i]; }
+  const LinearCombination& BX(int i) const { return BX_[i]; }
+  const LinearCombination& MX(int i) const { return MX_[i]; }
+
+  // True if the i-th block of C reads only multiplications (no eliminated
+  // subexpression), so that it can be formed once they are done.
+  bool early_output(int i) const { return early_outputs_[i]; }
+  // The early blocks of C that read the r-th multiplication.
+  const std::vector<int>& outputs_of(int r) const { return outputs_of_[r]; }
+
+  // Re-evaluate all of the coefficients with a new value of the parameter x.
+  // This only matters for approximate algorithms (e.g., Bini's).
+  void set_x(double x) {
+    x_ = x;
+    S_ = Combinations(coeffs_[0], true);
+    T_ = Combinations(coeffs_[1], true);
+    C_ = Combinations(coeffs_[2], false);
+    AX_ = Combinations(coeffs_[3], false);
+    BX_ = Combinations(coeffs_[4], false);
+    MX_ = Combinations(coeffs_[5], false);
+    FindEarlyOutputs();
+  }
+
+private:
+  typedef std::vector< std::vector<std::string> > CoeffGroup;
+
+  // Read the coefficient groups and check that the dimensions are consistent
+  // with the <m, k, n> base case.
+  void Read() {
+    std::ifstream coeff_file(coeff_file_.c_str());
+    if (!coeff_file) {
+      throw std::runtime_error("Could not open coefficient file " + coeff_file_);
+    }
+
+    CoeffGroup curr_group;
+    std::string line;
+    while (std::getline(coeff_file, line)) {
+      if (line.size() > 0 && line[0] == '#') {
+        if (curr_group.size() > 0) {
+          coeffs_.push_back(curr_group);
+          curr_group.clear();
+        }
+        continue;
+      }
+      std::vector<std::string> row;
+      std::stringstream vals(line);
+      std::string val;
+      while (vals >> val) {
+        row.push_back(val);
+      }
+      if (row.size() > 0) {
+        curr_group.push_back(row);
+      }
+    }
+    if (curr_group.size() > 0) {
+      coeffs_.push_back(curr_group);
+    }
+
+    // There should be three sets of coefficients: one for each matrix.
+    if (coeffs_.size() < 3) {
+      throw std::runtime_error("Expected three sets of coefficients in " + coeff_file_);
+    }
+    // Missing substitution groups mean no common subexpression elimination.
+    coeffs_.resize(6);
+
+    rank_ = static_cast<int>(coeffs_[0][0].size());
+    CheckGroup(coeffs_[0], m_ * k_, rank_, false, "U");
+    CheckGroup(coeffs_[1], k_ * n_, rank_, false, "V");
+    int num_MX = static_cast<int>(coeffs_[5].size());
+    CheckGroup(coeffs_[2], m_ * n_, rank_ + num_MX, true, "W");
+    int num_AX = static_cast<int>(coeffs_[0].size()) - m_ * k_;
+    int num_BX = static_cast<int>(coeffs_[1].size()) - k_ * n_;
+    if (static_cast<int>(coeffs_[3].size()) != num_AX ||
+        static_cast<int>(coeffs_[4].size()) != num_BX) {
+      throw std::runtime_error("Substitution coefficients do not match U and V in " +
+                               coeff_file_);
+    }
+  }
+
+  // Check that every row in the group has num_cols entries and that there
+  // are num_rows rows (or at least num_rows rows if extra rows are allowed
+  // for the eliminated subexpressions).
+  void CheckGroup(const CoeffGroup& group, int num_rows, int num_cols,
+                  bool exact_rows, std::string group_name) {
+    int rows = static_cast<int>(group.size());
+    if (rows < num_rows || (exact_rows && rows != num_rows)) {
+      throw std::runtime_error("Wrong number of rows for " + group_name + " in " +
+                               coeff_file_);
+    }
+    for (const std::vector<std::string>& row : group) {
+      if (static_cast<int>(row.size()) != num_cols) {
+        throw std::runtime_error("Wrong number of columns for " + group_name +
+                                 " in " + coeff_file_);
+      }
+    }
+  }
+
+  // Evaluate the nonzero coefficients of a group.  If by_column is true, there
+  // is one combination per column of the group (U and V); otherwise there is
+  // one combination per row (W and the substitutions).
+  void FindEarlyOutputs() {
+    early_outputs_.assign(C_.size(), true);
+    outputs_of_.assign(rank_, std::vector<int>());
+    for (int i = 0; i < static_cast<int>(C_.size()); ++i) {
+      for (int ind : C_[i].inds) {
+        early_outputs_[i] = early_outputs_[i] && ind < rank_;
+      }
+      for (int ind : C_[i].inds) {
+        if (early_outputs_[i]) {
+          outputs_of_[ind].push_back(i);
+        }
+      }
+    }
+  }
+
+  std::vector<LinearCombination> Combinations(const CoeffGroup& group, bool by_column) {
+    std::vector<LinearCombination> combos;
+    if (group.empty()) {
+      return combos;
+    }
+    int num_rows = static_cast<int>(group.size());
+    int num_cols = static_cast<int>(group[0].size());
+    int num_combos = by_column ? num_cols : num_rows;
+    int combo_len = by_column ? num_rows : num_cols;
+    combos.resize(num_combos);
+    for (int c = 0; c < num_combos; ++c) {
+      for (int i = 0; i < combo_len; ++i) {
+        const std::string& coeff = by_column ? group[i][c] : group[c][i];
+        double val = EvalCoeff(coeff, x_);
+        if (val != 0.0) {
+          combos[c].inds.push_back(i);
+          combos[c].coeffs.push_back(val);
+        }
+      }
+    }
+    return combos;
+  }
+
+  std::string coeff_file_;
+  int m_;
+  int k_;
+  int n_;
+  int rank_;
+  double x_;
+
+  // Raw coefficients: U, V, W, and the A, B, and M substitutions.
+  std::vector<CoeffGroup> coeffs_;
+
+  std::vector<LinearCombination> S_;
+  std::vector<LinearCombination> T_;
+  std::vector<LinearCombination> C_;
+  std::vector<LinearCombination> AX_;
+  std::vector<LinearCombination> BX_;
+  std::vector<LinearCombination> MX_;
+
+  std::vector<bool> early_outputs_;
+  std::vector< std::vector<int> > outputs_of_;
+};
+
+#endif  // _FAST_ALGORITHM_HPP_
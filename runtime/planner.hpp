@@ -0,0 +1,231 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _PLANNER_HPP_
+#define _PLANNER_HPP_
+
+// An autotuning planner for the generated algorithms.  Candidate algorithms
+// are benchmarked on the local machine and the winner for each problem shape,
+// number of threads, and parallel mode is stored in a tuning database (a
+// plain text file).  At call time, Plan() is just a lookup in that database.
+//
+// Each line of the database is
+//
+//     mode num_threads m k n algorithm num_steps time
+//
+// where mode is one of SEQ, DFS, BFS, HYBRID, algorithm is the name from
+// Alg2Str, and time is the median time in milliseconds.  An algorithm of MKL
+// (with zero steps) means that no fast algorithm beat the classical one.
+
+#include "all_algorithms.hpp"
+#include "common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct MatmulPlan {
+  MatmulPlan(int algorithm=MKL, int num_steps=0, double time=0.0) :
+    algorithm(algorithm), num_steps(num_steps), time(time) {}
+
+  int algorithm;
+  int num_steps;
+  double time;  // Median time in milliseconds, as measured when tuning.
+};
+
+
+// The parallel mode that this code was compiled with.
+std::string ParallelMode() {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _DFS_PAR_)
+  return "DFS";
+#elif defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_)
+  return "BFS";
+#elif defined(_PARALLEL_) && (_PARALLEL_ == _HYBRID_PAR_)
+  return "HYBRID";
+#else
+  return "SEQ";
+#endif
+}
+
+
+// Inverse of Alg2Str.
+int Str2Alg(std::string name) {
+  // SMIRNOV54 is the last entry of the algorithm enum.
+  for (int algorithm = MKL; algorithm <= SMIRNOV54; ++algorithm) {
+    if (Alg2Str(algorithm) == name) {
+      return algorithm;
+    }
+  }
+  throw std::logic_error("Unknown algorithm " + name);
+}
+
+
+// Median time in milliseconds over num_trials runs of multiplying
+// m x k x n with num_steps of recursion.  To just call GEMM, use MKL with
+// zero steps.
+double MedianTime(int m, int k, int n, int num_steps, int algorithm, int num_trials=5) {
+  std::vector<double> times(num_trials);
+  for (int trial = 0; trial < num_trials; ++trial) {
+    Matrix<double> A = RandomMatrix<double>(m, k);
+    Matrix<double> B = RandomMatrix<double>(k, n);
+    Matrix<double> C(m, n);
+    times[trial] = RunAlgorithm(algorithm, A, B, C, num_steps);
+  }
+  std::sort(times.begin(), times.end());
+  return times[num_trials / 2];
+}
+
+
+// Run the plan: C := A * B.  Returns the time in milliseconds.
+template <typename Scalar>
+double RunPlan(const MatmulPlan& plan, Matrix<Scalar>& A, Matrix<Scalar>& B,
+               Matrix<Scalar>& C) {
+  return RunAlgorithm(plan.algorithm, A, B, C, plan.num_steps);
+}
+
+
+class Planner {
+public:
+  // Load the tuning database, if it exists.
+  Planner(std::string db_file="fast_matmul_tuning.db") : db_file_(db_file) {
+    Load();
+  }
+
+  // Best known plan for multiplying m x k x n with num_threads threads in
+  // the parallel mode of this build.  If the shape was not tuned, the plan of
+  // the closest tuned shape is used, as long as each dimension is within a
+  // factor of two.  Otherwise, the plan falls back to the classical algorithm.
+  MatmulPlan Plan(int m, int k, int n, int num_threads) const {
+    TuningKey key(ParallelMode(), num_threads, m, k, n);
+    auto exact = plans_.find(key);
+    if (exact != plans_.end()) {
+      return exact->second;
+    }
+
+    const double max_dist = std::log(2.0);
+    double best_dist = 0.0;
+    MatmulPlan best_plan;
+    bool found = false;
+    for (const auto& entry : plans_) {
+      const TuningKey& curr = entry.first;
+      if (curr.mode != key.mode || curr.num_threads != num_threads) {
+        continue;
+      }
+      double dist_m = std::abs(std::log(double(curr.m) / m));
+      double dist_k = std::abs(std::log(double(curr.k) / k));
+      double dist_n = std::abs(std::log(double(curr.n) / n));
+      if (dist_m > max_dist || dist_k > max_dist || dist_n > max_dist) {
+        continue;
+      }
+      double dist = dist_m + dist_k + dist_n;
+      if (!found || dist < best_dist) {
+        best_dist = dist;
+        best_plan = entry.second;
+        found = true;
+      }
+    }
+    return found ? best_plan : MatmulPlan();
+  }
+
+  // Benchmark the candidate algorithms with each number of recursive steps
+  // against the classical algorithm and record the fastest in the database.
+  // The caller is responsible for running with num_threads threads.
+  MatmulPlan Tune(int m, int k, int n, int num_threads, const std::vector<int>& algorithms,
+                  const std::vector<int>& num_steps, int num_trials=5, bool verbose=false) {
+    MatmulPlan best(MKL, 0, MedianTime(m, k, n, 0, MKL, num_trials));
+    if (verbose) {
+      std::cout << Alg2Str(MKL) << "_0: " << best.time << " ms" << std::endl;
+    }
+    for (int algorithm : algorithms) {
+      for (int curr_num_steps : num_steps) {
+        double time = MedianTime(m, k, n, curr_num_steps, algorithm, num_trials);
+        if (verbose) {
+          std::cout << Alg2Str(algorithm) << "_" << curr_num_steps << ": " << time
+                    << " ms" << std::endl;
+        }
+        if (time < best.time) {
+          best = MatmulPlan(algorithm, curr_num_steps, time);
+        }
+      }
+    }
+    plans_[TuningKey(ParallelMode(), num_threads, m, k, n)] = best;
+    return best;
+  }
+
+  // Write the database back to disk.
+  void Save() const {
+    std::ofstream db(db_file_.c_str());
+    if (!db) {
+      throw std::runtime_error("Could not write tuning database " + db_file_);
+    }
+    for (const auto& entry : plans_) {
+      const TuningKey& key = entry.first;
+      const MatmulPlan& plan = entry.second;
+      db << key.mode << " " << key.num_threads << " " << key.m << " " << key.k << " "
+         << key.n << " " << Alg2Str(plan.algorithm) << " " << plan.num_steps << " "
+         << plan.time << std::endl;
+    }
+  }
+
+  int size() const { return plans_.size(); }
+
+private:
+  struct TuningKey {
+    TuningKey(std::string mode, int num_threads, int m, int k, int n) :
+      mode(mode), num_threads(num_threads), m(m), k(k), n(n) {}
+
+    bool operator<(const TuningKey& that) const {
+      if (mode != that.mode) { return mode < that.mode; }
+      if (num_threads != that.num_threads) { return num_threads < that.num_threads; }
+      if (m != that.m) { return m < that.m; }
+      if (k != that.k) { return k < that.k; }
+      return n < that.n;
+    }
+
+    std::string mode;
+    int num_threads;
+    int m;
+    int k;
+    int n;
+  };
+
+  void Load() {
+    std::ifstream db(db_file_.c_str());
+    if (!db) {
+      // No database yet.
+      return;
+    }
+    std::string line;
+    while (std::getline(db, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      std::stringstream vals(line);
+      std::string mode, alg_name;
+      int num_threads, m, k, n, num_steps;
+      double time;
+      if (!(vals >> mode >> num_threads >> m >> k >> n >> alg_name >> num_steps >> time)) {
+        throw std::runtime_error("Bad line in tuning database " + db_file_ + ": " + line);
+      }
+      plans_[TuningKey(mode, num_threads, m, k, n)] =
+        MatmulPlan(Str2Alg(alg_name), num_steps, time);
+    }
+  }
+
+  std::string db_file_;
+  std::map<TuningKey, MatmulPlan> plans_;
+};
+
+#endif  // _PLANNER_HPP_
@@ -0,0 +1,888 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _RUNTIME_MATMUL_HPP_
+#define _RUNTIME_MATMUL_HPP_
+
+// This is the run-time counterpart of the code generated by gen.py.  Instead
+// of compiling a header for every algorithm, the recursion walks the linear
+// combinations of a FastAlgorithm that was loaded from a coefficient file.
+// Each level of the recursion may use a different algorithm, so the base case
+// can be matched to the shape of the subproblems at every level.
+// The structure of the recursion (temporaries, memory manager, tasks, and
+// dynamic peeling) mirrors the generated code, so all of the parallel modes
+// work in the same way.
+
+#include "common.hpp"
+#include "block_layout.hpp"
+#include "fast_algorithm.hpp"
+#include "fused_gemm.hpp"
+#include "padding.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace runtime {
+
+// Largest number of operands that are summed in a single pass over a column.
+const int kMaxFusedOperands = 4;
+
+// If true, the recursion first forms the S and T matrices of every level and
+// collects the leaf multiplies, which then run as one batch (BatchedMatMul)
+// before the output additions.  All of the temporaries are live at once, as
+// in a BFS recursion.
+inline bool& BatchLeaves() {
+  static bool batch = false;
+  return batch;
+}
+
+// If true, the last level of the recursion forms no S, T, or M temporaries.
+// Each of its multiplies is one call to FusedGemm, which sums the blocks of
+// A and B while packing them and adds the product into every block of C that
+// uses it (see linalg/fused_gemm.hpp).
+inline bool& FuseLastLevel() {
+  static bool fuse = false;
+  return fuse;
+}
+
+// The update of dynamic peeling for the inner dimension, restricted to one
+// block of C: C <-- C + multiplier * A_extra * B_extra, where A_extra has
+// num_cols columns and B_extra is num_cols x C.n() (see PeelInnerDimension).
+// Add applies it with the M matrices, as num_cols more operands per column
+// of C, so the update takes no pass of its own over C.
+template <typename Scalar>
+struct RankUpdate {
+  RankUpdate(const Scalar *A_extra, int lda, const Scalar *B_extra, int ldb, int num_cols,
+             Scalar multiplier) :
+    A_extra(A_extra), lda(lda), B_extra(B_extra), ldb(ldb), num_cols(num_cols),
+    multiplier(multiplier) {}
+
+  const Scalar *A_extra;
+  int lda;
+  const Scalar *B_extra;
+  int ldb;
+  int num_cols;
+  Scalar multiplier;
+};
+
+
+// C <-- sum_i combo.coeffs[i] * blocks[combo.inds[i]] + beta * C,
+// plus the rank update if one is given.
+// The columns are processed one at a time and the operands are summed in
+// passes of at most kMaxFusedOperands, so the column of C stays in cache
+// between passes.
+template <typename Scalar>
+void Add(const LinearCombination& combo, std::vector< Matrix<Scalar> >& blocks,
+         Matrix<Scalar>& C, bool sequential, Scalar beta=Scalar(0.0),
+         const RankUpdate<Scalar> *update=NULL) {
+  const int num_combo = combo.size();
+  const int num_operands = num_combo + (update != NULL ? update->num_cols : 0);
+  const int strideC = C.stride();
+  Scalar *dataC = C.data();
+  SimdLevel level = ActiveSimdLevel();
+  // Non-temporal stores only pay off if the column is written in one pass.
+  bool nontemporal = num_operands <= kMaxFusedOperands && beta == Scalar(0.0) &&
+    UseNonTemporalStores(sizeof(Scalar) * static_cast<long>(C.m()) * C.n());
+  ForAddColumns(C.m(), C.n(), sequential, [&](int begin, int end) {
+      for (int j = begin; j < end; ++j) {
+        const Scalar *data[kMaxFusedOperands];
+        Scalar coeffs[kMaxFusedOperands];
+        for (int start = 0; start < num_operands; start += kMaxFusedOperands) {
+          int num_pass = std::min(kMaxFusedOperands, num_operands - start);
+          for (int t = 0; t < num_pass; ++t) {
+            int ind = start + t;
+            if (ind < num_combo) {
+              Matrix<Scalar>& block = blocks[combo.inds[ind]];
+              data[t] = block.data() + j * block.stride();
+              coeffs[t] = Scalar(combo.coeffs[ind]);
+            } else {
+              // Column p of A_extra, times entry (p, j) of B_extra.
+              int p = ind - num_combo;
+              data[t] = update->A_extra + static_cast<long>(p) * update->lda;
+              coeffs[t] = update->multiplier *
+                update->B_extra[p + static_cast<long>(j) * update->ldb];
+            }
+          }
+          Scalar *dataC_curr = dataC + j * strideC;
+          // Later passes add to the column.
+          Scalar beta_pass = start > 0 ? Scalar(1.0) : beta;
+          switch (num_pass) {
+          case 1:
+            MultiAddColumn<Scalar, 1>(dataC_curr, data, coeffs, C.m(), beta_pass, level,
+                                      nontemporal);
+            break;
+          case 2:
+            MultiAddColumn<Scalar, 2>(dataC_curr, data, coeffs, C.m(), beta_pass, level,
+                                      nontemporal);
+            break;
+          case 3:
+            MultiAddColumn<Scalar, 3>(dataC_curr, data, coeffs, C.m(), beta_pass, level,
+                                      nontemporal);
+            break;
+          default:
+            MultiAddColumn<Scalar, 4>(dataC_curr, data, coeffs, C.m(), beta_pass, level,
+                                      nontemporal);
+            break;
+          }
+        }
+      }
+    });
+}
+
+
+// Temporary of the given type for multiplication (or eliminated
+// subexpression) index of the node with the given start index.  In parallel
+// mode the memory comes from the memory manager.  The leading dimension is
+// padded (see TemporaryStride), except in the block-recursive layout, whose
+// blocks must be contiguous.
+template <typename Scalar>
+Matrix<Scalar> Temporary(MemoryManager<Scalar>& mem_mngr, int start_index, int index,
+                         int level, int type, int m, int n, bool block_recursive,
+                         Scalar multiplier=Scalar(1.0)) {
+  int stride = block_recursive ? m : TemporaryStride<Scalar>(m);
+#ifdef _PARALLEL_
+  return Matrix<Scalar>(mem_mngr.GetMem(start_index, index, level, type), stride, m, n,
+                        multiplier);
+#else
+  return Matrix<Scalar>(NULL, stride, m, n, multiplier, false);
+#endif
+}
+
+
+// Form the operand for one side of the r-th multiplication.  If the
+// combination has more than one term, the sum is formed in a temporary
+// (S or T, depending on type).  Otherwise, the operand is a view of the
+// single block and the coefficient is pushed into the multiplier of Mr.
+template <typename Scalar>
+Matrix<Scalar> FormOperand(const LinearCombination& combo, std::vector< Matrix<Scalar> >& blocks,
+                           MemoryManager<Scalar>& mem_mngr, Matrix<Scalar>& Mr,
+                           int start_index, int r, int level, int type, bool sequential,
+                           bool block_recursive) {
+  Matrix<Scalar>& block = blocks[combo.inds[0]];
+  if (combo.size() == 1) {
+    Mr.UpdateMultiplier(Scalar(combo.coeffs[0]));
+    return block.Submatrix(0, 0, block.m(), block.n());
+  }
+  Matrix<Scalar> tmp = Temporary(mem_mngr, start_index, r + 1, level, type, block.m(),
+                                 block.n(), block_recursive);
+  Add(combo, blocks, tmp, sequential);
+  return tmp;
+}
+
+
+// Coefficient of each multiply in the combination of M matrices with the
+// given index, where the indices from alg.rank() on are the eliminated
+// subexpressions of alg.MX.
+inline std::vector<double> MultiplyCoefficients(const FastAlgorithm& alg, int index) {
+  std::vector<double> coeffs(alg.rank(), 0.0);
+  if (index < alg.rank()) {
+    coeffs[index] = 1.0;
+    return coeffs;
+  }
+  const LinearCombination& combo = alg.MX(index - alg.rank());
+  for (int i = 0; i < combo.size(); ++i) {
+    std::vector<double> sub = MultiplyCoefficients(alg, combo.inds[i]);
+    for (int r = 0; r < alg.rank(); ++r) {
+      coeffs[r] += combo.coeffs[i] * sub[r];
+    }
+  }
+  return coeffs;
+}
+
+
+// The multiplies of the last level run one after another, since they all
+// add into the blocks of C.  Each one is split over the threads only if no
+// level above it runs its multiplies as tasks.
+inline bool FusedLevelIsSequential(const std::vector<int>& steps, int level) {
+#ifdef _PARALLEL_
+  for (int l = 0; l < level; ++l) {
+    if (steps[l] != _DFS_PAR_) {
+      return true;
+    }
+  }
+  return false;
+#else
+  return true;
+#endif
+}
+
+
+// C_blocks[i] <-- multiplier * sum_r gamma_ir * S_r * T_r + beta * C_blocks[i],
+// with one FusedGemm per multiply and no temporaries other than AX and BX,
+// which must already be at the end of A_blocks and B_blocks.
+template <typename Scalar>
+void FusedLastLevel(const FastAlgorithm& alg, std::vector< Matrix<Scalar> >& A_blocks,
+                    std::vector< Matrix<Scalar> >& B_blocks,
+                    std::vector< Matrix<Scalar> >& C_blocks, Scalar multiplier, Scalar beta,
+                    bool sequential) {
+  // FusedGemm accumulates, so beta is applied up front.
+  for (Matrix<Scalar>& block : C_blocks) {
+    for (int j = 0; j < block.n(); ++j) {
+      Scalar *col = block.data() + static_cast<long>(j) * block.stride();
+      for (int i = 0; i < block.m(); ++i) {
+        col[i] = beta == Scalar(0.0) ? Scalar(0.0) : beta * col[i];
+      }
+    }
+  }
+
+  // gammas[i][r] is the coefficient of multiply r in block i of C.
+  std::vector< std::vector<double> > gammas(C_blocks.size(),
+                                            std::vector<double>(alg.rank(), 0.0));
+  for (int i = 0; i < static_cast<int>(C_blocks.size()); ++i) {
+    const LinearCombination& combo = alg.C(i);
+    for (int t = 0; t < combo.size(); ++t) {
+      std::vector<double> coeffs = MultiplyCoefficients(alg, combo.inds[t]);
+      for (int r = 0; r < alg.rank(); ++r) {
+        gammas[i][r] += combo.coeffs[t] * coeffs[r];
+      }
+    }
+  }
+
+  Matrix<Scalar>& A11 = A_blocks[0];
+  Matrix<Scalar>& B11 = B_blocks[0];
+  std::vector< GemmTerm<Scalar> > A_terms, B_terms, C_terms;
+  for (int r = 0; r < alg.rank(); ++r) {
+    A_terms.clear();
+    B_terms.clear();
+    C_terms.clear();
+    const LinearCombination& S_r = alg.S(r);
+    for (int t = 0; t < S_r.size(); ++t) {
+      Matrix<Scalar>& block = A_blocks[S_r.inds[t]];
+      A_terms.push_back(GemmTerm<Scalar>(block.data(), block.stride(),
+                                         Scalar(S_r.coeffs[t])));
+    }
+    const LinearCombination& T_r = alg.T(r);
+    for (int t = 0; t < T_r.size(); ++t) {
+      Matrix<Scalar>& block = B_blocks[T_r.inds[t]];
+      B_terms.push_back(GemmTerm<Scalar>(block.data(), block.stride(),
+                                         Scalar(T_r.coeffs[t])));
+    }
+    for (int i = 0; i < static_cast<int>(C_blocks.size()); ++i) {
+      if (gammas[i][r] != 0.0) {
+        C_terms.push_back(GemmTerm<Scalar>(C_blocks[i].data(), C_blocks[i].stride(),
+                                           Scalar(gammas[i][r]) * multiplier));
+      }
+    }
+    FusedGemm(A11.m(), B11.n(), A11.n(), A_terms, B_terms, C_terms, sequential);
+  }
+}
+
+
+// The algorithms used at each level of the recursion.  Level 0 is the top of
+// the recursion tree.
+typedef std::vector<const FastAlgorithm *> AlgorithmLevels;
+
+
+// The leaf multiplies of a recursion in BatchLeaves mode, and the work of
+// each node that has to wait for them.  The temporaries that the leaves read
+// and write are kept here until Run().
+template <typename Scalar>
+class LeafBatch {
+public:
+  void AddLeaf(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C) {
+    leaves_.push_back(GemmBatchEntry<Scalar>(A, B, C));
+  }
+
+  // Keep the matrices alive until Run().  The returned vector does not move.
+  std::vector< Matrix<Scalar> >& Keep(std::vector< Matrix<Scalar> >&& mats) {
+    kept_.push_back(std::move(mats));
+    return kept_.back();
+  }
+
+  // Run func after the leaves, in the order in which it was deferred.  Nodes
+  // defer their output additions after their children, so these run from the
+  // bottom of the tree up.
+  void Defer(std::function<void ()> func) { deferred_.push_back(func); }
+
+  int num_leaves() const { return static_cast<int>(leaves_.size()); }
+
+  void Run() {
+    BatchedMatMul(leaves_);
+    for (std::function<void ()>& func : deferred_) {
+      func();
+    }
+    leaves_.clear();
+    deferred_.clear();
+    kept_.clear();
+  }
+
+private:
+  std::vector< GemmBatchEntry<Scalar> > leaves_;
+  std::vector< std::function<void ()> > deferred_;
+  std::deque< std::vector< Matrix<Scalar> > > kept_;
+};
+
+
+// ranks[l] is the rank of the algorithm at level l and steps[l] is the
+// parallel strategy at level l (see should_launch_task).  If numa is given,
+// the multiplies of this node are split over the NUMA nodes (see RunOnNodes).
+// If batch is given, the leaf multiplies and everything after them are left
+// to batch->Run(), and the multiplies of each node are formed one at a time.
+// If block_recursive, A, B, and C are in the layout of BlockRecursiveMatrix.
+template <typename Scalar>
+void FastMatmulRecursive(const AlgorithmLevels& algs, const std::vector<int>& ranks,
+                         const std::vector<int>& steps, LockAndCounter& locker, MemoryManager<Scalar>& mem_mngr,
+                         Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C,
+                         int total_steps, int steps_left, int start_index,
+                         int num_threads, Scalar beta, const NumaPartition *numa=NULL,
+                         LeafBatch<Scalar> *batch=NULL, bool block_recursive=false) {
+  // Update multipliers
+  C.UpdateMultiplier(A.multiplier());
+  C.UpdateMultiplier(B.multiplier());
+  A.set_multiplier(Scalar(1.0));
+  B.set_multiplier(Scalar(1.0));
+  // Base case for recursion
+  if (steps_left == 0) {
+    if (batch != NULL) {
+      batch->AddLeaf(A, B, C);
+    } else {
+      MatMul(A, B, C);
+    }
+    return;
+  }
+
+  const int level = total_steps - steps_left;
+  const FastAlgorithm& alg = *algs[level];
+  const int dim1 = alg.m();
+  const int dim2 = alg.k();
+  const int dim3 = alg.n();
+  const int rank = alg.rank();
+  // The children of multiply r start at index (start_index + r) * child_stride.
+  const int child_stride = steps_left > 1 ? ranks[level + 1] : 1;
+
+  // Subblocks, followed by the temporaries for eliminated subexpressions.
+  auto subblock = [block_recursive](Matrix<Scalar>& X, int num_block_rows, int num_block_cols,
+                                    int row_ind, int col_ind) {
+    if (block_recursive) {
+      return BlockRecursiveSubblock(X, num_block_rows, num_block_cols, row_ind, col_ind);
+    }
+    return X.Subblock(num_block_rows, num_block_cols, row_ind, col_ind);
+  };
+  std::vector< Matrix<Scalar> > A_blocks, B_blocks, C_blocks;
+  A_blocks.reserve(dim1 * dim2 + alg.num_AX());
+  B_blocks.reserve(dim2 * dim3 + alg.num_BX());
+  C_blocks.reserve(dim1 * dim3);
+  for (int i = 0; i < dim1; ++i) {
+    for (int j = 0; j < dim2; ++j) {
+      A_blocks.push_back(subblock(A, dim1, dim2, i + 1, j + 1));
+    }
+  }
+  for (int i = 0; i < dim2; ++i) {
+    for (int j = 0; j < dim3; ++j) {
+      B_blocks.push_back(subblock(B, dim2, dim3, i + 1, j + 1));
+    }
+  }
+  for (int i = 0; i < dim1; ++i) {
+    for (int j = 0; j < dim3; ++j) {
+      C_blocks.push_back(subblock(C, dim1, dim3, i + 1, j + 1));
+    }
+  }
+  Matrix<Scalar>& A11 = A_blocks[0];
+  Matrix<Scalar>& B11 = B_blocks[0];
+  Matrix<Scalar>& C11 = C_blocks[0];
+
+  // Handle common subexpression elimination on the S and T matrices.
+  for (int i = 0; i < alg.num_AX(); ++i) {
+    A_blocks.push_back(Temporary(mem_mngr, start_index, i + 1, level, AX, A11.m(),
+                                 A11.n(), block_recursive));
+    Add(alg.AX(i), A_blocks, A_blocks.back(), false);
+  }
+  for (int i = 0; i < alg.num_BX(); ++i) {
+    B_blocks.push_back(Temporary(mem_mngr, start_index, i + 1, level, BX, B11.m(),
+                                 B11.n(), block_recursive));
+    Add(alg.BX(i), B_blocks, B_blocks.back(), false);
+  }
+
+  if (steps_left == 1 && FuseLastLevel()) {
+    FusedLastLevel(alg, A_blocks, B_blocks, C_blocks, C.multiplier(), beta,
+                   FusedLevelIsSequential(steps, level));
+#ifdef _PARALLEL_
+    for (int r = 0; r < rank; ++r) {
+      locker.Decrement();
+    }
+    if (total_steps == steps_left) {
+      blas::SetNumThreadsLocal(num_threads);
+      blas::SetDynamic(false);
+    }
+#endif
+    DynamicPeeling(A, B, C, dim1, dim2, dim3, beta);
+    return;
+  }
+
+  // Matrices to store the results of multiplications, followed by the
+  // temporaries for eliminated subexpressions.
+  std::vector< Matrix<Scalar> > M_mats;
+  M_mats.reserve(rank + alg.num_MX());
+  for (int r = 0; r < rank; ++r) {
+    M_mats.push_back(Temporary(mem_mngr, start_index, r + 1, level, M, C11.m(), C11.n(),
+                               block_recursive, C.multiplier()));
+  }
+
+  // Form the operands of the r-th multiplication and recurse, with
+  // leaf_threads BLAS threads for the leaf multiplies if it is positive.  The
+  // count is only set around the recursion, since forming the operands may
+  // reach task scheduling points (see ScopedLeafThreads).
+  auto multiply = [&](int r, bool sequential, int leaf_threads) {
+    Matrix<Scalar>& Mr = M_mats[r];
+    Matrix<Scalar> Sr = FormOperand(alg.S(r), A_blocks, mem_mngr, Mr, start_index, r,
+                                    level, S, sequential, block_recursive);
+    Matrix<Scalar> Tr = FormOperand(alg.T(r), B_blocks, mem_mngr, Mr, start_index, r,
+                                    level, T, sequential, block_recursive);
+    {
+      ScopedLeafThreads scoped_threads(leaf_threads);
+      FastMatmulRecursive(algs, ranks, steps, locker, mem_mngr, Sr, Tr, Mr, total_steps,
+                          steps_left - 1, (start_index + r) * child_stride, num_threads,
+                          Scalar(0.0), NULL, batch, block_recursive);
+    }
+    if (batch != NULL) {
+      std::vector< Matrix<Scalar> > operands;
+      operands.push_back(std::move(Sr));
+      operands.push_back(std::move(Tr));
+      batch->Keep(std::move(operands));
+    }
+  };
+
+  if (batch != NULL) {
+    for (int r = 0; r < rank; ++r) {
+      multiply(r, false, 0);
+    }
+    std::vector< Matrix<Scalar> >& M_kept = batch->Keep(std::move(M_mats));
+    std::vector< Matrix<Scalar> >& C_kept = batch->Keep(std::move(C_blocks));
+    batch->Keep(std::move(A_blocks));
+    batch->Keep(std::move(B_blocks));
+    std::vector< Matrix<Scalar> > ABC;
+    ABC.push_back(A.Submatrix(0, 0, A.m(), A.n()));
+    ABC.push_back(B.Submatrix(0, 0, B.m(), B.n()));
+    ABC.push_back(C.Submatrix(0, 0, C.m(), C.n()));
+    std::vector< Matrix<Scalar> >& ABC_kept = batch->Keep(std::move(ABC));
+    batch->Defer([&alg, &mem_mngr, &M_kept, &C_kept, &ABC_kept, start_index, level, beta,
+                  block_recursive] {
+      Matrix<Scalar>& C11 = C_kept[0];
+      for (int i = 0; i < alg.num_MX(); ++i) {
+        M_kept.push_back(Temporary(mem_mngr, start_index, i + 1, level, MX, C11.m(),
+                                   C11.n(), block_recursive));
+        Add(alg.MX(i), M_kept, M_kept.back(), false);
+      }
+      for (int i = 0; i < alg.m() * alg.n(); ++i) {
+        Add(alg.C(i), M_kept, C_kept[i], false, beta);
+      }
+      DynamicPeeling(ABC_kept[0], ABC_kept[1], ABC_kept[2], alg.m(), alg.k(), alg.n(), beta);
+    });
+    return;
+  }
+
+  // Handle edge cases with dynamic peeling.  The rows of C below the fast
+  // part and the columns to its right run alongside the multiplies, in tasks
+  // if the multiplies are tasks.
+  bool peel_tasks = false;
+#ifdef _PARALLEL_
+  const TaskSchedule& schedule = locker.schedule() != NULL ? *locker.schedule() :
+    TaskSchedule::Get(ranks, steps, num_threads);
+  peel_tasks = numa == NULL && schedule.launch(level, start_index, 1);
+#endif
+  PeelFringe(A, B, C, dim1, dim2, dim3, beta, peel_tasks);
+
+  // Add the multiplication blocks to form the i-th block of C.  The update
+  // of dynamic peeling for the inner dimension is applied by the same
+  // addition.
+  const int extra_inner = A.n() - dim2 * A11.n();
+  const int inner_start = A.n() - extra_inner;
+  auto add_output = [&](int i, bool sequential) {
+    int row = (i / dim3) * C11.m();
+    int col = (i % dim3) * C11.n();
+    RankUpdate<Scalar> update(A.data(row, inner_start), A.stride(), B.data(inner_start, col),
+                              B.stride(), extra_inner, C.multiplier());
+    Add(alg.C(i), M_mats, C_blocks[i], sequential, beta, extra_inner > 0 ? &update : NULL);
+  };
+
+  // In parallel, the blocks of C that read only multiplies are formed by
+  // whichever task finishes the last of them (see InputCountdown), while
+  // the other multiplies still run.
+  bool early_adds = false;
+#ifdef _PARALLEL_
+  early_adds = true;
+  std::vector<InputCountdown> inputs(dim1 * dim3);
+  for (int i = 0; i < dim1 * dim3; ++i) {
+    inputs[i].Reset(alg.C(i).size());
+  }
+  auto add_ready_outputs = [&](int r, bool sequential) {
+    for (int i : alg.outputs_of(r)) {
+      if (inputs[i].Ready()) {
+        add_output(i, sequential);
+      }
+    }
+  };
+#endif
+
+  bool on_nodes = false;
+#ifdef _PARALLEL_
+  if (numa != NULL) {
+    RunOnNodes(*numa, rank, [&](int r) {
+        multiply(r, true, 0);
+        add_ready_outputs(r, true);
+      });
+    on_nodes = true;
+  }
+#endif
+  for (int r = 0; r < rank && !on_nodes; ++r) {
+#ifdef _PARALLEL_
+    bool sequential = schedule.launch(level, start_index, r + 1);
+    SpawnTask(sequential, [&, r, sequential] {
+      multiply(r, sequential, schedule.threads(level, start_index, r + 1));
+      add_ready_outputs(r, sequential);
+      locker.Decrement();
+    });
+    if (schedule.wait(level, start_index, r + 1)) {
+      TaskWait();
+# if _PARALLEL_ == _HYBRID_PAR_
+      // Remainder groups wait for each other, but the switch is only at the
+      // end of the BFS part.
+      if (steps[level] == _HYBRID_PAR_ && r + 1 != rank &&
+          schedule.threads(level, start_index, r + 1) == 0) {
+        SwitchToDFS(locker, num_threads);
+      }
+# endif
+    }
+#else
+    multiply(r, false, 0);
+#endif
+  }
+
+  // Handle common subexpression elimination on the M matrices.
+  for (int i = 0; i < alg.num_MX(); ++i) {
+    M_mats.push_back(Temporary(mem_mngr, start_index, i + 1, level, MX, C11.m(),
+                               C11.n(), block_recursive));
+    Add(alg.MX(i), M_mats, M_mats.back(), false);
+  }
+
+  // Form the rest of the output.
+  for (int i = 0; i < dim1 * dim3; ++i) {
+    if (!early_adds || !alg.early_output(i)) {
+      add_output(i, false);
+    }
+  }
+
+#ifdef _PARALLEL_
+  if (peel_tasks) {
+    TaskWait();
+  }
+#endif
+}
+
+
+// Shapes of the algorithms at each level, for the memory manager.
+std::vector<LevelShape> LevelShapes(const AlgorithmLevels& algs) {
+  std::vector<LevelShape> levels;
+  for (int l = 0; l < static_cast<int>(algs.size()); ++l) {
+    const FastAlgorithm *alg = algs[l];
+    // Operands that are a single block do not need an S or T temporary.
+    // The fused last level does not form them at all (see FuseLastLevel).
+    bool fused = FuseLastLevel() && l + 1 == static_cast<int>(algs.size());
+    std::vector<bool> needs_S, needs_T;
+    for (int r = 0; r < alg->rank(); ++r) {
+      needs_S.push_back(alg->S(r).size() > 1 && !fused);
+      needs_T.push_back(alg->T(r).size() > 1 && !fused);
+    }
+    levels.push_back(LevelShape(alg->m(), alg->k(), alg->n(), alg->rank(), alg->num_AX(),
+                                alg->num_BX(), alg->num_MX(), needs_S, needs_T));
+  }
+  return levels;
+}
+
+
+// Number of bytes of temporaries that FastMatmul allocates to multiply an
+// m x k matrix with a k x n matrix, using algs[l] at level l.  See
+// EstimateWorkspace in MemoryManager.hpp for mode and num_threads.
+template <typename Scalar>
+long EstimateWorkspace(const AlgorithmLevels& algs, int m, int k, int n, int mode,
+                       int num_threads=1) {
+  return ::EstimateWorkspace<Scalar>(LevelShapes(algs), m, k, n, mode, num_threads);
+}
+
+template <typename Scalar>
+long EstimateWorkspace(const std::vector<FastAlgorithm>& algs, int m, int k, int n,
+                       int mode, int num_threads=1) {
+  AlgorithmLevels levels;
+  for (const FastAlgorithm& alg : algs) {
+    levels.push_back(&alg);
+  }
+  return EstimateWorkspace<Scalar>(levels, m, k, n, mode, num_threads);
+}
+
+
+// Parallel strategy for each level of the recursion that keeps the
+// temporaries for an m x k x n multiplication within memory_budget_bytes.
+// BFS steps run all of the multiplies of a node at once and need the most
+// memory, and the temporaries are largest at the top of the recursion.  So,
+// as in CAPS, this takes as few DFS steps as possible at the top and BFS
+// steps below them.  Throws if even an all-DFS recursion does not fit.
+template <typename Scalar>
+std::vector<int> BudgetedParallelSteps(const AlgorithmLevels& algs, int m, int k, int n,
+                                       int num_threads, long memory_budget_bytes) {
+  std::vector<LevelShape> levels = LevelShapes(algs);
+  int num_steps = algs.size();
+  for (int num_dfs = 0; num_dfs <= num_steps; ++num_dfs) {
+    std::vector<int> steps(num_steps, _BFS_PAR_);
+    std::fill(steps.begin(), steps.begin() + num_dfs, _DFS_PAR_);
+    long bytes = MemoryManager<Scalar>::WorkspaceSize(levels, m, k, n, num_threads, steps) *
+      sizeof(Scalar);
+    if (bytes <= memory_budget_bytes) {
+      return steps;
+    }
+  }
+  throw std::runtime_error("Temporaries do not fit in the memory budget");
+}
+
+
+// C := alpha * A * B + beta * C, using algs[l] at level l of the recursion.
+// The number of recursive steps is algs.size().  The return value is the time
+// in milliseconds spent in the recursion.
+//
+// If memory_budget_bytes is positive, each level of the recursion takes a
+// BFS or DFS step so that the temporaries fit in the budget, regardless of
+// the compiled parallel mode (see BudgetedParallelSteps).  The budget does
+// not include A, B, and C, and it is ignored in sequential builds.
+//
+// If numa is given, the top-level multiplies are split over its nodes: each
+// node runs its subtrees as tasks on threads bound to the node, and their
+// temporaries are bound to the node's memory.  Every level is then a BFS
+// step, so numa cannot be combined with a memory budget.  numa is ignored in
+// sequential builds.
+//
+// If ShouldPad picks padding for the shape (see Padding()), the recursion
+// runs on zero-padded copies of A, B, and C, and the time includes the copies.
+//
+// block_recursive says that A, B, and C are the matrices of BlockRecursiveMatrix
+// objects; use the overload below for those instead.
+template <typename Scalar>
+double FastMatmul(const AlgorithmLevels& algs, Matrix<Scalar>& A, Matrix<Scalar>& B,
+                  Matrix<Scalar>& C, Scalar alpha=Scalar(1.0), Scalar beta=Scalar(0.0),
+                  long memory_budget_bytes=0, const NumaPartition *numa=NULL,
+                  bool block_recursive=false) {
+  int num_steps = algs.size();
+  std::vector<LevelShape> levels = LevelShapes(algs);
+  if (ShouldPad(levels, A.m(), A.n(), B.n())) {
+    using FpMilliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    PaddedOperands<Scalar> padded(PaddedDim(levels, A.m(), 0), PaddedDim(levels, A.n(), 1),
+                                  PaddedDim(levels, B.n(), 2));
+    padded.CopyIn(A, B, C, beta);
+    FastMatmul(algs, padded.A(), padded.B(), padded.C(), alpha, beta, memory_budget_bytes,
+               numa);
+    padded.CopyOut(C);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return FpMilliseconds(t2 - t1).count();
+  }
+  std::vector<int> ranks;
+  for (const FastAlgorithm *alg : algs) {
+    ranks.push_back(alg->rank());
+  }
+
+  MemoryManager<Scalar> mem_mngr;
+  A.set_multiplier(alpha);
+  int total_multiplies = num_leaf_multiplies(ranks);
+  std::vector<int> steps = default_parallel_steps(num_steps);
+
+  // Set parameters needed for all types of parallelism.
+  int num_threads = 0;
+#ifdef _PARALLEL_
+# pragma omp parallel
+  {
+    if (omp_get_thread_num() == 0) { num_threads = omp_get_num_threads(); }
+  }
+  omp_set_nested(1);
+  if (BatchLeaves() && (numa != NULL || memory_budget_bytes > 0)) {
+    throw std::logic_error("Batched leaves take neither NUMA placement nor a memory budget");
+  }
+  if (numa != NULL) {
+    if (memory_budget_bytes > 0) {
+      throw std::logic_error("NUMA placement does not take a memory budget");
+    }
+    steps.assign(num_steps, _BFS_PAR_);
+  } else if (BatchLeaves()) {
+    // No two temporaries share memory.
+    steps.assign(num_steps, _BFS_PAR_);
+  } else if (memory_budget_bytes > 0) {
+    steps = BudgetedParallelSteps<Scalar>(algs, A.m(), A.n(), B.n(), num_threads,
+                                          memory_budget_bytes);
+  }
+  mem_mngr.Allocate(levels, A.m(), A.n(), B.n(), num_threads, steps);
+  if (numa != NULL) {
+    mem_mngr.BindToNodes(*numa);
+  }
+
+  // Leaf multiplies in tasks run single-threaded GEMMs.
+  bool leaves_in_tasks = false;
+  for (int step : steps) {
+    leaves_in_tasks |= step == _BFS_PAR_ ||
+      (step == _HYBRID_PAR_ && num_threads <= total_multiplies);
+  }
+  if (leaves_in_tasks) {
+# pragma omp parallel
+    {
+      blas::SetNumThreadsLocal(1);
+      blas::SetDynamic(false);
+    }
+  } else {
+    blas::SetDynamic(false);
+  }
+#else
+  // Temporaries come from a stack arena instead of the heap.
+  StackArena arena;
+  ReserveSequentialArena<Scalar>(arena, levels, A.m(), A.n(), B.n());
+  ArenaScope arena_scope(&arena);
+#endif
+
+  int extra_multiplies = num_threads > 0 ? total_multiplies % num_threads : 0;
+  int groups = num_threads > 0 ?
+    RemainderGroups(levels, steps, A.m(), A.n(), B.n(), num_threads) : 1;
+  const TaskSchedule& schedule = TaskSchedule::Get(ranks, steps, num_threads, groups);
+  LockAndCounter locker(total_multiplies - extra_multiplies, &schedule);
+  using FpMilliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  LeafBatch<Scalar> batch;
+  LeafBatch<Scalar> *batch_ptr = BatchLeaves() ? &batch : NULL;
+#ifdef _PARALLEL_
+  if (numa != NULL) {
+    // The top node runs outside of a parallel region, so that RunOnNodes
+    // creates the team for each node.
+    FastMatmulRecursive(algs, ranks, steps, locker, mem_mngr, A, B, C, num_steps, num_steps,
+                        0, num_threads, beta, numa, static_cast<LeafBatch<Scalar> *>(NULL),
+                        block_recursive);
+  } else {
+    RunTaskParallel(num_threads, [&] {
+        if (leaves_in_tasks) {
+          blas::SetNumThreadsLocal(1);
+        }
+      }, [&] {
+        FastMatmulRecursive(algs, ranks, steps, locker, mem_mngr, A, B, C, num_steps,
+                            num_steps, 0, num_threads, beta, NULL, batch_ptr, block_recursive);
+      });
+  }
+  if (batch_ptr != NULL) {
+    // The leaves and the additions after them get all of the threads.
+    blas::SetNumThreadsLocal(num_threads);
+    batch.Run();
+  }
+#else
+  FastMatmulRecursive(algs, ranks, steps, locker, mem_mngr, A, B, C, num_steps, num_steps,
+                      0, num_threads, beta, NULL, batch_ptr, block_recursive);
+  if (batch_ptr != NULL) {
+    batch.Run();
+  }
+#endif
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return FpMilliseconds(t2 - t1).count();
+}
+
+
+// Same as above, but the algorithms are given by value, e.g.,
+//    runtime::FastMatmul({alg424, alg333, strassen}, A, B, C);
+template <typename Scalar>
+double FastMatmul(const std::vector<FastAlgorithm>& algs, Matrix<Scalar>& A,
+                  Matrix<Scalar>& B, Matrix<Scalar>& C, Scalar alpha=Scalar(1.0),
+                  Scalar beta=Scalar(0.0), long memory_budget_bytes=0,
+                  const NumaPartition *numa=NULL) {
+  AlgorithmLevels levels;
+  for (const FastAlgorithm& alg : algs) {
+    levels.push_back(&alg);
+  }
+  return FastMatmul(levels, A, B, C, alpha, beta, memory_budget_bytes, numa);
+}
+
+
+// Block-recursive storage for the operand ('A', 'B', or 'C') of a multiply
+// with algs, for a rows x cols matrix (see util/block_layout.hpp).
+template <typename Scalar>
+BlockRecursiveMatrix<Scalar> BlockRecursiveLayout(const AlgorithmLevels& algs, char operand,
+                                                  int rows, int cols) {
+  switch (operand) {
+  case 'A':
+    return BlockRecursiveMatrix<Scalar>(LevelShapes(algs), rows, cols, 0, 1);
+  case 'B':
+    return BlockRecursiveMatrix<Scalar>(LevelShapes(algs), rows, cols, 1, 2);
+  case 'C':
+    return BlockRecursiveMatrix<Scalar>(LevelShapes(algs), rows, cols, 0, 2);
+  default:
+    throw std::logic_error("Operand must be A, B, or C");
+  }
+}
+
+template <typename Scalar>
+BlockRecursiveMatrix<Scalar> BlockRecursiveLayout(const std::vector<FastAlgorithm>& algs,
+                                                  char operand, int rows, int cols) {
+  AlgorithmLevels levels;
+  for (const FastAlgorithm& alg : algs) {
+    levels.push_back(&alg);
+  }
+  return BlockRecursiveLayout<Scalar>(levels, operand, rows, cols);
+}
+
+
+// C := alpha * A * B + beta * C on matrices in the layouts of
+// BlockRecursiveLayout for algs.  Every subblock in the recursion is
+// contiguous and nothing is peeled.  Converting to and from the layout
+// (CopyFrom and CopyTo) is up to the caller, so operands that are multiplied
+// many times are only converted once.
+template <typename Scalar>
+double FastMatmul(const AlgorithmLevels& algs, BlockRecursiveMatrix<Scalar>& A,
+                  BlockRecursiveMatrix<Scalar>& B, BlockRecursiveMatrix<Scalar>& C,
+                  Scalar alpha=Scalar(1.0), Scalar beta=Scalar(0.0),
+                  long memory_budget_bytes=0) {
+  if (A.m() != C.m() || A.n() != B.m() || B.n() != C.n()) {
+    throw std::logic_error("Block-recursive operands have mismatched dimensions");
+  }
+  bool matches = A.row_blocks().size() == algs.size();
+  for (int l = 0; l < static_cast<int>(algs.size()) && matches; ++l) {
+    matches = A.row_blocks()[l] == algs[l]->m() && A.col_blocks()[l] == algs[l]->k() &&
+      B.row_blocks()[l] == algs[l]->k() && B.col_blocks()[l] == algs[l]->n() &&
+      C.row_blocks()[l] == algs[l]->m() && C.col_blocks()[l] == algs[l]->n();
+  }
+  if (!matches) {
+    throw std::logic_error("Block-recursive operands are not laid out for the algorithms");
+  }
+  // The recursion leaves alpha in the multiplier of C, and the operands are
+  // meant to be multiplied many times.
+  C.matrix().set_multiplier(Scalar(1.0));
+  return FastMatmul(algs, A.matrix(), B.matrix(), C.matrix(), alpha, beta,
+                    memory_budget_bytes, NULL, true);
+}
+
+template <typename Scalar>
+double FastMatmul(const std::vector<FastAlgorithm>& algs, BlockRecursiveMatrix<Scalar>& A,
+                  BlockRecursiveMatrix<Scalar>& B, BlockRecursiveMatrix<Scalar>& C,
+                  Scalar alpha=Scalar(1.0), Scalar beta=Scalar(0.0),
+                  long memory_budget_bytes=0) {
+  AlgorithmLevels levels;
+  for (const FastAlgorithm& alg : algs) {
+    levels.push_back(&alg);
+  }
+  return FastMatmul(levels, A, B, C, alpha, beta, memory_budget_bytes);
+}
+
+
+// C := alpha * A * B + beta * C, using num_steps of recursion with alg.
+// The return value is the time in milliseconds spent in the recursion.
+template <typename Scalar>
+double FastMatmul(const FastAlgorithm& alg, Matrix<Scalar>& A, Matrix<Scalar>& B,
+                  Matrix<Scalar>& C, int num_steps, Scalar alpha=Scalar(1.0),
+                  Scalar beta=Scalar(0.0), long memory_budget_bytes=0,
+                  const NumaPartition *numa=NULL) {
+  return FastMatmul(AlgorithmLevels(num_steps, &alg), A, B, C, alpha, beta,
+                    memory_budget_bytes, numa);
+}
+
+}  // namespace runtime
+
+#endif  // _RUNTIME_MATMUL_HPP_
@@ -7,12 +7,39 @@
    http://opensource.org/licenses/BSD-2-Clause.
 */
 
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <limits>
+#include <new>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 #include "all_algorithms.hpp"
 #include "common.hpp"
-#include "mkl.h"
+#include "planner.hpp"
+#include "algorithm_registry.hpp"
+#include "runtime_matmul.hpp"
+
+// Number of calls to operator new so far, to check that code does not
+// allocate.
+std::atomic<long> num_allocations(0);
+
+void *operator new(size_t bytes) {
+  ++num_allocations;
+  void *ptr = malloc(bytes > 0 ? bytes : 1);
+  if (ptr == NULL) {
+	throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+  free(ptr);
+}
 
 // Run the fast algorithm and standard GEMM and print out the maximum relative
 // difference between the two algorithms.
@@ -174,6 +201,620 @@ void FastMatmulTests() {
 }
 
 
+// Run algorithms that are loaded from coefficient files at run time and
+// compare them against standard GEMM.  The coefficient file paths are relative
+// to the top-level directory.
+void RuntimeTests() {
+  std::cout << "Run-time algorithm tests" << std::endl;
+  std::vector<FastAlgorithm> algs = {
+	FastAlgorithm("codegen/algorithms/strassen", 2, 2, 2),
+	FastAlgorithm("codegen/algorithms/grey323-15-103", 3, 2, 3),
+	FastAlgorithm("codegen/algorithms/eliminated/hk323-15-84", 3, 2, 3),
+	FastAlgorithm("codegen/algorithms/eliminated/grey333-23-125", 3, 3, 3),
+	FastAlgorithm("codegen/algorithms/bini322-10-52-approx", 3, 2, 2),
+  };
+  std::vector<int> m_vals = {257, 600, 1001};
+  std::vector<int> k_vals = {500, 500, 400};
+  std::vector<int> n_vals = {55, 671, 679};
+  std::vector<int> num_steps = {1, 2};
+  for (FastAlgorithm& alg : algs) {
+	for (int curr_num_steps : num_steps) {
+	  if (alg.name() == "bini322-10-52-approx") {
+		// Same values of x as in RunAlgorithm.
+		alg.set_x(curr_num_steps == 1 ? 1e-8 : 1e-4);
+	  }
+	  for (int i = 0; i < m_vals.size(); ++i) {
+		std::cout << alg.name() << "_" << curr_num_steps
+				  << ": " << m_vals[i] << ", " << k_vals[i]
+				  << ", " << n_vals[i] << std::endl;
+		double alpha = 7.0;
+		double beta = -1.3;
+		Matrix<double> A = RandomMatrix<double>(m_vals[i], k_vals[i]);
+		Matrix<double> B = RandomMatrix<double>(k_vals[i], n_vals[i]);
+		Matrix<double> C1 = RandomMatrix<double>(m_vals[i], n_vals[i]);
+		Matrix<double> C2 = C1;
+		C2.set_multiplier(alpha);
+		MatMul(A, B, C2, beta);
+		runtime::FastMatmul(alg, A, B, C1, curr_num_steps, alpha, beta);
+		std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+	  }
+	}
+  }
+
+  // A different algorithm at each level of the recursion.
+  std::vector<std::string> level_algs = {
+	"fast424_26_257,fast333_23_152,strassen",
+	"fast333_23_125,fast424_26_206",
+	"fast433_29_234,fast343_29_234,hk323_15_84",
+  };
+  for (std::string names : level_algs) {
+	std::vector<FastAlgorithm> algs = LoadAlgorithms(names);
+	for (int i = 0; i < m_vals.size(); ++i) {
+	  std::cout << names << ": " << m_vals[i] << ", " << k_vals[i]
+				<< ", " << n_vals[i] << std::endl;
+	  double alpha = -1.2;
+	  double beta = 2.5;
+	  Matrix<double> A = RandomMatrix<double>(m_vals[i], k_vals[i]);
+	  Matrix<double> B = RandomMatrix<double>(k_vals[i], n_vals[i]);
+	  Matrix<double> C1 = RandomMatrix<double>(m_vals[i], n_vals[i]);
+	  Matrix<double> C2 = C1;
+	  C2.set_multiplier(alpha);
+	  MatMul(A, B, C2, beta);
+	  runtime::FastMatmul(algs, A, B, C1, alpha, beta);
+	  std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+	}
+  }
+
+  // Memory budgets that force a mix of DFS and BFS steps.  With three steps
+  // of Strassen on this shape, all BFS needs about 140 MB and all DFS 18 MB.
+  std::vector<FastAlgorithm> strassen_algs = LoadAlgorithms("strassen,strassen,strassen");
+  for (long budget_mb : {20, 40}) {
+	std::cout << "Memory budget (MB): " << budget_mb << std::endl;
+	Matrix<double> A = RandomMatrix<double>(1001, 803);
+	Matrix<double> B = RandomMatrix<double>(803, 777);
+	Matrix<double> C1(1001, 777), C2(1001, 777);
+	MatMul(A, B, C2);
+	runtime::FastMatmul(strassen_algs, A, B, C1, 1.0, 0.0, budget_mb << 20);
+	std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+  }
+
+  // Peeling in every dimension at every level, so that the output additions
+  // take the update for the inner dimension along with the M matrices.
+  for (std::string names : {"fast433_29_234,fast343_29_234", "fast424_26_257,strassen"}) {
+	std::vector<FastAlgorithm> algs = LoadAlgorithms(names);
+	std::cout << "Peeled " << names << ": 1003, 1003, 1003" << std::endl;
+	Matrix<double> A = RandomMatrix<double>(1003, 1003);
+	Matrix<double> B = RandomMatrix<double>(1003, 1003);
+	Matrix<double> C1 = RandomMatrix<double>(1003, 1003);
+	Matrix<double> C2 = C1;
+	C2.set_multiplier(-0.7);
+	MatMul(A, B, C2, 1.5);
+	runtime::FastMatmul(algs, A, B, C1, -0.7, 1.5);
+	std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+  }
+
+  // Block-recursive operands, converted once and multiplied twice.
+  for (std::string names : {"strassen,strassen,strassen", "fast424_26_257,fast333_23_125"}) {
+	std::vector<FastAlgorithm> algs = LoadAlgorithms(names);
+	std::cout << "Block-recursive " << names << ": 1001, 803, 777" << std::endl;
+	Matrix<double> A = RandomMatrix<double>(1001, 803);
+	Matrix<double> B = RandomMatrix<double>(803, 777);
+	Matrix<double> C1 = RandomMatrix<double>(1001, 777);
+	Matrix<double> C2 = C1;
+	auto A_rec = runtime::BlockRecursiveLayout<double>(algs, 'A', 1001, 803);
+	auto B_rec = runtime::BlockRecursiveLayout<double>(algs, 'B', 803, 777);
+	auto C_rec = runtime::BlockRecursiveLayout<double>(algs, 'C', 1001, 777);
+	A_rec.CopyFrom(A);
+	B_rec.CopyFrom(B);
+	C_rec.CopyFrom(C1);
+	runtime::FastMatmul(algs, A_rec, B_rec, C_rec, 2.0, 0.5);
+	runtime::FastMatmul(algs, A_rec, B_rec, C_rec, -1.0, 1.0);
+	C_rec.CopyTo(C1);
+	// C2 := 0.5 * C2 + (2 - 1) * A * B
+	MatMul(A, B, C2, 0.5);
+	std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+  }
+
+  // All of the leaf multiplies in one batch, with peeling at every level.
+  runtime::BatchLeaves() = true;
+  for (std::string names : {"strassen,strassen,strassen", "fast333_23_125,fast323_15_103"}) {
+	std::vector<FastAlgorithm> algs = LoadAlgorithms(names);
+	std::cout << "Batched " << names << ": 1001, 803, 777" << std::endl;
+	Matrix<double> A = RandomMatrix<double>(1001, 803);
+	Matrix<double> B = RandomMatrix<double>(803, 777);
+	Matrix<double> C1 = RandomMatrix<double>(1001, 777);
+	Matrix<double> C2 = C1;
+	C2.set_multiplier(-1.5);
+	MatMul(A, B, C2, 2.0);
+	runtime::FastMatmul(algs, A, B, C1, -1.5, 2.0);
+	std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+  }
+  runtime::BatchLeaves() = false;
+
+  // The last level fused into the packing of a native GEMM, including an
+  // algorithm with eliminated subexpressions on the M matrices.
+  runtime::FuseLastLevel() = true;
+  for (std::string names : {"strassen", "strassen,fast323_15_103", "fast333_23_125"}) {
+	std::vector<FastAlgorithm> algs = LoadAlgorithms(names);
+	std::cout << "Fused " << names << ": 1001, 803, 777" << std::endl;
+	Matrix<double> A = RandomMatrix<double>(1001, 803);
+	Matrix<double> B = RandomMatrix<double>(803, 777);
+	Matrix<double> C1 = RandomMatrix<double>(1001, 777);
+	Matrix<double> C2 = C1;
+	C2.set_multiplier(3.0);
+	MatMul(A, B, C2, -0.5);
+	runtime::FastMatmul(algs, A, B, C1, 3.0, -0.5);
+	std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+  }
+  runtime::FuseLastLevel() = false;
+
+#ifdef _PARALLEL_
+  // NUMA placement on the nodes of this machine, and on three made-up nodes
+  // so that the split is exercised on a single-socket machine.
+  NumaPartition local(omp_get_max_threads());
+  NumaPartition split(std::vector< std::vector<int> >(3, local.cpus(0)), 5);
+  for (const NumaPartition *numa : {&local, &split}) {
+	std::cout << "NUMA nodes: " << numa->num_nodes() << std::endl;
+	Matrix<double> A = RandomMatrix<double>(1001, 803);
+	Matrix<double> B = RandomMatrix<double>(803, 777);
+	Matrix<double> C1 = RandomMatrix<double>(1001, 777);
+	Matrix<double> C2 = C1;
+	C2.set_multiplier(2.0);
+	MatMul(A, B, C2, 0.5);
+	runtime::FastMatmul(strassen_algs, A, B, C1, 2.0, 0.5, 0, numa);
+	std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+  }
+#endif
+}
+
+
+// The native GEMM on its own, including views with a leading dimension
+// larger than the number of rows, and as the leaf backend of the generated
+// and run-time algorithms.
+void NativeGemmTests() {
+  std::cout << "Native GEMM tests" << std::endl;
+  std::vector<int> m_vals = {1, 17, 257, 1001};
+  std::vector<int> k_vals = {3, 300, 500, 803};
+  std::vector<int> n_vals = {1, 13, 55, 777};
+  for (int i = 0; i < m_vals.size(); ++i) {
+	Matrix<double> A = RandomMatrix<double>(m_vals[i] + 5, k_vals[i]);
+	Matrix<double> B = RandomMatrix<double>(k_vals[i], n_vals[i]);
+	Matrix<double> C1 = RandomMatrix<double>(m_vals[i] + 3, n_vals[i]);
+	Matrix<double> A_view = A.Submatrix(2, 0, m_vals[i], k_vals[i]);
+	Matrix<double> C1_view = C1.Submatrix(1, 0, m_vals[i], n_vals[i]);
+	Matrix<double> C2 = C1_view;
+	C1_view.set_multiplier(-2.0);
+	C2.set_multiplier(-2.0);
+	MatMul(A_view, B, C2, 0.5);
+	LeafGemm() = GemmBackend::NATIVE;
+	MatMul(A_view, B, C1_view, 0.5);
+	LeafGemm() = GemmBackend::BLAS;
+	std::cout << m_vals[i] << ", " << k_vals[i] << ", " << n_vals[i]
+			  << ": Max. rel. diff.: " << MaxRelativeDiff(C1_view, C2) << std::endl;
+  }
+
+  LeafGemm() = GemmBackend::NATIVE;
+  Matrix<double> A = RandomMatrix<double>(1001, 803);
+  Matrix<double> B = RandomMatrix<double>(803, 777);
+  Matrix<double> C1(1001, 777), C2(1001, 777), C3(1001, 777);
+  grey424_26_257::FastMatmul(A, B, C1, 2);
+  runtime::FastMatmul(LoadAlgorithms("fast333_23_125,strassen"), A, B, C2);
+  LeafGemm() = GemmBackend::BLAS;
+  MatMul(A, B, C3);
+  std::cout << "Fast algorithms: Max. rel. diff.: " << MaxRelativeDiff(C1, C3) << " "
+			<< MaxRelativeDiff(C2, C3) << std::endl;
+}
+
+
+// Build plans once and execute them several times on the same shape.
+void PlanTests() {
+  std::cout << "Reusable plan tests" << std::endl;
+  int m = 1001, k = 803, n = 777;
+  for (int num_steps = 1; num_steps <= 2; ++num_steps) {
+	FastMatmulPlan<double> strassen_plan = strassen::MakePlan<double>(m, k, n, num_steps);
+	FastMatmulPlan<double> hk_plan = hk323_15_84::MakePlan<double>(m, k, n, num_steps);
+	std::cout << "Workspace (MB): " << strassen_plan.workspace_size() * sizeof(double) / 1e6
+			  << " " << hk_plan.workspace_size() * sizeof(double) / 1e6 << std::endl;
+#ifdef _PARALLEL_
+	// The estimate does not allocate, but it should match the plan.
+	long estimate = EstimateWorkspace<double>(STRASSEN, m, k, n, num_steps, _PARALLEL_,
+											  strassen_plan.num_threads());
+	if (estimate != strassen_plan.workspace_size() * sizeof(double)) {
+	  throw std::logic_error("Workspace estimate does not match the plan");
+	}
+#endif
+	for (int trial = 0; trial < 3; ++trial) {
+	  double alpha = 1.5 + trial;
+	  double beta = -0.5 * trial;
+	  Matrix<double> A = RandomMatrix<double>(m, k);
+	  Matrix<double> B = RandomMatrix<double>(k, n);
+	  Matrix<double> C1 = RandomMatrix<double>(m, n);
+	  Matrix<double> C2 = C1;
+	  Matrix<double> C3 = C1;
+	  C1.set_multiplier(alpha);
+	  MatMul(A, B, C1, beta);
+	  strassen_plan.Execute(A, B, C2, alpha, beta);
+	  hk_plan.Execute(A, B, C3, alpha, beta);
+	  std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << " "
+				<< MaxRelativeDiff(C1, C3) << std::endl;
+	}
+  }
+
+  // Padding instead of peeling, forced and by the cost estimate.
+  for (PaddingMode mode : {PaddingMode::PAD, PaddingMode::AUTO}) {
+	Padding() = mode;
+	FastMatmulPlan<double> plan = grey424_26_257::MakePlan<double>(m, k, n, 2);
+	Matrix<double> A = RandomMatrix<double>(m, k);
+	Matrix<double> B = RandomMatrix<double>(k, n);
+	Matrix<double> C1 = RandomMatrix<double>(m, n);
+	Matrix<double> C2 = C1;
+	Matrix<double> C3 = C1;
+	C1.set_multiplier(2.0);
+	MatMul(A, B, C1, -1.0);
+	plan.Execute(A, B, C2, 2.0, -1.0);
+	runtime::FastMatmul(LoadAlgorithms("strassen,fast333_23_125"), A, B, C3, 2.0, -1.0);
+	std::cout << "Padded: " << plan.padded() << ", Max. rel. diff.: "
+			  << MaxRelativeDiff(C1, C2) << " " << MaxRelativeDiff(C1, C3) << std::endl;
+	if (mode == PaddingMode::PAD && !plan.padded()) {
+	  throw std::logic_error("Plan did not pad");
+	}
+  }
+  Padding() = PaddingMode::PEEL;
+
+  // After the first call, Execute does not allocate, also when the calls
+  // alternate between plans.
+  int size = 800;
+  Matrix<double> A = RandomMatrix<double>(size, size);
+  Matrix<double> B = RandomMatrix<double>(size, size);
+  Matrix<double> C(size, size);
+  FastMatmulPlan<double> strassen_plan = strassen::MakePlan<double>(size, size, size, 2);
+  FastMatmulPlan<double> grey_plan = grey424_26_257::MakePlan<double>(size, size, size, 1);
+  strassen_plan.Execute(A, B, C);
+  grey_plan.Execute(A, B, C);
+  long before = num_allocations.load();
+  for (int trial = 0; trial < 3; ++trial) {
+	strassen_plan.Execute(A, B, C);
+	grey_plan.Execute(A, B, C);
+  }
+  long allocations = num_allocations.load() - before;
+  std::cout << "Allocations in 6 calls: " << allocations << std::endl;
+  if (allocations != 0) {
+	throw std::logic_error("Execute allocated memory");
+  }
+}
+
+
+// Run plans on two threads at once.  In sequential mode, each thread installs
+// the stack arena of its own plan (see StackArena::Current()).
+void ArenaTests() {
+  std::cout << "Stack arena tests" << std::endl;
+  int m = 600, k = 500, n = 700;
+  Matrix<double> A = RandomMatrix<double>(m, k);
+  Matrix<double> B = RandomMatrix<double>(k, n);
+  Matrix<double> C(m, n);
+  MatMul(A, B, C);
+  std::vector<double> diffs(2, 0.0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; ++t) {
+	threads.emplace_back([&, t] {
+	  FastMatmulPlan<double> plan = t == 0 ? strassen::MakePlan<double>(m, k, n, 2) :
+		hk323_15_84::MakePlan<double>(m, k, n, 2);
+	  Matrix<double> C_fast(m, n);
+	  for (int trial = 0; trial < 10; ++trial) {
+		plan.Execute(A, B, C_fast);
+		diffs[t] = std::max(diffs[t], MaxRelativeDiff(C, C_fast));
+	  }
+	});
+  }
+  for (std::thread& thread : threads) {
+	thread.join();
+  }
+  std::cout << "Max. rel. diff.: " << diffs[0] << " " << diffs[1] << std::endl;
+  if (diffs[0] > 1e-10 || diffs[1] > 1e-10) {
+	throw std::logic_error("Wrong result from a plan on two threads");
+  }
+  if (StackArena::Current() != NULL) {
+	throw std::logic_error("Arena still installed after the plans");
+  }
+}
+
+
+// Run the additions with each instruction set that this machine supports,
+// on sizes that leave columns unaligned.
+void SimdAddTests() {
+  std::cout << "Vectorized addition tests" << std::endl;
+  SimdLevel detected = DetectSimdLevel();
+  std::vector<SimdLevel> levels = {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512};
+  for (SimdLevel level : levels) {
+	if (static_cast<int>(level) > static_cast<int>(detected)) {
+	  continue;
+	}
+	ActiveSimdLevel() = level;
+	std::cout << "SIMD level: " << static_cast<int>(level) << std::endl;
+	for (int m : {1001, 1003}) {
+	  Matrix<double> A = RandomMatrix<double>(m, 803);
+	  Matrix<double> B = RandomMatrix<double>(803, 777);
+	  Matrix<double> C1 = RandomMatrix<double>(m, 777);
+	  Matrix<double> C2 = C1;
+	  C2.set_multiplier(1.5);
+	  MatMul(A, B, C2, -0.5);
+	  grey433_29_234::FastMatmul(A, B, C1, 2, 0, 1.5, -0.5);
+	  Matrix<float> Af = DoubleToFloat(A), Bf = DoubleToFloat(B);
+	  Matrix<float> C1f(m, 777), C2f(m, 777);
+	  MatMul(Af, Bf, C2f);
+	  grey323_15_103::FastMatmul(Af, Bf, C1f, 1);
+	  std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << " "
+				<< MaxRelativeDiff(C1f, C2f) << std::endl;
+	}
+	// A long addition with several blocks per column and several passes.
+	const int kNumOps = 28;
+	std::vector< Matrix<double> > ops;
+	const double *data[kNumOps];
+	int strides[kNumOps];
+	double coeffs[kNumOps];
+	for (int t = 0; t < kNumOps; ++t) {
+	  ops.push_back(RandomMatrix<double>(5003, 3));
+	}
+	for (int t = 0; t < kNumOps; ++t) {
+	  data[t] = ops[t].data();
+	  strides[t] = ops[t].stride();
+	  coeffs[t] = t % 2 == 0 ? 1.0 : -0.25;
+	}
+	Matrix<double> C1 = RandomMatrix<double>(5003, 3);
+	Matrix<double> C2 = C1;
+	MultiAdd<double, kNumOps>(data, strides, coeffs, C1, true, 0.5);
+	BlockedMultiAdd<double, kNumOps>(data, strides, coeffs, C2, true, 0.5);
+	std::cout << "Blocked addition max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+	// Non-temporal stores, on an output that is not aligned.
+	Matrix<double> C3(5004, 3);
+	Matrix<double> C3_view = C3.Submatrix(1, 0, 5003, 3);
+	double fraction = NonTemporalFraction();
+	NonTemporalFraction() = 0.0;
+	MultiAdd<double, kNumOps>(data, strides, coeffs, C3_view, true);
+	NonTemporalFraction() = std::numeric_limits<double>::infinity();
+	MultiAdd<double, kNumOps>(data, strides, coeffs, C1, true);
+	NonTemporalFraction() = fraction;
+	std::cout << "Non-temporal addition max. rel. diff.: " << MaxRelativeDiff(C1, C3_view)
+			  << std::endl;
+  }
+  ActiveSimdLevel() = detected;
+}
+
+
+// Run a plan and a wrapper call with each huge page policy.  Whether huge
+// pages are obtained depends on the kernel, so this only checks correctness
+// and that all of the huge page memory is released.
+void HugePageTests() {
+  std::cout << "Huge page tests" << std::endl;
+  int m = 1001, k = 803, n = 777;
+  std::vector<PagePolicy> policies = {PagePolicy::TRANSPARENT_HUGE, PagePolicy::HUGETLB};
+  for (PagePolicy policy : policies) {
+	HugePages::set_policy(policy);
+	{
+	  Matrix<double> A = RandomMatrix<double>(m, k);
+	  Matrix<double> B = RandomMatrix<double>(k, n);
+	  Matrix<double> C1(m, n), C2(m, n), C3(m, n);
+	  FastMatmulPlan<double> plan = strassen::MakePlan<double>(m, k, n, 2);
+	  plan.Execute(A, B, C1);
+	  grey424_26_257::FastMatmul(A, B, C2, 1);
+	  MatMul(A, B, C3);
+	  HugePages::PrintStats();
+	  std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C3) << " "
+				<< MaxRelativeDiff(C2, C3) << std::endl;
+	}
+	if (HugePages::Stats().num_allocations != 0) {
+	  throw std::logic_error("Huge page memory was not released");
+	}
+  }
+  HugePages::set_policy(PagePolicy::DEFAULT);
+}
+
+
+// Sum 1..n with a binary tree of tasks, which wait for their children.
+long TaskTreeSum(int lo, int hi) {
+  if (hi - lo < 8) {
+	long sum = 0;
+	for (int i = lo; i <= hi; ++i) {
+	  sum += i;
+	}
+	return sum;
+  }
+  int mid = (lo + hi) / 2;
+  long left = 0, right = 0;
+  SpawnTask(true, [&left, lo, mid] { left = TaskTreeSum(lo, mid); });
+  SpawnTask(true, [&right, mid, hi] { right = TaskTreeSum(mid + 1, hi); });
+  TaskWait();
+  return left + right;
+}
+
+
+// Run a tree of tasks and a countdown on the task scheduler of this build,
+// and check the cached task schedules and the HYBRID remainder groups.
+void TaskPoolTests() {
+  std::cout << "Task scheduler tests" << std::endl;
+  const int n = 10000;
+  long sum = 0;
+  for (int num_threads : {1, 2, 4}) {
+	RunTaskParallel(num_threads, [] {}, [&sum] { sum = TaskTreeSum(1, n); });
+	if (sum != static_cast<long>(n) * (n + 1) / 2) {
+	  throw std::logic_error("Wrong sum from the task tree");
+	}
+  }
+  // A loop split by TaskLoop inside a task runs every iteration once.
+  for (int num_threads : {1, 2, 4}) {
+	std::vector<int> hits(1000, 0);
+	RunTaskParallel(num_threads, [] {}, [&hits] {
+		SpawnTask(true, [&hits] {
+			TaskLoop(0, 1000, 7, [&hits](int begin, int end) {
+				for (int i = begin; i < end; ++i) {
+				  ++hits[i];
+				}
+			  });
+		  });
+		TaskWait();
+	  });
+	if (std::count(hits.begin(), hits.end(), 1) != 1000) {
+	  throw std::logic_error("TaskLoop did not run every iteration once");
+	}
+  }
+#ifdef _PARALLEL_
+  // The wait for the BFS multiplies before HYBRID switches to DFS.  The
+  // tasks that it waits for run on the other threads (with OpenMP, a taskyield
+  // may not run anything).
+  LockAndCounter::ResetStats();
+  for (int num_threads : {2, 4}) {
+	LockAndCounter counter(64);
+	RunTaskParallel(num_threads, [] {}, [&counter] {
+		for (int i = 0; i < 64; ++i) {
+		  SpawnTask(true, [&counter] { counter.Decrement(); });
+		}
+		counter.Acquire();
+		TaskWait();
+	  });
+  }
+  SwitchWaitStats wait_stats = LockAndCounter::Stats();
+  if (wait_stats.num_waits != 2) {
+	throw std::logic_error("Wrong number of waits on the task counter");
+  }
+  std::cout << "Counter wait: " << wait_stats.wait_ms << " ms" << std::endl;
+#endif
+  // The schedule tables agree with the functions that they cache.
+  for (int num_threads : {5, 24, 100}) {
+	std::vector<int> ranks = {23, 7, 29};
+	std::vector<int> steps = {_HYBRID_PAR_, _BFS_PAR_, _HYBRID_PAR_};
+	const TaskSchedule& schedule = TaskSchedule::Get(ranks, steps, num_threads);
+	for (int level = 0; level < 3; ++level) {
+	  int num_nodes = level == 0 ? 1 : (level == 1 ? 23 : 23 * 7);
+	  for (int node = 0; node < num_nodes; ++node) {
+		for (int p = 1; p <= ranks[level]; ++p) {
+		  int start_index = node * ranks[level];
+		  if (schedule.launch(level, start_index, p) !=
+			  should_launch_task(steps, ranks, level, start_index, p, num_threads) ||
+			  schedule.wait(level, start_index, p) !=
+			  should_task_wait(steps, ranks, level, start_index, p, num_threads)) {
+			throw std::logic_error("Task schedule does not match should_launch_task");
+		  }
+		}
+	  }
+	}
+  }
+  TaskSchedule::Get(7, 2, 12).Print(std::cout, 3);
+  // The last 4 of the 49 HYBRID leaves on 5 threads run in 2 groups of 2
+  // threads each.
+  std::vector<int> ranks = {7, 7};
+  std::vector<int> steps = {_HYBRID_PAR_, _HYBRID_PAR_};
+  const TaskSchedule& grouped = TaskSchedule::Get(ranks, steps, 5, 2);
+  for (int p = 1; p <= 7; ++p) {
+	bool in_group = p >= 4;
+	bool group_wait = p == 5 || p == 7;
+	if ((grouped.threads(1, 42, p) == 2) != in_group ||
+		(in_group && (!grouped.launch(1, 42, p) || grouped.wait(1, 42, p) != group_wait))) {
+	  throw std::logic_error("Wrong remainder groups in the task schedule");
+	}
+  }
+  grouped.Print(std::cout, 2);
+}
+
+
+// Run fast algorithms whose temporaries get a padded leading dimension.
+void PaddedStrideTests() {
+  std::cout << "Padded temporary tests" << std::endl;
+  if (TemporaryStride<double>(512) == 512) {
+	throw std::logic_error("Temporaries with 4 KB columns are not padded");
+  }
+  int m = 1024;
+  Matrix<double> A = RandomMatrix<double>(m, m);
+  Matrix<double> B = RandomMatrix<double>(m, m);
+  Matrix<double> C1(m, m), C2(m, m), C3(m, m);
+  // The 7 leaves do not divide evenly among 2, 4, or 5 threads.
+  HybridRemainderGroups() = 2;
+  strassen::FastMatmul(A, B, C1, 1);
+  HybridRemainderGroups() = 0;
+  FastAlgorithm alg("codegen/algorithms/strassen", 2, 2, 2);
+  runtime::FastMatmul(alg, A, B, C2, 2);
+  MatMul(A, B, C3);
+  std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C3) << " "
+			<< MaxRelativeDiff(C2, C3) << std::endl;
+  if (MaxRelativeDiff(C1, C3) > 1e-10 || MaxRelativeDiff(C2, C3) > 1e-10) {
+	throw std::logic_error("Wrong result with padded temporaries");
+  }
+}
+
+
+// Run fast algorithms whose output additions start early, and whose
+// additions inside tasks are split among the idle threads.
+void EarlyOutputTests() {
+  std::cout << "Early output addition tests" << std::endl;
+  // The blocks of C that read only multiplies are formed as the multiplies
+  // finish.  The odd sizes peel all three dimensions, and some blocks of
+  // grey323_15_89 read eliminated subexpressions, so they wait for all of
+  // the multiplies.
+  FastAlgorithm grey("codegen/algorithms/grey323-15-89", 3, 2, 3);
+  if (grey.early_output(0) || !grey.early_output(3)) {
+	throw std::logic_error("Wrong early outputs of grey323_15_89");
+  }
+  Matrix<double> D = RandomMatrix<double>(601, 403);
+  Matrix<double> E = RandomMatrix<double>(403, 599);
+  Matrix<double> F1(601, 599), F2(601, 599), F3(601, 599);
+  grey323_15_89::FastMatmul(D, E, F1, 2);
+  runtime::FastMatmul(grey, D, E, F2, 2);
+  MatMul(D, E, F3);
+  std::cout << "Max. rel. diff. (early additions): " << MaxRelativeDiff(F1, F3) << " "
+			<< MaxRelativeDiff(F2, F3) << std::endl;
+  if (MaxRelativeDiff(F1, F3) > 1e-10 || MaxRelativeDiff(F2, F3) > 1e-10) {
+	throw std::logic_error("Wrong result with early output additions");
+  }
+
+  // The additions in tasks split into ranges of 4 columns.
+  int grain = AddTaskGrain();
+  AddTaskGrain() = 4 * 601;
+  grey323_15_89::FastMatmul(D, E, F1, 2);
+  runtime::FastMatmul(grey, D, E, F2, 2);
+  AddTaskGrain() = grain;
+  std::cout << "Max. rel. diff. (split additions): " << MaxRelativeDiff(F1, F3) << " "
+			<< MaxRelativeDiff(F2, F3) << std::endl;
+  if (MaxRelativeDiff(F1, F3) > 1e-10 || MaxRelativeDiff(F2, F3) > 1e-10) {
+	throw std::logic_error("Wrong result with split additions");
+  }
+}
+
+
+// Tune the planner for a small problem, save and reload the database, and
+// check that the plan is unchanged and computes the right product.
+void PlannerTests() {
+  std::cout << "Planner tests" << std::endl;
+  std::string db_file = "matmul_tests_tuning.db";
+  int m = 800, k = 600, n = 700, num_threads = 1;
+  MatmulPlan tuned;
+  {
+	Planner planner(db_file);
+	std::vector<int> algorithms = {STRASSEN, FAST323_15_103};
+	std::vector<int> num_steps = {1, 2};
+	tuned = planner.Tune(m, k, n, num_threads, algorithms, num_steps, 3);
+	planner.Save();
+  }
+  Planner planner(db_file);
+  MatmulPlan plan = planner.Plan(m, k, n, num_threads);
+  if (plan.algorithm != tuned.algorithm || plan.num_steps != tuned.num_steps) {
+	throw std::logic_error("Planner database did not round trip");
+  }
+  std::cout << "Plan: " << Alg2Str(plan.algorithm) << "_" << plan.num_steps << std::endl;
+  // Nearby shapes use the same plan; far away shapes fall back to GEMM.
+  MatmulPlan near = planner.Plan(m + 10, k - 10, n, num_threads);
+  MatmulPlan far = planner.Plan(10 * m, k, n, num_threads);
+  if (near.algorithm != plan.algorithm || far.algorithm != MKL) {
+	throw std::logic_error("Planner lookup for untuned shapes is wrong");
+  }
+  Matrix<double> A = RandomMatrix<double>(m, k);
+  Matrix<double> B = RandomMatrix<double>(k, n);
+  Matrix<double> C1(m, n), C2(m, n);
+  RunPlan(plan, A, B, C1);
+  MatMul(A, B, C2);
+  std::cout << "Max. rel. diff.: " << MaxRelativeDiff(C1, C2) << std::endl;
+  std::remove(db_file.c_str());
+}
+
+
 int main(int argc, char **argv) {
   auto opts = GetOpts(argc, argv);
   if (OptExists(opts, "fast")) {
@@ -182,6 +823,36 @@ int main(int argc, char **argv) {
   if (OptExists(opts, "extra_gemm")) {
 	ExtraMatMulTests();
   }
+  if (OptExists(opts, "runtime")) {
+	RuntimeTests();
+  }
+  if (OptExists(opts, "plan")) {
+	PlanTests();
+  }
+  if (OptExists(opts, "arena")) {
+	ArenaTests();
+  }
+  if (OptExists(opts, "planner")) {
+	PlannerTests();
+  }
+  if (OptExists(opts, "simd")) {
+	SimdAddTests();
+  }
+  if (OptExists(opts, "huge_pages")) {
+	HugePageTests();
+  }
+  if (OptExists(opts, "native_gemm")) {
+	NativeGemmTests();
+  }
+  if (OptExists(opts, "task_pool")) {
+	TaskPoolTests();
+  }
+  if (OptExists(opts, "padded_stride")) {
+	PaddedStrideTests();
+  }
+  if (OptExists(opts, "early_outputs")) {
+	EarlyOutputTests();
+  }
   if (OptExists(opts, "all")) {
 	FastMatmulTests();
 	ExtraMatMulTests();
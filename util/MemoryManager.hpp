@@ -2,42 +2,103 @@
    Copyright (c) 2014-2015, Sandia Corporation
    All rights reserved.
 
-   This file is part of fast-matmul and is under the BSD 2-Clause License, 
-   which can be found in the LICENSE file in the root directory, or at 
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
    http://opensource.org/licenses/BSD-2-Clause.
 */
 
 #ifndef _MEMORY_MANAGER_HPP_
 #define _MEMORY_MANAGER_HPP_
 
+#include "huge_pages.hpp"
+#include "linalg.hpp"
+#include "numa.hpp"
+#include "par_util.hpp"
+#include "stack_arena.hpp"
+
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <queue>
+#include <utility>
 #include <vector>
 
+// Types of temporaries: the S, T, and M matrices of each multiplication, and
+// the eliminated subexpressions A_X, B_X, and M_X of each recursion node.
 enum {
   S = 0,
   T,
   M,
+  AX,
+  BX,
+  MX,
+  NUM_TMP_TYPES,
+};
+
+// The algorithm used at one level of the recursion: the <m, k, n> base case,
+// its rank, and the number of eliminated subexpressions for A, B, and M.
+// needs_S[r] (needs_T[r]) is false if the A (B) operand of multiplication r
+// is a single block, so no S (T) temporary is formed.  Empty means that
+// every multiplication needs one.
+struct LevelShape {
+  LevelShape(int m, int k, int n, int rank, int num_AX=0, int num_BX=0, int num_MX=0,
+             std::vector<bool> needs_S=std::vector<bool>(),
+             std::vector<bool> needs_T=std::vector<bool>()) :
+    m(m), k(k), n(n), rank(rank), num_AX(num_AX), num_BX(num_BX), num_MX(num_MX),
+    needs_S(needs_S), needs_T(needs_T) {}
+
+  int m;
+  int k;
+  int n;
+  int rank;
+  int num_AX;
+  int num_BX;
+  int num_MX;
+  std::vector<bool> needs_S;
+  std::vector<bool> needs_T;
 };
 
+// Thread groups for the HYBRID remainder of a num_rows_A x num_cols_A x
+// num_cols_B multiply with levels[l] at level l (see
+// TaskSchedule::RemainderGroups).
+inline int RemainderGroups(const std::vector<LevelShape>& levels, const std::vector<int>& steps,
+                           int num_rows_A, int num_cols_A, int num_cols_B, int num_threads) {
+  std::vector<int> ranks;
+  for (const LevelShape& level : levels) {
+    ranks.push_back(level.rank);
+    num_rows_A /= level.m;
+    num_cols_A /= level.k;
+    num_cols_B /= level.n;
+  }
+  return TaskSchedule::RemainderGroups(ranks, steps, num_threads, num_rows_A, num_cols_A,
+                                       num_cols_B);
+}
+
+
+// Memory for the temporaries of the parallel recursion.  The lifetimes of
+// the temporaries are computed by walking the recursion tree with the same
+// task schedule as the recursion (TaskSchedule),
+// and temporaries whose lifetimes do not overlap share memory.
 template <typename Scalar>
 class MemoryManager {
  public:
   MemoryManager() {}
-  ~MemoryManager() {
-	for (auto level_vec : M_mem) {
-	  for (Scalar *data : level_vec) {
-		delete [] data;
-	  }
-	}
-
-	for (auto level_vec : S_mem) {
-	  for (Scalar *data : level_vec) {
-		delete [] data;
-	  }
+  MemoryManager(MemoryManager<Scalar>&& that) : MemoryManager() {
+	for (int type = 0; type < NUM_TMP_TYPES; ++type) {
+	  slots_[type].swap(that.slots_[type]);
 	}
+	buffers_.swap(that.buffers_);
+	buffer_sizes_.swap(that.buffer_sizes_);
+	buffer_owners_.swap(that.buffer_owners_);
+	levels_.swap(that.levels_);
+  }
+  MemoryManager(const MemoryManager<Scalar>& that) = delete;
+  MemoryManager<Scalar>& operator=(const MemoryManager<Scalar>& that) = delete;
 
-	for (auto level_vec : T_mem) {
-	  for (Scalar *data : level_vec) {
+  ~MemoryManager() {
+	for (Scalar *data : buffers_) {
+	  if (!HugePages::Free(data)) {
 		delete [] data;
 	  }
 	}
@@ -49,70 +110,468 @@ class MemoryManager {
   void Allocate(int m, int k, int n, int num_mults, int num_levels,
 		int num_rows_A, int num_cols_A, int num_cols_B);
 
+  // Allocate the memory for a recursion that uses levels[l] at level l.
+  // If num_threads is positive, temporaries with disjoint lifetimes under the
+  // task schedule for num_threads threads share memory.  Otherwise, every
+  // temporary gets its own memory.  steps[l] is the parallel strategy at
+  // level l (see should_launch_task); by default, it is the compiled mode.
+  void Allocate(const std::vector<LevelShape>& levels, int num_rows_A, int num_cols_A,
+		int num_cols_B, int num_threads=0,
+		std::vector<int> steps=std::vector<int>());
+
+  // Number of scalars that Allocate() would allocate with the same arguments.
+  // Nothing is allocated.
+  static long WorkspaceSize(const std::vector<LevelShape>& levels, int num_rows_A,
+			    int num_cols_A, int num_cols_B, int num_threads=0,
+			    std::vector<int> steps=std::vector<int>()) {
+	MemoryManager<Scalar> layout;
+	layout.Layout(levels, num_rows_A, num_cols_A, num_cols_B, num_threads, steps);
+	return layout.Size();
+  }
+
+  // Largest total size of the temporaries that are live at the same time in
+  // a sequential recursion, which allocates each temporary separately.
+  static long PeakLiveSize(const std::vector<LevelShape>& levels, int num_rows_A,
+			   int num_cols_A, int num_cols_B);
+
+  // Memory for multiplication mult (1-indexed) of the node with the given
+  // start index.  For AX, BX, and MX, mult is the index of the eliminated
+  // subexpression in the node.
   Scalar *GetMem(int start_index, int mult, int level, int type);
 
+  // Total number of scalars allocated.
+  long Size() const {
+	long total = 0;
+	for (long size : buffer_sizes_) {
+	  total += size;
+	}
+	return total;
+  }
+
+  // Number of distinct buffers allocated.
+  int NumBuffers() const { return buffers_.size(); }
+
+  // Bind each buffer that only holds temporaries of one top-level multiply
+  // to the memory of the node that runs that multiply.  Call this before the
+  // buffers are used.  Returns the number of bytes that were bound.
+  long BindToNodes(const NumaPartition& numa);
+
  private:
-  int Size(int level, int m, int n, int num_rows_A, int num_cols_B);
-  // Integer version of x ^ b
-  int Pow(int x, int b);
+  // A temporary and the interval of the schedule during which it is live.
+  struct Lifetime {
+	int type;
+	int level;
+	int index;
+	long size;
+	long start;
+	long end;
+  };
+
+  // Lifetimes of all of the temporaries that are used.
+  std::vector<Lifetime> ComputeLifetimes(const std::vector<LevelShape>& levels,
+					 int num_rows_A, int num_cols_A, int num_cols_B,
+					 int num_threads, std::vector<int> steps);
+
+  // Assign the temporaries to buffers and compute the buffer sizes.
+  void Layout(const std::vector<LevelShape>& levels, int num_rows_A, int num_cols_A,
+	      int num_cols_B, int num_threads, std::vector<int> steps);
 
-  std::vector< std::vector<Scalar *> > M_mem;
-  std::vector< std::vector<Scalar *> > S_mem;
-  std::vector< std::vector<Scalar *> > T_mem;
+  long Size(int level, const std::vector<LevelShape>& levels, int type,
+	    int num_rows_A, int num_cols_A, int num_cols_B);
+  bool Needed(int level, int type, int mult);
+  int TopLevelOwner(int level, int type, int index);
+  int NumPerNode(int level, int type);
+
+  void Lifetimes(int level, int start_index, const TaskSchedule *schedule, long& time,
+		 const std::vector<int>& ranks,
+		 const std::vector< std::vector<long> >& sizes,
+		 std::vector<Lifetime>& lifetimes);
+
+  // slots_[type][level][i] is the index into buffers_ of temporary i, or -1
+  // if it is never used.
+  std::vector< std::vector<int> > slots_[NUM_TMP_TYPES];
+  std::vector<Scalar *> buffers_;
+  std::vector<long> buffer_sizes_;
+  // Top-level multiply whose subtree uses each buffer, or -1 if there are
+  // several (or the buffer is used by the top node itself).
+  std::vector<int> buffer_owners_;
+  std::vector<LevelShape> levels_;
 };
 
 template <typename Scalar>
 void MemoryManager<Scalar>::Allocate(int m, int k, int n, int num_mults, int num_levels,
 			     int num_rows_A, int num_cols_A, int num_cols_B) {
-  
-  M_mem.resize(num_levels);
-  S_mem.resize(num_levels);
-  T_mem.resize(num_levels);
+  Allocate(std::vector<LevelShape>(num_levels, LevelShape(m, k, n, num_mults)),
+	   num_rows_A, num_cols_A, num_cols_B);
+}
 
+template <typename Scalar>
+void MemoryManager<Scalar>::Allocate(const std::vector<LevelShape>& levels, int num_rows_A,
+				     int num_cols_A, int num_cols_B, int num_threads,
+				     std::vector<int> steps) {
+  Layout(levels, num_rows_A, num_cols_A, num_cols_B, num_threads, steps);
+  for (long size : buffer_sizes_) {
+	Scalar *data = static_cast<Scalar *>(HugePages::Allocate(sizeof(Scalar) * size));
+	buffers_.push_back(data != NULL ? data : new Scalar[size]);
+  }
+}
+
+template <typename Scalar>
+std::vector<typename MemoryManager<Scalar>::Lifetime>
+MemoryManager<Scalar>::ComputeLifetimes(const std::vector<LevelShape>& levels,
+					int num_rows_A, int num_cols_A, int num_cols_B,
+					int num_threads, std::vector<int> steps) {
+  levels_ = levels;
+  int num_levels = levels.size();
+  std::vector<int> ranks;
+  std::vector< std::vector<long> > sizes(num_levels, std::vector<long>(NUM_TMP_TYPES));
   for (int level = 0; level < num_levels; ++level) {
-    int size_M = Size(level, m, n, num_rows_A, num_cols_B);
-    int size_S = Size(level, m, k, num_rows_A, num_cols_A);
-    int size_T = Size(level, k, n, num_cols_A, num_cols_B);
-	
-	int mults_at_level = Pow(num_mults, level + 1);
-	M_mem[level].resize(mults_at_level);
-	S_mem[level].resize(mults_at_level);
-	T_mem[level].resize(mults_at_level);
-
-    for (int i = 0; i < mults_at_level; ++i) {
-	  M_mem[level][i] = new Scalar[size_M];
-	  S_mem[level][i] = new Scalar[size_S];
-	  T_mem[level][i] = new Scalar[size_T];
-    } 
+	ranks.push_back(levels[level].rank);
+	for (int type = 0; type < NUM_TMP_TYPES; ++type) {
+	  sizes[level][type] = Size(level, levels, type, num_rows_A, num_cols_A, num_cols_B);
+	}
+  }
+
+  std::vector<Lifetime> lifetimes;
+  long time = 0;
+  if (steps.empty()) {
+	steps = default_parallel_steps(num_levels);
+  }
+  const TaskSchedule *schedule = NULL;
+  if (num_threads > 0) {
+	int groups = RemainderGroups(levels, steps, num_rows_A, num_cols_A, num_cols_B, num_threads);
+	schedule = &TaskSchedule::Get(ranks, steps, num_threads, groups);
+  }
+  Lifetimes(0, 0, schedule, time, ranks, sizes, lifetimes);
+  if (num_threads <= 0) {
+	// Everything is live for the whole multiplication.
+	for (Lifetime& lifetime : lifetimes) {
+	  lifetime.start = 0;
+	  lifetime.end = time;
+	}
+  }
+  return lifetimes;
+}
+
+template <typename Scalar>
+long MemoryManager<Scalar>::PeakLiveSize(const std::vector<LevelShape>& levels,
+					 int num_rows_A, int num_cols_A, int num_cols_B) {
+  MemoryManager<Scalar> layout;
+  std::vector<Lifetime> lifetimes =
+	layout.ComputeLifetimes(levels, num_rows_A, num_cols_A, num_cols_B, 1,
+				std::vector<int>(levels.size(), _DFS_PAR_));
+  // The eliminated subexpressions of A and B are freed when the node
+  // returns, which is when its M matrices are freed.
+  std::map<std::pair<int, int>, long> node_ends;  // (level, node) --> end
+  for (const Lifetime& lifetime : lifetimes) {
+	if (lifetime.type == M) {
+	  int node = lifetime.index / levels[lifetime.level].rank;
+	  node_ends[std::make_pair(lifetime.level, node)] = lifetime.end;
+	}
+  }
+  for (Lifetime& lifetime : lifetimes) {
+	if (lifetime.type == AX || lifetime.type == BX) {
+	  int node = lifetime.index / layout.NumPerNode(lifetime.level, lifetime.type);
+	  lifetime.end = node_ends[std::make_pair(lifetime.level, node)];
+	}
+  }
+  // Sweep over the start and end times.  A temporary is live at its end time.
+  std::vector< std::pair<long, long> > events;  // (time, change in size)
+  for (const Lifetime& lifetime : lifetimes) {
+	events.push_back(std::make_pair(lifetime.start, lifetime.size));
+	events.push_back(std::make_pair(lifetime.end + 1, -lifetime.size));
   }
+  std::sort(events.begin(), events.end());
+  long live = 0;
+  long peak = 0;
+  for (const auto& event : events) {
+	live += event.second;
+	peak = std::max(peak, live);
+  }
+  return peak;
 }
 
-template <typename Scalar>  
+template <typename Scalar>
+void MemoryManager<Scalar>::Layout(const std::vector<LevelShape>& levels, int num_rows_A,
+				   int num_cols_A, int num_cols_B, int num_threads,
+				   std::vector<int> steps) {
+  std::vector<Lifetime> lifetimes = ComputeLifetimes(levels, num_rows_A, num_cols_A,
+						     num_cols_B, num_threads, steps);
+  int num_levels = levels.size();
+  for (int type = 0; type < NUM_TMP_TYPES; ++type) {
+	slots_[type].assign(num_levels, std::vector<int>());
+  }
+  int nodes_at_level = 1;
+  for (int level = 0; level < num_levels; ++level) {
+	for (int type = 0; type < NUM_TMP_TYPES; ++type) {
+	  slots_[type][level].assign(nodes_at_level * NumPerNode(level, type), -1);
+	}
+	nodes_at_level *= levels[level].rank;
+  }
+
+  // Greedy interval allocation: go through the temporaries in order of
+  // their first use and give each one the smallest free buffer that is big
+  // enough, or a new buffer if there is none.
+  std::sort(lifetimes.begin(), lifetimes.end(),
+	    [](const Lifetime& a, const Lifetime& b) { return a.start < b.start; });
+  typedef std::pair<long, int> EndAndBuffer;
+  std::priority_queue<EndAndBuffer, std::vector<EndAndBuffer>,
+		      std::greater<EndAndBuffer> > in_use;
+  std::multimap<long, int> free_buffers;  // size --> buffer
+  for (const Lifetime& lifetime : lifetimes) {
+	while (!in_use.empty() && in_use.top().first < lifetime.start) {
+	  int buffer = in_use.top().second;
+	  free_buffers.insert(std::make_pair(buffer_sizes_[buffer], buffer));
+	  in_use.pop();
+	}
+	int buffer;
+	int owner = TopLevelOwner(lifetime.level, lifetime.type, lifetime.index);
+	auto fit = free_buffers.lower_bound(lifetime.size);
+	if (fit != free_buffers.end()) {
+	  buffer = fit->second;
+	  free_buffers.erase(fit);
+	  if (buffer_owners_[buffer] != owner) {
+		buffer_owners_[buffer] = -1;
+	  }
+	} else {
+	  buffer = buffer_sizes_.size();
+	  buffer_sizes_.push_back(lifetime.size);
+	  buffer_owners_.push_back(owner);
+	}
+	slots_[lifetime.type][lifetime.level][lifetime.index] = buffer;
+	in_use.push(std::make_pair(lifetime.end, buffer));
+  }
+}
+
+template <typename Scalar>
 Scalar *MemoryManager<Scalar>::GetMem(int start_index, int mult, int level, int type) {
+  int index;
   switch (type) {
   case M:
-	return M_mem[level][start_index + mult - 1];
   case S:
-	return S_mem[level][start_index + mult - 1];
   case T:
-	return T_mem[level][start_index + mult - 1];
+	index = start_index + mult - 1;
+	break;
+  case AX:
+  case BX:
+  case MX:
+	// The start index of a node is its index in the level times the rank.
+	index = (start_index / levels_[level].rank) * NumPerNode(level, type) + mult - 1;
+	break;
   default:
 	return NULL;
   }
+  int buffer = slots_[type][level][index];
+  return buffer >= 0 ? buffers_[buffer] : NULL;
+}
+
+
+// Walk the recursion tree in the order that the recursion runs, and record
+// when each temporary is first and last used.  Every event advances time.
+// Multiplications that are launched as tasks run concurrently with everything
+// up to the next taskwait, so the lifetimes of all of the temporaries in
+// their subtrees are extended to cover that whole window.
+template <typename Scalar>
+void MemoryManager<Scalar>::Lifetimes(int level, int start_index,
+				      const TaskSchedule *schedule, long& time,
+				      const std::vector<int>& ranks,
+				      const std::vector< std::vector<long> >& sizes,
+				      std::vector<Lifetime>& lifetimes) {
+  int num_levels = ranks.size();
+  if (level == num_levels) {
+	++time;
+	return;
+  }
+  int rank = ranks[level];
+  int node = start_index / rank;
+  ++time;
+
+  auto add = [&](int type, int index) {
+	Lifetime lifetime = {type, level, index, sizes[level][type], time, time};
+	lifetimes.push_back(lifetime);
+	return static_cast<int>(lifetimes.size()) - 1;
+  };
+
+  std::vector<int> node_tmps;  // Temporaries that live until the end of the node.
+  for (int r = 0; r < rank; ++r) {
+	node_tmps.push_back(add(M, start_index + r));
+  }
+  std::vector<int> input_subs;
+  for (int i = 0; i < NumPerNode(level, AX); ++i) {
+	input_subs.push_back(add(AX, node * NumPerNode(level, AX) + i));
+  }
+  for (int i = 0; i < NumPerNode(level, BX); ++i) {
+	input_subs.push_back(add(BX, node * NumPerNode(level, BX) + i));
+  }
+
+  bool group_open = false;
+  long group_start = 0;
+  int group_begin = 0;  // First lifetime in the group of tasks
+  for (int r = 0; r < rank; ++r) {
+	bool launch = false;
+	bool wait = false;
+	if (schedule != NULL) {
+	  launch = schedule->launch(level, start_index, r + 1);
+	  wait = schedule->wait(level, start_index, r + 1);
+	}
+	long mult_start = time++;
+	int mult_begin = lifetimes.size();
+	std::vector<int> mult_tmps;  // S and T of this multiplication
+	if (Needed(level, S, r)) { mult_tmps.push_back(add(S, start_index + r)); }
+	if (Needed(level, T, r)) { mult_tmps.push_back(add(T, start_index + r)); }
+	int child_start = level + 1 < num_levels ? (start_index + r) * ranks[level + 1] : 0;
+	Lifetimes(level + 1, child_start, schedule, time, ranks, sizes, lifetimes);
+	long mult_end = time++;
+	for (int i : mult_tmps) {
+	  lifetimes[i].end = mult_end;
+	}
+	if (launch && !group_open) {
+	  group_open = true;
+	  group_start = mult_start;
+	  group_begin = mult_begin;
+	}
+	if (wait || r + 1 == rank) {
+	  long wait_time = time++;
+	  if (group_open) {
+		for (int i = group_begin; i < static_cast<int>(lifetimes.size()); ++i) {
+		  lifetimes[i].start = std::min(lifetimes[i].start, group_start);
+		  lifetimes[i].end = std::max(lifetimes[i].end, wait_time);
+		}
+	  }
+	  group_open = false;
+	}
+  }
+
+  long mults_done = time++;
+  for (int i : input_subs) {
+	lifetimes[i].end = mults_done;
+  }
+  for (int i = 0; i < NumPerNode(level, MX); ++i) {
+	node_tmps.push_back(add(MX, node * NumPerNode(level, MX) + i));
+  }
+  long node_end = time++;
+  for (int i : node_tmps) {
+	lifetimes[i].end = node_end;
+  }
+}
+
+
+template <typename Scalar>
+long MemoryManager<Scalar>::BindToNodes(const NumaPartition& numa) {
+  long bound = 0;
+  for (int i = 0; i < static_cast<int>(buffers_.size()); ++i) {
+	if (buffer_owners_[i] < 0) {
+	  continue;
+	}
+	int node = numa.NodeOfTask(buffer_owners_[i], levels_[0].rank);
+	long bytes = buffer_sizes_[i] * sizeof(Scalar);
+	if (NumaPartition::BindMemory(buffers_[i], bytes, node)) {
+	  bound += bytes;
+	}
+  }
+  return bound;
+}
+
+
+// The top-level multiply whose subtree contains the temporary, or -1 for the
+// subexpressions of the top node.
+template <typename Scalar>
+int MemoryManager<Scalar>::TopLevelOwner(int level, int type, int index) {
+  if (level == 0) {
+	return type == S || type == T || type == M ? index : -1;
+  }
+  int node = index / NumPerNode(level, type);
+  for (int l = 1; l < level; ++l) {
+	node /= levels_[l].rank;
+  }
+  return node;
+}
+
+
+template <typename Scalar>
+bool MemoryManager<Scalar>::Needed(int level, int type, int mult) {
+  const std::vector<bool>& needs = type == S ? levels_[level].needs_S : levels_[level].needs_T;
+  return needs.empty() || needs[mult];
+}
+
+
+template <typename Scalar>
+int MemoryManager<Scalar>::NumPerNode(int level, int type) {
+  const LevelShape& shape = levels_[level];
+  switch (type) {
+  case S:
+  case T:
+  case M:
+	return shape.rank;
+  case AX:
+	return shape.num_AX;
+  case BX:
+	return shape.num_BX;
+  case MX:
+	return shape.num_MX;
+  default:
+	return 0;
+  }
 }
 
 
+// Number of scalars of a temporary, with the leading dimension from
+// TemporaryStride.
 template <typename Scalar>
-int MemoryManager<Scalar>::Size(int level, int m, int n, int num_rows_A, int num_cols_B) {
-  int num_rows = num_rows_A / Pow(m, level + 1);
-  int num_cols = num_cols_B / Pow(n, level + 1);
-  return num_rows * num_cols;
+long MemoryManager<Scalar>::Size(int level, const std::vector<LevelShape>& levels, int type,
+				 int num_rows_A, int num_cols_A, int num_cols_B) {
+  // S and A_X are blocks of A, T and B_X are blocks of B, and M and M_X are
+  // blocks of C.
+  bool rows_from_A = type == S || type == AX || type == M || type == MX;
+  bool cols_from_B = type == T || type == BX || type == M || type == MX;
+  int num_rows = rows_from_A ? num_rows_A : num_cols_A;
+  int num_cols = cols_from_B ? num_cols_B : num_cols_A;
+  for (int l = 0; l <= level; ++l) {
+	num_rows /= rows_from_A ? levels[l].m : levels[l].k;
+	num_cols /= cols_from_B ? levels[l].n : levels[l].k;
+  }
+  return static_cast<long>(TemporaryStride<Scalar>(num_rows)) * num_cols;
 }
 
+
+// Number of bytes of temporaries used to multiply a num_rows_A x num_cols_A
+// matrix with a num_cols_A x num_cols_B matrix with a recursion that uses
+// levels[l] at level l.  mode is the parallel mode (_DFS_PAR_, _BFS_PAR_, or
+// _HYBRID_PAR_), or 0 for sequential code.  In parallel modes, this is the
+// memory manager's allocation for num_threads threads; the number of threads
+// only changes the HYBRID schedule, and one thread gives an upper bound.
+// Sequential code allocates each temporary when it is needed, and this is
+// the most that is allocated at once.  Nothing is allocated here.
 template <typename Scalar>
-int MemoryManager<Scalar>::Pow(int x, int b) {
-  if (b == 0) { return 1; }
-  return  x * Pow(x, b - 1);
+long EstimateWorkspace(const std::vector<LevelShape>& levels, int num_rows_A,
+		       int num_cols_A, int num_cols_B, int mode, int num_threads=1) {
+  if (levels.empty()) {
+	return 0;
+  }
+  long size;
+  if (mode == 0) {
+	size = MemoryManager<Scalar>::PeakLiveSize(levels, num_rows_A, num_cols_A, num_cols_B);
+  } else {
+	size = MemoryManager<Scalar>::WorkspaceSize(levels, num_rows_A, num_cols_A, num_cols_B,
+						    num_threads,
+						    std::vector<int>(levels.size(), mode));
+  }
+  return size * sizeof(Scalar);
+}
+
+
+// Stack arena for the temporaries of a sequential recursion over levels: the
+// most bytes that are live at once, plus cache-line alignment of every block
+// that can be live at once.
+template <typename Scalar>
+void ReserveSequentialArena(StackArena& arena, const std::vector<LevelShape>& levels,
+			    int num_rows_A, int num_cols_A, int num_cols_B) {
+  size_t bytes = EstimateWorkspace<Scalar>(levels, num_rows_A, num_cols_A, num_cols_B, 0);
+  size_t num_blocks = 0;
+  for (const LevelShape& level : levels) {
+	num_blocks += level.rank + level.num_AX + level.num_BX + level.num_MX + 2;
+  }
+  arena.Reserve(bytes + num_blocks * StackArena::kAlignment);
 }
 
 #endif  // _MEMORY_MANAGER_HPP_
@@ -0,0 +1,161 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _BLOCK_LAYOUT_HPP_
+#define _BLOCK_LAYOUT_HPP_
+
+// Block-recursive storage for the operands of a fast algorithm.  In column-
+// major storage, a subblock a few levels down the recursion is a view whose
+// columns lie far apart, so the additions on it touch many pages.  Here, the
+// matrix is split into the blocks of the first level of the recursion, which
+// are stored one after another (in column-major order of the blocks), each
+// one split in the same way by the next level, down to the leaves, which are
+// column-major.  This is the Morton (Z-order) layout when every level splits
+// the matrix 2 x 2.
+//
+// Every subblock at every level is then contiguous, and it is the matrix
+// Matrix(data, rows, rows, cols) in the eyes of an addition: the additions
+// combine blocks with the same layout entry by entry, so they only need the
+// entries in the same order, and they stream through memory.  The dimensions
+// are padded with zeros to multiples of the products of the block grids, so
+// that nothing is peeled.  See runtime::FastMatmul for running on it.
+
+#include "linalg.hpp"
+#include "MemoryManager.hpp"
+#include "padding.hpp"
+
+#include <vector>
+
+template <typename Scalar>
+class BlockRecursiveMatrix {
+public:
+  // An m x n matrix whose rows and columns are split at level l like the
+  // row_dim and col_dim dimensions of levels[l], where 0, 1, and 2 are the m,
+  // k, and n dimensions of the base case.
+  BlockRecursiveMatrix(const std::vector<LevelShape>& levels, int m, int n, int row_dim,
+                       int col_dim) :
+    m_(m), n_(n),
+    storage_(PaddedDim(levels, m, row_dim), PaddedDim(levels, n, col_dim)) {
+    for (const LevelShape& level : levels) {
+      row_blocks_.push_back(GridDim(level, row_dim));
+      col_blocks_.push_back(GridDim(level, col_dim));
+    }
+    ZeroOut(storage_);
+    AddLeaves(0, 0, storage_.m(), storage_.n(), 0, 0);
+  }
+
+  // Copy a column-major m x n matrix into the blocks.
+  void CopyFrom(Matrix<Scalar>& src) {
+    if (src.m() != m_ || src.n() != n_) {
+      throw std::logic_error("Block-recursive matrix has the wrong dimensions");
+    }
+#ifdef _PARALLEL_
+# pragma omp parallel for schedule(dynamic)
+#endif
+    for (int l = 0; l < static_cast<int>(leaves_.size()); ++l) {
+      const Leaf& leaf = leaves_[l];
+      Scalar *dst = storage_.data() + leaf.offset;
+      for (int j = 0; j < leaf.n && leaf.col + j < n_; ++j) {
+        for (int i = 0; i < leaf.m && leaf.row + i < m_; ++i) {
+          dst[i + static_cast<long>(j) * leaf.m] =
+            src.data()[leaf.row + i + static_cast<long>(leaf.col + j) * src.stride()];
+        }
+      }
+    }
+  }
+
+  // Copy the blocks out to a column-major m x n matrix.
+  void CopyTo(Matrix<Scalar>& dst) {
+    if (dst.m() != m_ || dst.n() != n_) {
+      throw std::logic_error("Block-recursive matrix has the wrong dimensions");
+    }
+#ifdef _PARALLEL_
+# pragma omp parallel for schedule(dynamic)
+#endif
+    for (int l = 0; l < static_cast<int>(leaves_.size()); ++l) {
+      const Leaf& leaf = leaves_[l];
+      const Scalar *src = storage_.data() + leaf.offset;
+      for (int j = 0; j < leaf.n && leaf.col + j < n_; ++j) {
+        for (int i = 0; i < leaf.m && leaf.row + i < m_; ++i) {
+          dst.data()[leaf.row + i + static_cast<long>(leaf.col + j) * dst.stride()] =
+            src[i + static_cast<long>(j) * leaf.m];
+        }
+      }
+    }
+  }
+
+  // The padded matrix, which the fast algorithms run on.  Its subblocks are
+  // only meaningful as the blocks of the layout (see BlockRecursiveSubblock).
+  Matrix<Scalar>& matrix() { return storage_; }
+
+  // Logical (unpadded) dimensions
+  int m() const { return m_; }
+  int n() const { return n_; }
+
+  const std::vector<int>& row_blocks() const { return row_blocks_; }
+  const std::vector<int>& col_blocks() const { return col_blocks_; }
+
+private:
+  struct Leaf {
+    Leaf(int row, int col, int m, int n, long offset) :
+      row(row), col(col), m(m), n(n), offset(offset) {}
+    int row;
+    int col;
+    int m;
+    int n;
+    long offset;
+  };
+
+  static int GridDim(const LevelShape& level, int dim) {
+    return dim == 0 ? level.m : (dim == 1 ? level.k : level.n);
+  }
+
+  // Record the leaves of the rows x cols block at (row, col) of the padded
+  // matrix, which starts at offset in the storage and is split from level on.
+  void AddLeaves(int row, int col, int rows, int cols, long offset, int level) {
+    if (level == static_cast<int>(row_blocks_.size())) {
+      leaves_.push_back(Leaf(row, col, rows, cols, offset));
+      return;
+    }
+    int block_rows = rows / row_blocks_[level];
+    int block_cols = cols / col_blocks_[level];
+    long block_size = static_cast<long>(block_rows) * block_cols;
+    for (int j = 0; j < col_blocks_[level]; ++j) {
+      for (int i = 0; i < row_blocks_[level]; ++i) {
+        AddLeaves(row + i * block_rows, col + j * block_cols, block_rows, block_cols,
+                  offset + (i + j * row_blocks_[level]) * block_size, level + 1);
+      }
+    }
+  }
+
+  int m_;
+  int n_;
+  Matrix<Scalar> storage_;
+  std::vector<int> row_blocks_;
+  std::vector<int> col_blocks_;
+  std::vector<Leaf> leaves_;
+};
+
+
+// The contiguous (row_ind, col_ind) block (1-indexed) of a block-recursive
+// matrix that is split num_block_rows x num_block_cols, in the same order as
+// Matrix::Subblock.
+template <typename Scalar>
+Matrix<Scalar> BlockRecursiveSubblock(Matrix<Scalar>& A, int num_block_rows,
+                                      int num_block_cols, int row_ind, int col_ind) {
+  assert(A.stride() == A.m());
+  int block_rows = A.m() / num_block_rows;
+  int block_cols = A.n() / num_block_cols;
+  long block_size = static_cast<long>(block_rows) * block_cols;
+  long offset = ((row_ind - 1) + static_cast<long>(col_ind - 1) * num_block_rows) * block_size;
+  return Matrix<Scalar>(A.data() + offset, block_rows, block_rows, block_cols,
+                        A.multiplier());
+}
+
+#endif  // _BLOCK_LAYOUT_HPP_
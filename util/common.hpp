@@ -14,12 +14,13 @@
 #define _BFS_PAR_ 2
 #define _HYBRID_PAR_ 3
 
-#include "MemoryManager.hpp"
 #include "linalg.hpp"
 #ifdef _PARALLEL_
 # include "omp.h"
 #endif
 #include "par_util.hpp"
+#include "MemoryManager.hpp"
+#include "fast_matmul_plan.hpp"
 
 
 #include "options.hpp"
@@ -0,0 +1,168 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _FAST_MATMUL_PLAN_HPP_
+#define _FAST_MATMUL_PLAN_HPP_
+
+#include "linalg.hpp"
+#include "MemoryManager.hpp"
+#include "padding.hpp"
+#ifdef _PARALLEL_
+# include "omp.h"
+#endif
+#include "par_util.hpp"
+#include "task_pool.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+// A reusable execution plan for one fast algorithm and one problem shape.
+// The constructor does all of the per-shape setup that the FastMatmul wrappers
+// used to do on every call: it allocates the temporaries in the memory manager
+// (or, in sequential mode, a stack arena for them), counts the threads, and
+// configures BLAS threading.  Execute() can then be called any number of times
+// on matrices of the planned shape.
+//
+// The generated code provides MakePlan() to build a plan for its algorithm:
+//
+//     FastMatmulPlan<double> plan = strassen::MakePlan<double>(m, k, n, num_steps);
+//     for (...) {
+//       plan.Execute(A, B, C);
+//     }
+//
+// If ShouldPad picks padding for the shape (see Padding()), the plan also
+// owns zero-padded copies of the operands, and the recursion runs on those.
+template <typename Scalar>
+class FastMatmulPlan {
+public:
+  // Signature of the generated FastMatmulRecursive functions.
+  typedef void (*RecursiveFunc)(LockAndCounter&, MemoryManager<Scalar>&, Matrix<Scalar>&,
+                                Matrix<Scalar>&, Matrix<Scalar>&, int, int, int, double,
+                                int, Scalar);
+
+  // Plan for multiplying a num_rows_A x num_cols_A matrix with a
+  // num_cols_A x num_cols_B matrix with num_steps of recursion of the
+  // algorithm with the given shape.
+  FastMatmulPlan(RecursiveFunc recursive, const LevelShape& shape, int num_rows_A,
+                 int num_cols_A, int num_cols_B, int num_steps, double x=1e-8) :
+    recursive_(recursive), num_rows_A_(num_rows_A), num_cols_A_(num_cols_A),
+    num_cols_B_(num_cols_B), num_steps_(num_steps), x_(x), num_threads_(0), schedule_(NULL) {
+    total_multiplies_ = int_pow(shape.rank, num_steps);
+    std::vector<LevelShape> levels(num_steps, shape);
+    pad_ = ShouldPad(levels, num_rows_A, num_cols_A, num_cols_B);
+    if (pad_) {
+      num_rows_A = PaddedDim(levels, num_rows_A, 0);
+      num_cols_A = PaddedDim(levels, num_cols_A, 1);
+      num_cols_B = PaddedDim(levels, num_cols_B, 2);
+      padded_ = PaddedOperands<Scalar>(num_rows_A, num_cols_A, num_cols_B);
+    }
+
+    // Set parameters needed for all types of parallelism.
+#ifdef _PARALLEL_
+# pragma omp parallel
+    {
+      if (omp_get_thread_num() == 0) { num_threads_ = omp_get_num_threads(); }
+    }
+    omp_set_nested(1);
+    blas::SetDynamic(false);
+
+    // The task schedule depends on the number of threads, so the memory
+    // manager can only share buffers once that is known.
+    mem_mngr_.Allocate(levels, num_rows_A, num_cols_A, num_cols_B, num_threads_);
+#else
+    // The sequential recursion allocates its temporaries as it goes; they come
+    // from one preallocated slab instead of the heap.
+    ReserveSequentialArena<Scalar>(arena_, levels, num_rows_A, num_cols_A, num_cols_B);
+#endif
+    // The recursion looks up its tasks and waits here.  The memory manager
+    // walks the same schedule.
+    std::vector<int> steps = default_parallel_steps(num_steps);
+    int groups = RemainderGroups(levels, steps, num_rows_A, num_cols_A, num_cols_B,
+                                 num_threads_);
+    schedule_ = &TaskSchedule::Get(std::vector<int>(num_steps, shape.rank), steps,
+                                   num_threads_, groups);
+  }
+
+  FastMatmulPlan(FastMatmulPlan<Scalar>&& that) = default;
+
+  // C := alpha * A * B + beta * C.  The return value is the time in
+  // milliseconds spent in the recursion, including any copies for padding.
+  double Execute(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C,
+                 Scalar alpha=Scalar(1.0), Scalar beta=Scalar(0.0)) {
+    if (A.m() != num_rows_A_ || A.n() != num_cols_A_ || B.m() != num_cols_A_ ||
+        B.n() != num_cols_B_ || C.m() != num_rows_A_ || C.n() != num_cols_B_) {
+      throw std::logic_error("Matrix dimensions do not match the plan");
+    }
+    using FpMilliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    if (pad_) {
+      padded_.CopyIn(A, B, C, beta);
+      padded_.C().set_multiplier(Scalar(1.0));
+      Recurse(padded_.A(), padded_.B(), padded_.C(), alpha, beta);
+      padded_.CopyOut(C);
+    } else {
+      Recurse(A, B, C, alpha, beta);
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return FpMilliseconds(t2 - t1).count();
+  }
+
+  int num_threads() const { return num_threads_; }
+  // Which multiplies run as tasks and where the recursion waits for them.
+  const TaskSchedule& schedule() const { return *schedule_; }
+  int num_steps() const { return num_steps_; }
+  // True if the recursion runs on padded copies of the operands.
+  bool padded() const { return pad_; }
+  // Number of scalars allocated for temporaries and padded operands.
+  long workspace_size() const {
+    return mem_mngr_.Size() + arena_.capacity() / sizeof(Scalar) +
+      (pad_ ? padded_.size() : 0);
+  }
+
+private:
+  void Recurse(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C, Scalar alpha,
+               Scalar beta) {
+    A.set_multiplier(alpha);
+    int extra_multiplies = num_threads_ > 0 ? total_multiplies_ % num_threads_ : 0;
+    LockAndCounter locker(total_multiplies_ - extra_multiplies, schedule_);
+
+#ifndef _PARALLEL_
+    ArenaScope arena_scope(&arena_);
+#endif
+    RunTaskParallel(num_threads_, [this] {
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_ || _PARALLEL_ == _HYBRID_PAR_)
+        // Leaf multiplies in tasks run single-threaded GEMMs.  This is reset on
+        // every call because the recursion changes the setting on some threads.
+        if (_PARALLEL_ == _BFS_PAR_ || num_threads_ <= total_multiplies_) {
+          blas::SetNumThreadsLocal(1);
+        }
+#endif
+      }, [&] {
+        recursive_(locker, mem_mngr_, A, B, C, num_steps_, num_steps_, 0, x_, num_threads_,
+                   beta);
+      });
+  }
+
+  RecursiveFunc recursive_;
+  int num_rows_A_;
+  int num_cols_A_;
+  int num_cols_B_;
+  int num_steps_;
+  double x_;
+  int num_threads_;
+  int total_multiplies_;
+  const TaskSchedule *schedule_;
+  MemoryManager<Scalar> mem_mngr_;
+  StackArena arena_;
+  bool pad_;
+  PaddedOperands<Scalar> padded_;
+};
+
+#endif  // _FAST_MATMUL_PLAN_HPP_
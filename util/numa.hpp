@@ -0,0 +1,258 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _NUMA_HPP_
+#define _NUMA_HPP_
+
+// Placement of work and memory on the NUMA nodes (sockets) of a machine.
+// In NUMA mode, the top-level multiplies of the recursion are split into
+// contiguous blocks, one per node.  Each block runs as tasks in a team of
+// threads that is bound to the node's CPUs, and the temporaries of its
+// subtrees are bound to the node's memory.
+
+#include "blas_backend.hpp"
+#ifdef _PARALLEL_
+# include "omp.h"
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+# include <sched.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+class NumaPartition {
+public:
+  // Partition num_threads threads over the NUMA nodes of this machine, using
+  // the CPUs that the calling thread may run on.
+  explicit NumaPartition(int num_threads) {
+    Init(DetectNodes(), num_threads);
+  }
+
+  // Partition over given nodes: node_cpus[i] lists the CPUs of node i.
+  NumaPartition(const std::vector< std::vector<int> >& node_cpus, int num_threads) {
+    Init(node_cpus, num_threads);
+  }
+
+  int num_nodes() const { return node_cpus_.size(); }
+  int num_threads(int node) const { return node_threads_[node]; }
+  const std::vector<int>& cpus(int node) const { return node_cpus_[node]; }
+
+  // Multiplies [FirstTask(node, n), FirstTask(node + 1, n)) of n top-level
+  // multiplies run on the node.  The split is proportional to the number of
+  // threads on each node.
+  int FirstTask(int node, int num_tasks) const {
+    long threads_before = 0;
+    long total_threads = 0;
+    for (int i = 0; i < num_nodes(); ++i) {
+      if (i < node) {
+        threads_before += node_threads_[i];
+      }
+      total_threads += node_threads_[i];
+    }
+    return static_cast<int>(threads_before * num_tasks / total_threads);
+  }
+
+  // Node that runs top-level multiply task of num_tasks.
+  int NodeOfTask(int task, int num_tasks) const {
+    int node = 0;
+    while (node + 1 < num_nodes() && FirstTask(node + 1, num_tasks) <= task) {
+      ++node;
+    }
+    return node;
+  }
+
+  // Prefer the node's memory for the pages in [ptr, ptr + bytes).  Only whole
+  // pages are bound, and only pages that have not been touched yet move.
+  // Returns false if the pages could not be bound (e.g., the node id is not a
+  // real node).
+  static bool BindMemory(void *ptr, size_t bytes, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    const int kMpolPreferred = 1;
+    const int kMaxNodes = 1024;
+    if (node < 0 || node >= kMaxNodes) {
+      return false;
+    }
+    unsigned long mask[kMaxNodes / (8 * sizeof(unsigned long))] = {0};
+    mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t start = (reinterpret_cast<uintptr_t>(ptr) + page - 1) / page * page;
+    uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + bytes) / page * page;
+    if (end <= start) {
+      return true;
+    }
+    // The kernel reads maxnode - 1 bits of the mask.
+    return syscall(SYS_mbind, start, end - start, kMpolPreferred, mask,
+                   kMaxNodes + 1, 0) == 0;
+#else
+    return false;
+#endif
+  }
+
+  // Restrict the calling thread to the CPUs of a node for the lifetime of
+  // this object.
+  class ThreadBinding {
+  public:
+    ThreadBinding(const NumaPartition& numa, int node) : bound_(false) {
+#ifdef __linux__
+      if (sched_getaffinity(0, sizeof(previous_), &previous_) != 0) {
+        return;
+      }
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      for (int cpu : numa.cpus(node)) {
+        CPU_SET(cpu, &cpus);
+      }
+      bound_ = sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#endif
+    }
+
+    ~ThreadBinding() {
+#ifdef __linux__
+      if (bound_) {
+        sched_setaffinity(0, sizeof(previous_), &previous_);
+      }
+#endif
+    }
+
+  private:
+    bool bound_;
+#ifdef __linux__
+    cpu_set_t previous_;
+#endif
+  };
+
+private:
+  void Init(const std::vector< std::vector<int> >& node_cpus, int num_threads) {
+    for (const std::vector<int>& cpus : node_cpus) {
+      if (!cpus.empty()) {
+        node_cpus_.push_back(cpus);
+      }
+    }
+    if (node_cpus_.empty()) {
+      node_cpus_.push_back(std::vector<int>(1, 0));
+    }
+    // Threads go to the nodes in proportion to their CPUs, with at least one
+    // thread on each node.
+    int total_cpus = 0;
+    for (const std::vector<int>& cpus : node_cpus_) {
+      total_cpus += cpus.size();
+    }
+    if (num_threads < num_nodes()) {
+      num_threads = num_nodes();
+    }
+    int assigned = 0;
+    int cpus_before = 0;
+    for (const std::vector<int>& cpus : node_cpus_) {
+      cpus_before += cpus.size();
+      int end = static_cast<int>(static_cast<long>(num_threads) * cpus_before / total_cpus);
+      int threads = std::max(1, end - assigned);
+      node_threads_.push_back(threads);
+      assigned += threads;
+    }
+  }
+
+  // CPUs of each node, from sysfs.  Machines without NUMA information are
+  // one node.
+  static std::vector< std::vector<int> > DetectNodes() {
+    std::vector< std::vector<int> > nodes;
+#ifdef __linux__
+    cpu_set_t allowed;
+    bool have_allowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for (int node = 0; ; ++node) {
+      char path[128];
+      snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+      std::ifstream file(path);
+      std::string list;
+      if (!std::getline(file, list)) {
+        break;
+      }
+      std::vector<int> cpus;
+      for (int cpu : ParseCpuList(list)) {
+        if (!have_allowed || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) {
+          cpus.push_back(cpu);
+        }
+      }
+      nodes.push_back(cpus);
+    }
+    if (nodes.empty() && have_allowed) {
+      std::vector<int> cpus;
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+          cpus.push_back(cpu);
+        }
+      }
+      nodes.push_back(cpus);
+    }
+#endif
+    return nodes;
+  }
+
+  // Parse a list like "0-7,16-23".
+  static std::vector<int> ParseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+      int first, last;
+      int num_read = sscanf(range.c_str(), "%d-%d", &first, &last);
+      if (num_read == 1) {
+        last = first;
+      } else if (num_read != 2) {
+        continue;
+      }
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+
+  std::vector< std::vector<int> > node_cpus_;
+  std::vector<int> node_threads_;
+};
+
+
+#ifdef _PARALLEL_
+// Run task(i) for the num_tasks top-level multiplies, with the block of
+// multiplies for each node running as tasks in a team of threads bound to
+// the node.  Leaf multiplies run single-threaded GEMMs on the team's threads.
+template <typename Func>
+void RunOnNodes(const NumaPartition& numa, int num_tasks, Func task) {
+# pragma omp parallel num_threads(numa.num_nodes())
+  {
+    int node = omp_get_thread_num();
+    int first = numa.FirstTask(node, num_tasks);
+    int last = numa.FirstTask(node + 1, num_tasks);
+# pragma omp parallel num_threads(numa.num_threads(node))
+    {
+      NumaPartition::ThreadBinding binding(numa, node);
+      blas::SetNumThreadsLocal(1);
+# pragma omp single
+      {
+        for (int i = first; i < last; ++i) {
+# pragma omp task default(shared) firstprivate(i) untied
+          task(i);
+        }
+# pragma omp taskwait
+      }
+    }
+  }
+}
+#endif
+
+#endif  // _NUMA_HPP_
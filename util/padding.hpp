@@ -0,0 +1,160 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _PADDING_HPP_
+#define _PADDING_HPP_
+
+// Padding as an alternative to dynamic peeling.  DynamicPeeling handles the
+// rows and columns that do not divide evenly with up to three thin GEMMs per
+// node of the recursion tree, and thin GEMMs run far below peak.  Instead,
+// the matrices can be padded with zeros up to the nearest multiple of the
+// base case dimensions, so that no node has anything to peel.
+//
+// The padded copies are allocated (and their fringes zeroed) once; each
+// multiply then copies the interior of A, B, and C in and C back out.
+// ShouldPad compares a rough cost of the two.
+
+#include "linalg.hpp"
+#include "MemoryManager.hpp"
+#include "par_util.hpp"
+
+#include <algorithm>
+#include <vector>
+
+enum class PaddingMode {
+  PEEL,  // always peel (the default)
+  PAD,   // always pad
+  AUTO,  // whichever ShouldPad estimates to be cheaper
+};
+
+
+inline PaddingMode& Padding() {
+  static PaddingMode mode = PaddingMode::PEEL;
+  return mode;
+}
+
+
+// Cost of copying one entry, in flops.  (GemmCost is in par_util.hpp.)
+const double kCopyFlops = 16.0;
+
+
+// Estimated time of the leaf multiplies and the peeling of an m x k x n
+// multiply with levels[l] at level l of the recursion.
+inline double RecursionCost(const std::vector<LevelShape>& levels, int m, int k, int n) {
+  double cost = 0.0;
+  double num_nodes = 1.0;
+  for (const LevelShape& level : levels) {
+    int extra_m = m % level.m;
+    int extra_k = k % level.k;
+    int extra_n = n % level.n;
+    // The three GEMMs of DynamicPeeling.
+    cost += num_nodes * (GemmCost(m - extra_m, extra_k, n - extra_n) +
+                         GemmCost(m, k, extra_n) + GemmCost(extra_m, k, n - extra_n));
+    m /= level.m;
+    k /= level.k;
+    n /= level.n;
+    num_nodes *= level.rank;
+  }
+  return cost + num_nodes * GemmCost(m, k, n);
+}
+
+
+// Smallest multiple of the product of the base case dimensions that is at
+// least dim.  which is 0, 1, or 2 for the m, k, or n dimension.
+inline int PaddedDim(const std::vector<LevelShape>& levels, int dim, int which) {
+  int multiple = 1;
+  for (const LevelShape& level : levels) {
+    multiple *= which == 0 ? level.m : (which == 1 ? level.k : level.n);
+  }
+  return (dim + multiple - 1) / multiple * multiple;
+}
+
+
+// True if padding an m x k x n multiply is estimated to be cheaper than
+// peeling, according to Padding().
+inline bool ShouldPad(const std::vector<LevelShape>& levels, int m, int k, int n) {
+  if (Padding() == PaddingMode::PEEL || levels.empty()) {
+    return false;
+  }
+  int m_pad = PaddedDim(levels, m, 0);
+  int k_pad = PaddedDim(levels, k, 1);
+  int n_pad = PaddedDim(levels, n, 2);
+  if (m_pad == m && k_pad == k && n_pad == n) {
+    return false;
+  }
+  if (Padding() == PaddingMode::PAD) {
+    return true;
+  }
+  double copy = kCopyFlops * (static_cast<double>(m) * k + static_cast<double>(k) * n +
+                              2.0 * m * n);
+  return RecursionCost(levels, m_pad, k_pad, n_pad) + copy <
+    RecursionCost(levels, m, k, n);
+}
+
+
+// Zero-padded copies of A, B, and C for one padded shape.
+template <typename Scalar>
+class PaddedOperands {
+public:
+  PaddedOperands() : size_(0) {}
+
+  // The fringes are zeroed here, and CopyIn only writes the interiors.  The
+  // fringe of C is never read into the interior, so what the multiply leaves
+  // there does not matter.
+  PaddedOperands(int m_pad, int k_pad, int n_pad) :
+    A_(m_pad, k_pad), B_(k_pad, n_pad), C_(m_pad, n_pad),
+    size_(static_cast<long>(m_pad) * k_pad + static_cast<long>(k_pad) * n_pad +
+          static_cast<long>(m_pad) * n_pad) {
+    ZeroOut(A_);
+    ZeroOut(B_);
+    ZeroOut(C_);
+  }
+
+  // Copy A and B (and C, if beta is nonzero) into the padded matrices.
+  void CopyIn(Matrix<Scalar>& A, Matrix<Scalar>& B, Matrix<Scalar>& C, Scalar beta) {
+    CopyInterior(A, A_);
+    CopyInterior(B, B_);
+    if (beta != Scalar(0.0)) {
+      CopyInterior(C, C_);
+    }
+  }
+
+  // Copy the interior of the padded C back to C.
+  void CopyOut(Matrix<Scalar>& C) {
+    Matrix<Scalar> interior = C_.Submatrix(0, 0, C.m(), C.n());
+    CopyInterior(interior, C);
+  }
+
+  Matrix<Scalar>& A() { return A_; }
+  Matrix<Scalar>& B() { return B_; }
+  Matrix<Scalar>& C() { return C_; }
+
+  // Number of scalars allocated.
+  long size() const { return size_; }
+
+private:
+  // The top-left corner of dst <-- src.
+  static void CopyInterior(Matrix<Scalar>& src, Matrix<Scalar>& dst) {
+#ifdef _PARALLEL_
+# pragma omp parallel for
+#endif
+    for (int j = 0; j < src.n(); ++j) {
+      const Scalar *src_col = src.data() + static_cast<long>(j) * src.stride();
+      Scalar *dst_col = dst.data() + static_cast<long>(j) * dst.stride();
+      std::copy(src_col, src_col + src.m(), dst_col);
+    }
+  }
+
+  Matrix<Scalar> A_;
+  Matrix<Scalar> B_;
+  Matrix<Scalar> C_;
+  long size_;
+};
+
+#endif  // _PADDING_HPP_
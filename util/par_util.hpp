@@ -11,9 +11,29 @@
 #define _PAR_UTIL_
 
 #include "common.hpp"
+#include "task_pool.hpp"
 #include "math.h"
 #include "assert.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// base^exp in integer arithmetic (pow rounds for large ranks).
+int int_pow(int base, int exp) {
+  int result = 1;
+  for (int i = 0; i < exp; ++i) {
+	result *= base;
+  }
+  return result;
+}
+
 int earliest_leaf_start(int mults_per_step, int steps_left, int start_index, int position) {
   if (steps_left == 1) {
 	return start_index;
@@ -31,7 +51,7 @@ bool should_task_wait(int mults_per_step, int total_rec_steps, int steps_left,
   return position == mults_per_step;
 #endif
 
-  int total_multiplies = pow(mults_per_step, total_rec_steps);
+  int total_multiplies = int_pow(mults_per_step, total_rec_steps);
   int extra_multiplies = total_multiplies % num_threads;
 
   // HYBRID does all DFS, so no need to wait.
@@ -70,7 +90,7 @@ bool should_launch_task(int mults_per_step, int total_rec_steps, int steps_left,
   return true;
 #endif
 
-  int total_multiplies = pow(mults_per_step, total_rec_steps);
+  int total_multiplies = int_pow(mults_per_step, total_rec_steps);
   int extra_multiplies = total_multiplies % num_threads;
 
   // If the number of threads is greater than the total number of multiplies,
@@ -94,54 +114,547 @@ bool should_launch_task(int mults_per_step, int total_rec_steps, int steps_left,
   return true;
 }
 
+// The versions below are for recursions that use a different algorithm at
+// each level.  ranks[l] is the number of multiplies at level l of the
+// recursion tree and level is the level of the current node.  Multiply
+// position p of the node with start index s has children starting at
+// (s + p - 1) * ranks[level + 1].
+int earliest_leaf_start(const std::vector<int>& ranks, int level, int start_index,
+                        int position) {
+  if (level + 1 == static_cast<int>(ranks.size())) {
+	return start_index;
+  }
+  int earliest_child_start = (start_index + position - 1) * ranks[level + 1];
+  return earliest_leaf_start(ranks, level + 1, earliest_child_start, 1);
+}
+
+int num_leaf_multiplies(const std::vector<int>& ranks) {
+  int total = 1;
+  for (int rank : ranks) {
+	total *= rank;
+  }
+  return total;
+}
+
+bool should_task_wait(const std::vector<int>& ranks, int level, int start_index,
+                      int position, int num_threads) {
+  int mults_per_step = ranks[level];
+  assert(0 < position && position <= mults_per_step);
+
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_)
+  return position == mults_per_step;
+#endif
+
+  int num_multiplies = num_leaf_multiplies(ranks);
+  int extra_multiplies = num_multiplies % num_threads;
+
+  if (num_threads > num_multiplies) {
+	return false;
+  }
+  if (position == mults_per_step) {
+    return true;
+  }
+
+  int end_index = num_multiplies - extra_multiplies;
+  bool bottom_level = level + 1 == static_cast<int>(ranks.size());
+  if (bottom_level && start_index + position == end_index) {
+    return true;
+  }
+
+  int smallest_index = earliest_leaf_start(ranks, level, start_index, position);
+  return smallest_index >= end_index;
+}
+
+bool should_launch_task(const std::vector<int>& ranks, int level, int start_index,
+                        int position, int num_threads) {
+  assert(0 < position && position <= ranks[level]);
+
+#if defined(_PARALLEL_) && (_PARALLEL_ == _BFS_PAR_)
+  return true;
+#endif
+
+  int num_multiplies = num_leaf_multiplies(ranks);
+  int extra_multiplies = num_multiplies % num_threads;
+
+  if (num_threads > num_multiplies) {
+    return false;
+  }
+
+  int end_index = num_multiplies - extra_multiplies;
+  bool bottom_level = level + 1 == static_cast<int>(ranks.size());
+  if (bottom_level && start_index + position > end_index) {
+    return false;
+  }
+
+  int smallest_index = earliest_leaf_start(ranks, level, start_index, position);
+  return smallest_index < end_index;
+}
+
+// The versions below also take the parallel strategy of each level of the
+// recursion: steps[l] is _DFS_PAR_, _BFS_PAR_, or _HYBRID_PAR_.  DFS levels
+// run their multiplies one after the other (with parallelism inside), and BFS
+// levels run all of them as tasks.  Mixing the two lets a recursion take DFS
+// steps at the top, where the temporaries are largest, to save memory.
+bool should_task_wait(const std::vector<int>& steps, const std::vector<int>& ranks,
+                      int level, int start_index, int position, int num_threads) {
+  switch (steps[level]) {
+  case _BFS_PAR_:
+	return position == ranks[level];
+  case _HYBRID_PAR_:
+	return should_task_wait(ranks, level, start_index, position, num_threads);
+  default:
+	return false;
+  }
+}
+
+bool should_launch_task(const std::vector<int>& steps, const std::vector<int>& ranks,
+                        int level, int start_index, int position, int num_threads) {
+  switch (steps[level]) {
+  case _BFS_PAR_:
+	return true;
+  case _HYBRID_PAR_:
+	return should_launch_task(ranks, level, start_index, position, num_threads);
+  default:
+	return false;
+  }
+}
+
+// Every level uses the parallel mode that the code was compiled with.
+std::vector<int> default_parallel_steps(int num_levels) {
 #ifdef _PARALLEL_
-class Lock {
+  return std::vector<int>(num_levels, _PARALLEL_);
+#else
+  return std::vector<int>(num_levels, _DFS_PAR_);
+#endif
+}
+
+// A GEMM whose smallest dimension is kHalfEfficiencyDim runs at about half
+// of the speed of a large one.
+const double kHalfEfficiencyDim = 16.0;
+
+
+// Estimated time of an a x b x c GEMM, in flops at full speed.
+inline double GemmCost(double a, double b, double c) {
+  double d = std::min(a, std::min(b, c));
+  if (d <= 0) {
+    return 0.0;
+  }
+  return 2.0 * a * b * c * (d + kHalfEfficiencyDim) / d;
+}
+
+
+// Estimated time of an m x k x n GEMM on num_threads threads, which split the
+// larger of m and n, in flops at the full speed of one thread.
+inline double ParallelGemmCost(double m, double k, double n, int num_threads) {
+  if (m >= n) {
+    return GemmCost(m / num_threads, k, n);
+  }
+  return GemmCost(m, k, n / num_threads);
+}
+
+
+// Number of thread groups for the leaves at the end of a HYBRID recursion
+// that do not fill a BFS wave (see TaskSchedule).  0 means that
+// TaskSchedule::RemainderGroups picks it with the cost model, and 1 runs
+// them one after another on all of the threads.
+inline int& HybridRemainderGroups() {
+  static int num_groups = 0;
+  return num_groups;
+}
+
+
+// The answers of should_launch_task and should_task_wait for every multiply of
+// a recursion, computed once.  Multiply p (1-indexed) of the node at level l
+// with start index s is entry s + p - 1 of level l, since the start indices
+// of the nodes at level l are multiples of ranks[l].  Get() caches the
+// schedules, so that the recursion only looks them up.
+//
+// When the bottom level is HYBRID, the leaves after the last full BFS wave
+// (the remainder) run DFS, one after the other on all of the threads.  With
+// remainder_groups > 1, they instead run as tasks, remainder_groups at a time
+// within each node, with threads(...) BLAS threads each.
+class TaskSchedule {
 public:
-  Lock() { omp_init_lock(&lock_); }
-  ~Lock() { omp_destroy_lock(&lock_); }
+  TaskSchedule(const std::vector<int>& ranks, const std::vector<int>& steps,
+               int num_threads, int remainder_groups=1) :
+    ranks_(ranks), steps_(steps), num_threads_(num_threads),
+    requested_groups_(remainder_groups), remainder_groups_(1), group_threads_(0),
+    flags_(ranks.size()) {
+    long num_multiplies = 1;
+    for (int level = 0; level < static_cast<int>(ranks.size()); ++level) {
+	  num_multiplies *= ranks[level];
+	  if (num_multiplies > kMaxEntries) {
+		throw std::logic_error("Recursion is too deep for a task schedule");
+	  }
+	  std::vector<unsigned char>& flags = flags_[level];
+	  flags.resize(num_multiplies);
+	  for (int i = 0; i < num_multiplies; ++i) {
+		int start_index = i - i % ranks[level];
+		int position = i % ranks[level] + 1;
+		flags[i] = (should_launch_task(steps, ranks, level, start_index, position, num_threads)
+					? kLaunch : 0) |
+		  (should_task_wait(steps, ranks, level, start_index, position, num_threads)
+		   ? kWait : 0);
+	  }
+    }
+	if (remainder_groups > 1 && num_threads > 1 && !ranks.empty() &&
+		steps.back() == _HYBRID_PAR_) {
+	  GroupRemainder(remainder_groups);
+	}
+  }
+
+  // True if the multiply runs as a task (with single-threaded leaves).
+  bool launch(int level, int start_index, int position) const {
+	return (flags_[level][start_index + position - 1] & kLaunch) != 0;
+  }
+
+  // True if the node waits for its tasks after the multiply.
+  bool wait(int level, int start_index, int position) const {
+	return (flags_[level][start_index + position - 1] & kWait) != 0;
+  }
+
+  // BLAS threads for a leaf of a remainder group, or 0 for the usual number.
+  int threads(int level, int start_index, int position) const {
+	return (flags_[level][start_index + position - 1] & kGroup) != 0 ? group_threads_ : 0;
+  }
 
-  void Acquire() { omp_set_lock(&lock_); }
-  bool Test() { return omp_test_lock(&lock_); }
-  void Release() { omp_unset_lock(&lock_); }
+  int num_levels() const { return ranks_.size(); }
+  int num_threads() const { return num_threads_; }
+  int remainder_groups() const { return remainder_groups_; }
+
+  // One line per node: for each multiply, 'T' if it is a task, 'G' if it is a
+  // task of a remainder group, and 'D' if it runs in the node's thread (DFS),
+  // followed by '|' if the node waits after it.  Levels with more than
+  // max_nodes_per_level nodes show the first and the last ones, since the
+  // HYBRID remainder is at the end.
+  void Print(std::ostream& out=std::cout, int max_nodes_per_level=64) const {
+	out << "Task schedule for " << num_threads_ << " threads";
+	if (remainder_groups_ > 1) {
+	  out << ", remainder in groups of " << group_threads_ << " threads";
+	}
+	out << std::endl;
+	for (int level = 0; level < num_levels(); ++level) {
+	  int num_nodes = flags_[level].size() / ranks_[level];
+	  out << "Level " << level << " (rank " << ranks_[level] << ", " << num_nodes
+		  << " nodes):" << std::endl;
+	  int num_first = num_nodes;
+	  if (num_nodes > max_nodes_per_level) {
+		num_first = max_nodes_per_level / 2;
+	  }
+	  int last_start = num_nodes - (max_nodes_per_level - num_first);
+	  for (int node = 0; node < num_nodes; ++node) {
+		if (node == num_first && node < last_start) {
+		  out << "  ... " << last_start - num_first << " more" << std::endl;
+		  node = last_start;
+		}
+		out << "  ";
+		for (int p = 1; p <= ranks_[level]; ++p) {
+		  int start_index = node * ranks_[level];
+		  if (threads(level, start_index, p) > 0) {
+			out << 'G';
+		  } else {
+			out << (launch(level, start_index, p) ? 'T' : 'D');
+		  }
+		  if (wait(level, start_index, p)) {
+			out << '|';
+		  }
+		}
+		out << std::endl;
+	  }
+	}
+  }
+
+  // Number of groups for the remainder of a recursion whose leaves are
+  // leaf_m x leaf_k x leaf_n: the one that minimizes the estimated time of
+  // running the remainder in waves of that many leaves, each on an equal
+  // share of the threads, or HybridRemainderGroups() if it is set.
+  static int RemainderGroups(const std::vector<int>& ranks, const std::vector<int>& steps,
+							 int num_threads, int leaf_m, int leaf_k, int leaf_n) {
+	if (ranks.empty() || steps.back() != _HYBRID_PAR_ || num_threads <= 1) {
+	  return 1;
+	}
+	int num_leaves = num_leaf_multiplies(ranks);
+	int num_remainder = num_threads > num_leaves ? num_leaves : num_leaves % num_threads;
+	int max_groups = std::min(num_remainder, num_threads);
+	if (max_groups <= 1) {
+	  return 1;
+	}
+	if (HybridRemainderGroups() > 0) {
+	  return std::min(HybridRemainderGroups(), max_groups);
+	}
+	int best_groups = 1;
+	double best_cost = num_remainder * ParallelGemmCost(leaf_m, leaf_k, leaf_n, num_threads);
+	for (int groups = 2; groups <= max_groups; ++groups) {
+	  int num_waves = (num_remainder + groups - 1) / groups;
+	  double cost = num_waves * ParallelGemmCost(leaf_m, leaf_k, leaf_n, num_threads / groups);
+	  if (cost < best_cost) {
+		best_cost = cost;
+		best_groups = groups;
+	  }
+	}
+	return best_groups;
+  }
+
+  // The schedule for ranks, steps, num_threads, and remainder_groups, built
+  // on first use.
+  static const TaskSchedule& Get(const std::vector<int>& ranks, const std::vector<int>& steps,
+                                 int num_threads, int remainder_groups=1) {
+	const TaskSchedule *last = Last();
+	if (last != NULL && last->Matches(ranks, steps, num_threads, remainder_groups)) {
+	  return *last;
+	}
+	std::lock_guard<std::mutex> guard(CacheMutex());
+	for (auto& schedule : Cache()) {
+	  if (schedule->Matches(ranks, steps, num_threads, remainder_groups)) {
+		Last() = schedule.get();
+		return *schedule;
+	  }
+	}
+	Cache().emplace_back(new TaskSchedule(ranks, steps, num_threads, remainder_groups));
+	Last() = Cache().back().get();
+	return *Cache().back();
+  }
+
+  // The schedule of the generated code: total_rec_steps levels of an algorithm
+  // with rank mults_per_step, in the compiled parallel mode.
+  static const TaskSchedule& Get(int mults_per_step, int total_rec_steps, int num_threads,
+								 int remainder_groups=1) {
+	const TaskSchedule *last = Last();
+	if (last != NULL && last->num_threads_ == num_threads &&
+		last->requested_groups_ == remainder_groups &&
+		last->IsUniform(mults_per_step, total_rec_steps)) {
+	  return *last;
+	}
+	{
+	  // Without building the vectors, so that switching between plans does
+	  // not allocate.
+	  std::lock_guard<std::mutex> guard(CacheMutex());
+	  for (auto& schedule : Cache()) {
+		if (schedule->num_threads_ == num_threads &&
+			schedule->IsUniform(mults_per_step, total_rec_steps)) {
+		  Last() = schedule.get();
+		  return *schedule;
+		}
+	  }
+	}
+	return Get(std::vector<int>(total_rec_steps, mults_per_step),
+			   default_parallel_steps(total_rec_steps), num_threads, remainder_groups);
+  }
+
+private:
+  static const unsigned char kLaunch = 1;
+  static const unsigned char kWait = 2;
+  static const unsigned char kGroup = 4;
+  static const long kMaxEntries = 1L << 26;
+
+  // Launch the remainder leaves as tasks, with a wait after every num_groups
+  // of them in a node and after the last one.
+  void GroupRemainder(int num_groups) {
+	std::vector<unsigned char>& flags = flags_.back();
+	int rank = ranks_.back();
+	long num_leaves = flags.size();
+	long first = num_threads_ > num_leaves ? 0 : num_leaves - num_leaves % num_threads_;
+	if (first == num_leaves) {
+	  return;
+	}
+	remainder_groups_ = num_groups;
+	group_threads_ = std::max(1, num_threads_ / num_groups);
+	for (long i = first; i < num_leaves; ++i) {
+	  long node_first = std::max(first, i - i % rank);
+	  flags[i] |= kLaunch | kGroup;
+	  if ((i - node_first + 1) % num_groups == 0 || i % rank == rank - 1) {
+		flags[i] |= kWait;
+	  }
+	}
+  }
+
+  bool Matches(const std::vector<int>& ranks, const std::vector<int>& steps, int num_threads,
+			   int remainder_groups) const {
+	return num_threads_ == num_threads && requested_groups_ == remainder_groups &&
+	  ranks_ == ranks && steps_ == steps;
+  }
+
+  bool IsUniform(int mults_per_step, int total_rec_steps) const {
+#ifdef _PARALLEL_
+	const int mode = _PARALLEL_;
+#else
+	const int mode = _DFS_PAR_;
+#endif
+	if (num_levels() != total_rec_steps) {
+	  return false;
+	}
+	for (int level = 0; level < num_levels(); ++level) {
+	  if (ranks_[level] != mults_per_step || steps_[level] != mode) {
+		return false;
+	  }
+	}
+	return true;
+  }
+
+  // The schedule that this thread looked up last.
+  static const TaskSchedule *& Last() {
+	static thread_local const TaskSchedule *last = NULL;
+	return last;
+  }
+
+  static std::vector<std::unique_ptr<TaskSchedule> >& Cache() {
+	static std::vector<std::unique_ptr<TaskSchedule> > cache;
+	return cache;
+  }
+
+  static std::mutex& CacheMutex() {
+	static std::mutex mutex;
+	return mutex;
+  }
+
+  std::vector<int> ranks_;
+  std::vector<int> steps_;
+  int num_threads_;
+  int requested_groups_;  // remainder_groups of the constructor
+  int remainder_groups_;  // 1 if there is no remainder to group
+  int group_threads_;
+  std::vector< std::vector<unsigned char> > flags_;
+};
+
+
+// Runs the leaf multiplies of its scope with num_threads BLAS threads, if
+// num_threads is positive (see TaskSchedule::threads).  The count is
+// thread-local, so the scope must not reach a task scheduling point (e.g.,
+// SpawnTask or TaskLoop), where an untied task may move to another thread.
+class ScopedLeafThreads {
+public:
+  explicit ScopedLeafThreads(int num_threads) :
+	num_threads_(num_threads), saved_(blas::NativeThreadsLocal()) {
+	if (num_threads_ > 0) {
+	  blas::SetNumThreadsLocal(num_threads_);
+	}
+  }
+  ~ScopedLeafThreads() {
+	if (num_threads_ > 0) {
+	  blas::SetNumThreadsLocal(saved_);
+	}
+  }
+
+private:
+  int num_threads_;
+  int saved_;
+};
+
+
+// Counts down the inputs of an output addition (the multiplies whose M it
+// reads, and the update for the inner dimension), so that the task that
+// finishes the last input can run the addition right away instead of after
+// the node's TaskWait.  Ready() is true for exactly one caller, and that
+// caller sees the writes of all of the others.
+class InputCountdown {
+public:
+  explicit InputCountdown(int count=0) : count_(count) {}
+
+  void Reset(int count) { count_.store(count, std::memory_order_relaxed); }
+
+  bool Ready() { return count_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
 
 private:
-  omp_lock_t lock_;
+  std::atomic<int> count_;
 };
 
+
+// Time that HYBRID spent at the switch from BFS to DFS, i.e., waiting in
+// LockAndCounter::Acquire for the BFS multiplies to finish, summed over
+// the threads that waited.
+struct SwitchWaitStats {
+  long num_waits;  // Calls to Acquire
+  double wait_ms;  // Total time in them
+};
+
+#ifdef _PARALLEL_
+// Counts down the multiplies that run as BFS tasks, so that the multiplies of
+// the hybrid remainder can wait for all of them before switching to DFS.
+// Decrement is a single atomic operation.  Acquire spins for a short while
+// (running other tasks), and then parks on a condition variable that the
+// last Decrement signals.  The parked thread still wakes up periodically to
+// run tasks, since a task that it could run may be the one that it waits for.
+//
+// The recursion also finds its TaskSchedule here, if one is given.
 class LockAndCounter {
 public:
-  LockAndCounter(int count) : count_(count) { lock_.Acquire(); }
+  LockAndCounter(int count, const TaskSchedule *schedule=NULL) :
+    count_(count), schedule_(schedule) {}
+
+  // The schedule of this multiply, or NULL for the cached one of its shape.
+  const TaskSchedule *schedule() const { return schedule_; }
 
   void Decrement() {
-    #pragma omp critical
-	{
-	  if (count_ > 0) {
-		--count_;
-		if (count_ == 0) {
-		  lock_.Release();
-		}
-	  }
-	}
+    if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      done_.notify_all();
+    }
   }
 
-  // Non-blocking acquire that yields to other tasks.
+  // Wait until the count reaches zero.
   void Acquire() {
-	while (!lock_.Test()) {
-        #pragma omp taskyield
-	}
+    auto t1 = std::chrono::steady_clock::now();
+    for (int spin = 0; !Done(); ++spin) {
+      TaskYield();
+      if (spin >= kSpinsBeforePark) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait_for(lock, std::chrono::microseconds(kParkMicroseconds),
+                       [this] { return Done(); });
+      }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    long wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+    WaitCounters().num_waits.fetch_add(1, std::memory_order_relaxed);
+    WaitCounters().wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  }
+
+  static SwitchWaitStats Stats() {
+    SwitchWaitStats stats = {WaitCounters().num_waits.load(),
+                             WaitCounters().wait_ns.load() * 1e-6};
+    return stats;
+  }
+
+  static void ResetStats() {
+    WaitCounters().num_waits.store(0);
+    WaitCounters().wait_ns.store(0);
   }
-  void Release() { lock_.Release(); }
 
 private:
-  int count_;
-  Lock lock_;
+  static const int kSpinsBeforePark = 64;
+  static const int kParkMicroseconds = 200;
+
+  struct Counters {
+    Counters() : num_waits(0), wait_ns(0) {}
+    std::atomic<long> num_waits;
+    std::atomic<long> wait_ns;
+  };
+
+  static Counters& WaitCounters() {
+    static Counters counters;
+    return counters;
+  }
+
+  // Decrement also counts the multiplies after the BFS ones, so the count
+  // can go below zero.
+  bool Done() const { return count_.load(std::memory_order_acquire) <= 0; }
+
+  std::atomic<int> count_;
+  const TaskSchedule *schedule_;
+  std::mutex mutex_;
+  std::condition_variable done_;
 };
 #else
 // We make this definition so that the sequential code will compile.  This
 // is a little bit of a hack, but it keeps the generated code simpler.
 class LockAndCounter {
 public:
-  LockAndCounter(int count) {}
+  LockAndCounter(int count, const TaskSchedule *schedule=NULL) {}
+  const TaskSchedule *schedule() const { return NULL; }
+  static SwitchWaitStats Stats() {
+    SwitchWaitStats stats = {0, 0.0};
+    return stats;
+  }
+  static void ResetStats() {}
 };
 #endif
 
@@ -149,8 +662,7 @@ public:
 // Switch to DFS style sub-problems in the hybrid parallelism
 void SwitchToDFS(LockAndCounter& locker, int num_threads) {
     locker.Acquire();
-    mkl_set_num_threads_local(num_threads);
-    locker.Release();
+    blas::SetNumThreadsLocal(num_threads);
 }
 #endif
 
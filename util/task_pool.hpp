@@ -0,0 +1,551 @@
+/**
+   Copyright (c) 2014-2015, Sandia Corporation
+   All rights reserved.
+
+   This file is part of fast-matmul and is under the BSD 2-Clause License,
+   which can be found in the LICENSE file in the root directory, or at
+   http://opensource.org/licenses/BSD-2-Clause.
+*/
+
+#ifndef _TASK_POOL_HPP_
+#define _TASK_POOL_HPP_
+
+// Task parallelism for the BFS and HYBRID recursions.  The recursion only
+// uses the functions at the bottom of this file:
+//
+//    RunTaskParallel   run the root of the recursion on num_threads threads
+//    SpawnTask         run a function as a task, or right away
+//    TaskWait          wait for the tasks spawned by the current task
+//    TaskYield         let the thread run other tasks while it spins
+//    TaskLoop          split a loop inside a task among the idle threads
+//
+// By default, these are OpenMP tasks.  Building a parallel version with
+// -DWORK_STEALING runs them on WorkStealingPool instead, which does not depend
+// on the behavior of the OpenMP runtime for untied and nested tasks.  The
+// additions and BLAS still use OpenMP for their own threads, and so does
+// NUMA placement (see RunOnNodes), under which the tasks below the top level
+// run right away.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _PARALLEL_
+# include "omp.h"
+#endif
+
+#if defined(WORK_STEALING) && defined(_PARALLEL_)
+# define _WORK_STEALING_POOL_
+#endif
+
+// Tasks that are spawned by a task (or by the root) and not yet finished.
+struct TaskFrame {
+  TaskFrame() : pending(0) {}
+  std::atomic<int> pending;
+};
+
+
+class PoolTask {
+public:
+  explicit PoolTask(TaskFrame *parent) : parent_(parent), pooled_(false) {}
+  virtual ~PoolTask() {}
+  virtual void Run() = 0;
+  TaskFrame *parent() { return parent_; }
+  // True if the task lives in a block of WorkStealingPool rather than on the
+  // heap.
+  bool pooled() const { return pooled_; }
+  void set_pooled() { pooled_ = true; }
+
+private:
+  TaskFrame *parent_;
+  bool pooled_;
+};
+
+
+template <typename Func>
+class FuncTask : public PoolTask {
+public:
+  FuncTask(TaskFrame *parent, Func func) : PoolTask(parent), func_(func) {}
+  void Run() { func_(); }
+
+private:
+  Func func_;
+};
+
+
+// Chase-Lev work-stealing deque of a fixed capacity (Le et al., "Correct and
+// efficient work-stealing for weak memory models", PPoPP 2013).  The owner
+// pushes and pops at the bottom; other threads steal from the top with a
+// compare-and-swap.
+class TaskDeque {
+public:
+  static const long kCapacity = 1 << 12;
+
+  TaskDeque() : top_(0), bottom_(0), tasks_(new std::atomic<PoolTask *>[kCapacity]) {}
+
+  // Owner only.  Returns false if the deque is full.
+  bool Push(PoolTask *task) {
+    long b = bottom_.load(std::memory_order_relaxed);
+    long t = top_.load(std::memory_order_acquire);
+    if (b - t >= kCapacity) {
+      return false;
+    }
+    tasks_[b & (kCapacity - 1)].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Owner only.  Returns NULL if the deque is empty.
+  PoolTask *Pop() {
+    long b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return NULL;
+    }
+    PoolTask *task = tasks_[b & (kCapacity - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+      // Last task: race with the thieves for it.
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        task = NULL;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  // Any thread.  Returns NULL if the deque is empty or the steal lost a race.
+  PoolTask *Steal() {
+    long t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return NULL;
+    }
+    PoolTask *task = tasks_[t & (kCapacity - 1)].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return NULL;
+    }
+    return task;
+  }
+
+private:
+  std::atomic<long> top_;
+  std::atomic<long> bottom_;
+  std::unique_ptr<std::atomic<PoolTask *>[]> tasks_;
+};
+
+
+// Persistent worker threads with one TaskDeque each.  A thread that waits
+// for tasks runs other tasks in the meantime: first its own, newest first,
+// and then ones stolen from the other workers, oldest first.  That keeps the
+// BFS and HYBRID schedules of should_launch_task and should_task_wait, with
+// a spawn that costs a few atomic operations.
+//
+// The tasks are built in blocks that the pool keeps between runs.  Each run
+// takes the blocks in order and only gives them back at its end, so a run
+// that spawns as many tasks as an earlier one does not allocate.
+class WorkStealingPool {
+public:
+  static WorkStealingPool& Instance() {
+    static WorkStealingPool pool;
+    return pool;
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      shutdown_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Run init on each of num_threads workers, and then root on the calling
+  // thread, which is worker 0.  Returns when root and all of its tasks are
+  // done.  Calls from inside of a task run root on the current worker.
+  template <typename Init, typename Root>
+  void Run(int num_threads, const Init& init, const Root& root) {
+    if (Worker() >= 0) {
+      root();
+      return;
+    }
+    std::lock_guard<std::mutex> run_guard(run_mutex_);
+    num_threads = std::max(num_threads, 1);
+    Grow(num_threads);
+    next_block_.store(0);
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      init_ = &CallFunc<Init>;
+      init_arg_ = &init;
+      num_active_ = num_threads;
+      num_running_ = num_threads - 1;
+      done_.store(false);
+      ++epoch_;
+    }
+    start_.notify_all();
+
+    Worker() = 0;
+    init();
+    TaskFrame frame;
+    CurrentFrame() = &frame;
+    root();
+    Wait(frame);
+    CurrentFrame() = NULL;
+    Worker() = -1;
+
+    done_.store(true);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      finished_.wait(lock, [this] { return num_running_ == 0; });
+    }
+    // Keep enough blocks for the next run of the same size.
+    while (static_cast<long>(blocks_.size()) < next_block_.load()) {
+      blocks_.emplace_back(new Block);
+    }
+  }
+
+  // Run func as a task of the current worker, or right away if the caller
+  // is not a worker or its deque is full.
+  template <typename Func>
+  void Spawn(Func func) {
+    int worker = Worker();
+    if (worker < 0) {
+      func();
+      return;
+    }
+    TaskFrame *frame = CurrentFrame();
+    frame->pending.fetch_add(1, std::memory_order_relaxed);
+    PoolTask *task = NewTask(frame, func);
+    if (!deques_[worker]->Push(task)) {
+      Execute(task);
+    }
+  }
+
+  // Wait for the tasks spawned by the current task.
+  void WaitForChildren() {
+    if (Worker() >= 0) {
+      Wait(*CurrentFrame());
+    }
+  }
+
+  // Run one task if there is one, and otherwise yield the processor.
+  void Yield() {
+    PoolTask *task = Worker() >= 0 ? FindTask() : NULL;
+    if (task != NULL) {
+      Execute(task);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  // Index of the calling thread in the running pool, or -1.
+  static int& Worker() {
+    static thread_local int worker = -1;
+    return worker;
+  }
+
+private:
+  static const int kSpinsBeforeSleep = 256;
+  static const int kSleepMicroseconds = 50;
+
+  // Size of the blocks that the tasks are built in.  This fits the tasks of
+  // the generated code, which refer to all of the blocks of A, B, and C.
+  // Larger tasks go on the heap.
+  static const int kBlockBytes = 512;
+  struct Block {
+    alignas(std::max_align_t) char bytes[kBlockBytes];
+  };
+
+  WorkStealingPool() : num_active_(0), num_running_(0), epoch_(0), shutdown_(false),
+                       done_(true), init_(NULL), init_arg_(NULL), next_block_(0) {
+    deques_.emplace_back(new TaskDeque);
+  }
+
+  template <typename Func>
+  static void CallFunc(const void *func) {
+    (*static_cast<const Func *>(func))();
+  }
+
+  // A task in the next free block, or on the heap if there is none left in
+  // this run.
+  template <typename Func>
+  PoolTask *NewTask(TaskFrame *frame, const Func& func) {
+    long index = next_block_.fetch_add(1, std::memory_order_relaxed);
+    if (sizeof(FuncTask<Func>) <= sizeof(Block) &&
+        index < static_cast<long>(blocks_.size())) {
+      PoolTask *task = new (blocks_[index]->bytes) FuncTask<Func>(frame, func);
+      task->set_pooled();
+      return task;
+    }
+    return new FuncTask<Func>(frame, func);
+  }
+
+  static void DeleteTask(PoolTask *task) {
+    if (task->pooled()) {
+      task->~PoolTask();
+    } else {
+      delete task;
+    }
+  }
+
+  static TaskFrame *& CurrentFrame() {
+    static thread_local TaskFrame *frame = NULL;
+    return frame;
+  }
+
+  // Make sure that there are num_threads - 1 helper threads.
+  void Grow(int num_threads) {
+    while (static_cast<int>(deques_.size()) < num_threads) {
+      deques_.emplace_back(new TaskDeque);
+    }
+    while (static_cast<int>(threads_.size()) < num_threads - 1) {
+      int worker = threads_.size() + 1;
+      long epoch;
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        epoch = epoch_;
+      }
+      threads_.emplace_back([this, worker, epoch] { WorkerLoop(worker, epoch); });
+    }
+  }
+
+  void WorkerLoop(int worker, long seen_epoch) {
+    while (true) {
+      void (*init)(const void *);
+      const void *init_arg;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [&] { return shutdown_ || epoch_ != seen_epoch; });
+        if (shutdown_) {
+          return;
+        }
+        seen_epoch = epoch_;
+        if (worker >= num_active_) {
+          continue;
+        }
+        init = init_;
+        init_arg = init_arg_;
+      }
+      Worker() = worker;
+      init(init_arg);
+      // Back off while there is nothing to steal (e.g., in DFS steps), so that
+      // the idle workers leave the cores to the threads of the additions and
+      // BLAS.
+      int num_misses = 0;
+      while (!done_.load()) {
+        PoolTask *task = FindTask();
+        if (task != NULL) {
+          Execute(task);
+          num_misses = 0;
+        } else if (++num_misses < kSpinsBeforeSleep) {
+          std::this_thread::yield();
+        } else {
+          std::this_thread::sleep_for(std::chrono::microseconds(kSleepMicroseconds));
+        }
+      }
+      Worker() = -1;
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        --num_running_;
+      }
+      finished_.notify_all();
+    }
+  }
+
+  // Own deque first, then the others in turn, starting after this one.
+  PoolTask *FindTask() {
+    int worker = Worker();
+    PoolTask *task = deques_[worker]->Pop();
+    for (int i = 1; i < num_active_ && task == NULL; ++i) {
+      task = deques_[(worker + i) % num_active_]->Steal();
+    }
+    return task;
+  }
+
+  // Run the task and its children, and then tell its parent.
+  void Execute(PoolTask *task) {
+    TaskFrame *saved = CurrentFrame();
+    TaskFrame frame;
+    CurrentFrame() = &frame;
+    task->Run();
+    Wait(frame);
+    CurrentFrame() = saved;
+    task->parent()->pending.fetch_sub(1, std::memory_order_release);
+    DeleteTask(task);
+  }
+
+  void Wait(TaskFrame& frame) {
+    while (frame.pending.load(std::memory_order_acquire) > 0) {
+      PoolTask *task = FindTask();
+      if (task != NULL) {
+        Execute(task);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<TaskDeque> > deques_;
+  std::vector<std::thread> threads_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable finished_;
+  int num_active_;
+  int num_running_;
+  long epoch_;
+  bool shutdown_;
+  std::atomic<bool> done_;
+  // The init function of the current run, called with init_arg_.
+  void (*init_)(const void *);
+  const void *init_arg_;
+  // The blocks for tasks, and the number taken in the current run.
+  std::vector<std::unique_ptr<Block> > blocks_;
+  std::atomic<long> next_block_;
+};
+
+
+// Run init on each of num_threads threads, and then root on one of them, as
+// the root of a task recursion.
+template <typename Init, typename Root>
+void RunTaskParallel(int num_threads, const Init& init, const Root& root) {
+#if defined(_WORK_STEALING_POOL_)
+  WorkStealingPool::Instance().Run(num_threads, init, root);
+#elif defined(_PARALLEL_)
+# pragma omp parallel num_threads(num_threads)
+  {
+    init();
+# pragma omp single
+    root();
+  }
+#else
+  init();
+  root();
+#endif
+}
+
+
+// Run func as a task if in_task is true, and otherwise right away.  The task
+// may run until the next TaskWait of the caller, so func must only refer to
+// things that live until then.
+template <typename Func>
+void SpawnTask(bool in_task, Func func) {
+#if defined(_WORK_STEALING_POOL_)
+  if (in_task) {
+    WorkStealingPool::Instance().Spawn(func);
+  } else {
+    func();
+  }
+#elif defined(_PARALLEL_)
+# pragma omp task if(in_task) default(shared) firstprivate(func) untied
+  func();
+#else
+  func();
+#endif
+}
+
+
+inline void TaskWait() {
+#if defined(_WORK_STEALING_POOL_)
+  WorkStealingPool::Instance().WaitForChildren();
+#elif defined(_PARALLEL_)
+# pragma omp taskwait
+#endif
+}
+
+
+inline void TaskYield() {
+#if defined(_WORK_STEALING_POOL_)
+  WorkStealingPool::Instance().Yield();
+#elif defined(_PARALLEL_)
+# pragma omp taskyield
+#endif
+}
+
+
+// The counters of a TaskLoop.  users is the number of the caller and the
+// spawned tasks that may still read them; the slot is free once it is 0.
+struct alignas(64) TaskLoopCounters {
+  TaskLoopCounters() : next(0), done(0), users(0) {}
+  std::atomic<int> next;
+  std::atomic<int> done;
+  std::atomic<int> users;
+};
+
+const int kTaskLoopSlots = 16;
+
+// A free slot of the calling thread for the counters of a TaskLoop, or NULL
+// if the spawned tasks of earlier loops may still read all of them.  The
+// slots live as long as the thread, and the tasks of a parallel region
+// finish before its threads do.
+inline TaskLoopCounters *FreeTaskLoopCounters() {
+  static thread_local TaskLoopCounters slots[kTaskLoopSlots];
+  for (TaskLoopCounters& slot : slots) {
+    if (slot.users.load(std::memory_order_acquire) == 0) {
+      return &slot;
+    }
+  }
+  return NULL;
+}
+
+
+// Run body(begin, end) on consecutive ranges of at most grain iterations that
+// cover [first, last), like an OpenMP taskloop.  The caller spawns a task per
+// extra range, and the caller and these tasks all take the next range from a
+// shared counter, so idle threads help with the loop and the caller runs
+// whatever is left.  The caller then waits only for ranges that are running
+// on other threads.  It does not run other tasks in the meantime, so it cannot
+// get stuck under a task that waits for this one (e.g., at the HYBRID switch
+// to DFS).  The tasks that find no range left return right away; they only
+// touch the counters, which come from FreeTaskLoopCounters rather than the
+// heap.  Without a free slot, the caller runs the whole loop.
+template <typename Body>
+void TaskLoop(int first, int last, int grain, Body body) {
+  int num_ranges = grain > 0 ? (last - first + grain - 1) / grain : 1;
+  TaskLoopCounters *counters = num_ranges > 1 ? FreeTaskLoopCounters() : NULL;
+  if (counters == NULL) {
+    body(first, last);
+    return;
+  }
+  counters->next.store(0, std::memory_order_relaxed);
+  counters->done.store(0, std::memory_order_relaxed);
+  counters->users.store(num_ranges, std::memory_order_relaxed);
+  auto run_ranges = [counters, first, last, grain, num_ranges, body] {
+    for (int r = counters->next.fetch_add(1); r < num_ranges;
+         r = counters->next.fetch_add(1)) {
+      int begin = first + r * grain;
+      body(begin, std::min(last, begin + grain));
+      counters->done.fetch_add(1, std::memory_order_release);
+    }
+  };
+  for (int i = 1; i < num_ranges; ++i) {
+    SpawnTask(true, [counters, run_ranges] {
+        run_ranges();
+        counters->users.fetch_sub(1, std::memory_order_release);
+      });
+  }
+  run_ranges();
+  while (counters->done.load(std::memory_order_acquire) < num_ranges) {
+    std::this_thread::yield();
+  }
+  // Only now, since an untied task may have moved to another thread, whose
+  // next loop could otherwise take this slot while the caller still reads it.
+  counters->users.fetch_sub(1, std::memory_order_release);
+}
+
+#endif  // _TASK_POOL_HPP_